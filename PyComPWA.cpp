@@ -2,6 +2,7 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <pybind11/complex.h>
 #include <pybind11/iostream.h>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
@@ -34,6 +35,28 @@
 #include "Tools/Plotting/RootPlotData.hpp"
 #include "Tools/UpdatePTreeParameter.hpp"
 
+#include "PyComPWA/ExpertSystem/ClebschGordan.hpp"
+#include "PyComPWA/ExpertSystem/ConservationRules.hpp"
+#include "PyComPWA/ExpertSystem/GraphFingerprint.hpp"
+#include "PyComPWA/ExpertSystem/QuantumNumberProblem.hpp"
+#include "PyComPWA/ExpertSystem/TopologyGenerator.hpp"
+#include "PyComPWA/Tools/AdaptiveBinning.hpp"
+#include "PyComPWA/Tools/AngularMoments.hpp"
+#include "PyComPWA/Tools/BarrierFactors.hpp"
+#include "PyComPWA/Tools/BinaryModel.hpp"
+#include "PyComPWA/Tools/BinnedIntegration.hpp"
+#include "PyComPWA/Tools/BlockNormalization.hpp"
+#include "PyComPWA/Tools/FitCampaign.hpp"
+#include "PyComPWA/Tools/GoodnessOfFit.hpp"
+#include "PyComPWA/Tools/IntensityCache.hpp"
+#include "PyComPWA/Tools/KMatrix.hpp"
+#include "PyComPWA/Tools/KernelDensityEstimation.hpp"
+#include "PyComPWA/Tools/NumpyPlotData.hpp"
+#include "PyComPWA/Tools/ParticleDatabase.hpp"
+#include "PyComPWA/Tools/Plugins.hpp"
+#include "PyComPWA/Tools/TabulatedFunction.hpp"
+#include "PyComPWA/Tools/VectorizedIntensity.hpp"
+
 namespace py = pybind11;
 
 PYBIND11_MAKE_OPAQUE(ComPWA::ParticleList);
@@ -42,6 +65,271 @@ PYBIND11_MAKE_OPAQUE(std::vector<ComPWA::Event>);
 PYBIND11_MAKE_OPAQUE(std::vector<ComPWA::DataPoint>);
 PYBIND11_DECLARE_HOLDER_TYPE(T, std::shared_ptr<T>);
 
+namespace {
+
+using DoubleArray =
+    py::array_t<double, py::array::c_style | py::array::forcecast>;
+using ComplexArray = py::array_t<std::complex<double>,
+                                 py::array::c_style | py::array::forcecast>;
+
+/// View of a numpy array for the native tools. The array has to outlive the
+/// view.
+PyComPWA::Tools::ColumnView asColumnView(const DoubleArray &Array) {
+  return PyComPWA::Tools::ColumnView{Array.data(),
+                                     static_cast<std::size_t>(Array.size())};
+}
+
+std::vector<PyComPWA::Tools::ColumnView>
+asColumnViews(const std::vector<DoubleArray> &Arrays) {
+  std::vector<PyComPWA::Tools::ColumnView> Views;
+  for (auto const &x : Arrays)
+    Views.push_back(asColumnView(x));
+  return Views;
+}
+
+/// The (L, M) indices, the moments and their covariance matrices as numpy
+/// arrays.
+py::tuple asTuple(const PyComPWA::Tools::AngularMoments &Moments) {
+  std::size_t NumberOfBins = Moments.Values.size();
+  std::size_t NumberOfMoments = Moments.Indices.size();
+  py::array_t<double> Values({NumberOfBins, NumberOfMoments});
+  py::array_t<double> Covariances(
+      {NumberOfBins, NumberOfMoments, NumberOfMoments});
+  for (std::size_t Bin = 0; Bin < NumberOfBins; ++Bin) {
+    std::copy(Moments.Values[Bin].begin(), Moments.Values[Bin].end(),
+              Values.mutable_data(Bin, 0));
+    std::copy(Moments.Covariances[Bin].begin(), Moments.Covariances[Bin].end(),
+              Covariances.mutable_data(Bin, 0, 0));
+  }
+  return py::make_tuple(Moments.Indices, Values, Covariances);
+}
+
+/// Quantum number value as (defined, value, projection, real), see
+/// PyComPWA::ExpertSystem::QuantumNumberValue.
+using EncodedQuantumNumber = std::tuple<bool, int, int, double>;
+
+/// Fixed values and variable indices of the quantum numbers of an edge or
+/// node, both as lists of (quantum number name, value) pairs.
+using EncodedConstraintState =
+    std::pair<std::vector<std::pair<std::string, EncodedQuantumNumber>>,
+              std::vector<std::pair<std::string, std::size_t>>>;
+
+PyComPWA::ExpertSystem::QuantumNumberValue
+asQuantumNumberValue(const EncodedQuantumNumber &Encoded) {
+  PyComPWA::ExpertSystem::QuantumNumberValue Value;
+  Value.Present = true;
+  std::tie(Value.Defined, Value.Value, Value.Projection, Value.Real) = Encoded;
+  return Value;
+}
+
+PyComPWA::ExpertSystem::ConstraintState
+asConstraintState(const EncodedConstraintState &Encoded) {
+  PyComPWA::ExpertSystem::ConstraintState State;
+  for (auto const &x : Encoded.first)
+    State.FixedValues.emplace_back(
+        PyComPWA::ExpertSystem::quantumNumberName(x.first),
+        asQuantumNumberValue(x.second));
+  for (auto const &x : Encoded.second)
+    State.Variables.emplace_back(
+        PyComPWA::ExpertSystem::quantumNumberName(x.first), x.second);
+  return State;
+}
+
+std::vector<PyComPWA::ExpertSystem::ConstraintState>
+asConstraintStates(const std::vector<EncodedConstraintState> &Encoded) {
+  std::vector<PyComPWA::ExpertSystem::ConstraintState> States;
+  for (auto const &x : Encoded)
+    States.push_back(asConstraintState(x));
+  return States;
+}
+
+/// Twice a spin given in python, which has to be a multiple of 1/2.
+int twiceSpin(double Spin) {
+  double Twice = std::round(2.0 * Spin);
+  if (std::abs(Twice - 2.0 * Spin) > 1e-6)
+    throw ComPWA::BadParameter("pycompwa: spin " + std::to_string(Spin) +
+                               " is not a multiple of 1/2!");
+  return static_cast<int>(Twice);
+}
+
+/// Properties of a graph node or edge as (id, quantum numbers, other
+/// properties). Each quantum number is given as its type and a list of its
+/// other attributes.
+using EncodedGraphElementProperties = std::tuple<
+    int,
+    std::vector<std::pair<std::string,
+                          std::vector<std::pair<std::string, std::string>>>>,
+    std::vector<std::pair<std::string, std::string>>>;
+
+std::vector<PyComPWA::ExpertSystem::GraphElementProperties>
+asGraphElementProperties(
+    const std::vector<EncodedGraphElementProperties> &Encoded) {
+  std::vector<PyComPWA::ExpertSystem::GraphElementProperties> Properties;
+  for (auto const &x : Encoded) {
+    PyComPWA::ExpertSystem::GraphElementProperties Element;
+    std::tie(Element.Id, Element.QuantumNumbers, Element.Properties) = x;
+    Properties.push_back(Element);
+  }
+  return Properties;
+}
+
+/// Converts an xml element of the particle database into the same python
+/// object as xmltodict.parse(): elements without attributes and children are
+/// their text or None, others are dicts with the attributes prefixed by @,
+/// the children and the text as #text. Repeated children become lists.
+py::object asXmlDict(const PyComPWA::Tools::ParticleDatabase &Database,
+                     std::uint32_t Index) {
+  using PyComPWA::Tools::ParticleDatabase;
+  auto const &Element = Database.elementAt(Index);
+  if (Element.FirstChild == ParticleDatabase::None) {
+    if (Element.Text == ParticleDatabase::None)
+      return py::none();
+    return py::str(Database.string(Element.Text));
+  }
+  py::dict Dict;
+  std::set<std::string> RepeatedTags;
+  for (auto Child = Element.FirstChild; Child != ParticleDatabase::None;
+       Child = Database.elementAt(Child).NextSibling) {
+    auto const &x = Database.elementAt(Child);
+    std::string Key(Database.string(x.Tag));
+    py::object Value;
+    if (x.IsAttribute) {
+      Key = "@" + Key;
+      Value = py::str(Database.string(x.Text));
+    } else {
+      Value = asXmlDict(Database, Child);
+    }
+    if (!Dict.contains(Key)) {
+      Dict[Key.c_str()] = Value;
+    } else if (RepeatedTags.insert(Key).second) {
+      py::list Values;
+      Values.append(Dict[Key.c_str()]);
+      Values.append(Value);
+      Dict[Key.c_str()] = Values;
+    } else {
+      Dict[Key.c_str()].cast<py::list>().append(Value);
+    }
+  }
+  if (Element.Text != ParticleDatabase::None)
+    Dict["#text"] = py::str(Database.string(Element.Text));
+  return Dict;
+}
+
+py::object findParticle(const PyComPWA::Tools::ParticleDatabase &Database,
+                        std::uint32_t Particle) {
+  if (Particle == PyComPWA::Tools::ParticleDatabase::None)
+    return py::none();
+  return asXmlDict(Database, Database.element(Particle));
+}
+
+/// Text of an element or attribute, as written by xmltodict.unparse().
+std::string asXmlText(py::handle Value) {
+  if (py::isinstance<py::bool_>(Value))
+    return Value.cast<bool>() ? "true" : "false";
+  return py::str(Value);
+}
+
+/// Converts a python object in the format of xmltodict into the property tree
+/// which read_xml() creates from the xml file written by xmltodict.unparse().
+/// Lists are repeated elements and None is an empty element.
+boost::property_tree::ptree asPropertyTree(py::handle Object) {
+  boost::property_tree::ptree Tree;
+  if (Object.is_none())
+    return Tree;
+  if (!py::isinstance<py::dict>(Object)) {
+    Tree.data() = asXmlText(Object);
+    return Tree;
+  }
+  boost::property_tree::ptree Attributes;
+  for (auto const &Item : Object.cast<py::dict>()) {
+    std::string Key = py::str(Item.first);
+    if (Key == "#text") {
+      Tree.data() = asXmlText(Item.second);
+    } else if (!Key.empty() && Key[0] == '@') {
+      Attributes.push_back(std::make_pair(
+          Key.substr(1), boost::property_tree::ptree(asXmlText(Item.second))));
+    } else if (py::isinstance<py::list>(Item.second) ||
+               py::isinstance<py::tuple>(Item.second)) {
+      for (auto const &x : Item.second)
+        Tree.push_back(std::make_pair(Key, asPropertyTree(x)));
+    } else {
+      Tree.push_back(std::make_pair(Key, asPropertyTree(Item.second)));
+    }
+  }
+  if (!Attributes.empty())
+    Tree.push_front(std::make_pair("<xmlattr>", Attributes));
+  return Tree;
+}
+
+auto createHelicityKinematics(const boost::property_tree::ptree &pt,
+                              ComPWA::ParticleList partL) {
+  auto it = pt.find("HelicityKinematics");
+  if (it == pt.not_found())
+    throw ComPWA::BadConfig("pycompwa::create_helicity_kinematics(): "
+                            "HelicityKinematics tag not found!");
+  return ComPWA::Physics::createHelicityKinematics(partL, it->second);
+}
+
+auto createIntensity(const boost::property_tree::ptree &pt,
+                     ComPWA::ParticleList partL, ComPWA::Kinematics &kin,
+                     const std::vector<ComPWA::Event> &PhspSample) {
+  auto it = pt.find("Intensity");
+  if (it == pt.not_found())
+    throw ComPWA::BadConfig("pycompwa::create_intensity(): "
+                            "Intensity tag not found!");
+  ComPWA::Physics::IntensityBuilderXML Builder(partL, kin, it->second,
+                                               PhspSample);
+  return Builder.createIntensity();
+}
+
+/// Python function which can be shared by native functions. The last owner
+/// may release it in a thread without the GIL, so the GIL is acquired for
+/// that.
+std::shared_ptr<py::function> sharePythonFunction(py::function Function) {
+  return std::shared_ptr<py::function>(new py::function(std::move(Function)),
+                                       [](py::function *x) {
+                                         py::gil_scoped_acquire Acquire;
+                                         delete x;
+                                       });
+}
+
+/// Calls \p Function with read only numpy views of the data columns of each
+/// block and a dict of the parameter values. The GIL is only held during the
+/// call.
+PyComPWA::Tools::VectorizedIntensity::BlockFunction
+asBlockFunction(py::function Function,
+                std::vector<std::string> ParameterNames) {
+  auto SharedFunction = sharePythonFunction(std::move(Function));
+  return [SharedFunction, ParameterNames](
+             const std::vector<const double *> &Columns,
+             std::size_t NumberOfEvents, const std::vector<double> &Parameters,
+             double *Results) {
+    py::gil_scoped_acquire Acquire;
+    // the capsule keeps numpy from copying the data, which is owned by the
+    // caller of VectorizedIntensity::evaluate()
+    py::capsule NoOwner(Columns.data(), [](void *) {});
+    py::list ColumnViews;
+    for (auto Column : Columns) {
+      py::array_t<double> View(NumberOfEvents, Column, NoOwner);
+      py::detail::array_proxy(View.ptr())->flags &=
+          ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+      ColumnViews.append(View);
+    }
+    py::dict ParameterValues;
+    for (std::size_t i = 0; i < Parameters.size(); ++i)
+      ParameterValues[py::str(ParameterNames[i])] = Parameters[i];
+    auto Values = DoubleArray((*SharedFunction)(ColumnViews, ParameterValues));
+    if (static_cast<std::size_t>(Values.size()) != NumberOfEvents)
+      throw ComPWA::BadParameter(
+          "pycompwa::VectorizedIntensity: the function returned " +
+          std::to_string(Values.size()) + " values for " +
+          std::to_string(NumberOfEvents) + " events!");
+    std::copy(Values.data(), Values.data() + Values.size(), Results);
+  };
+}
+
+} // namespace
+
 PYBIND11_MODULE(ui, m) {
   m.doc() = "pycompwa module\n"
             "---------------\n";
@@ -202,15 +490,82 @@ PYBIND11_MODULE(ui, m) {
       });
 
   m.def("read_particles",
-        [](std::string filename) { return ComPWA::readParticles(filename); },
-        "Read particles from a xml file.", py::arg("xml_filename"));
+        [](std::string filename) {
+          ComPWA::ParticleList partlist;
+          if (PyComPWA::Tools::isBinaryModel(filename)) {
+            ComPWA::insertParticles(
+                partlist, PyComPWA::Tools::readBinaryModel(filename));
+            return partlist;
+          }
+          auto Database = PyComPWA::Tools::ParticleDatabase::open(filename);
+          ComPWA::insertParticles(partlist, Database->particleList());
+          return partlist;
+        },
+        "Read particles from a xml file or a binary model file.",
+        py::arg("xml_filename"));
+
+  m.def("read_particles",
+        [](const py::dict &model) {
+          ComPWA::ParticleList partlist;
+          ComPWA::insertParticles(partlist, asPropertyTree(model));
+          return partlist;
+        },
+        "Read particles from a model dict in the format of xmltodict.",
+        py::arg("model"));
 
   m.def("insert_particles",
         [](ComPWA::ParticleList &partlist, std::string filename) {
-          ComPWA::insertParticles(partlist, filename);
+          if (PyComPWA::Tools::isBinaryModel(filename)) {
+            ComPWA::insertParticles(
+                partlist, PyComPWA::Tools::readBinaryModel(filename));
+            return;
+          }
+          auto Database = PyComPWA::Tools::ParticleDatabase::open(filename);
+          ComPWA::insertParticles(partlist, Database->particleList());
         },
-        "Insert particles to a list from a xml file. Already defined particles "
-        "will be overwritten!");
+        "Insert particles to a list from a xml file or a binary model file. "
+        "Already defined particles will be overwritten!");
+
+  py::class_<PyComPWA::Tools::ParticleDatabase,
+             std::shared_ptr<PyComPWA::Tools::ParticleDatabase>>(
+      m, "ParticleDatabase",
+      "Compiled particle list of a xml file, which is shared by all users of "
+      "the file in the process. The xml file is only parsed again if it "
+      "changes.")
+      .def_static("open", &PyComPWA::Tools::ParticleDatabase::open,
+                  "Open the database of a xml particle list. With "
+                  "use_cache_file, the database is written to the cache "
+                  "directory and shared with other processes.",
+                  py::arg("xml_filename"), py::arg("use_cache_file") = false)
+      .def("__len__", &PyComPWA::Tools::ParticleDatabase::size)
+      .def_property_readonly("file_name",
+                             &PyComPWA::Tools::ParticleDatabase::fileName)
+      .def("particles",
+           [](const PyComPWA::Tools::ParticleDatabase &Database) {
+             py::list Particles;
+             for (std::size_t i = 0; i < Database.size(); ++i)
+               Particles.append(findParticle(Database, i));
+             return Particles;
+           },
+           "All particles as dicts, in the format of xmltodict.")
+      .def("find_by_name",
+           [](const PyComPWA::Tools::ParticleDatabase &Database,
+              const std::string &Name) {
+             return findParticle(Database, Database.findByName(Name));
+           },
+           "Particle dict with this name or None.", py::arg("name"))
+      .def("find_by_pid",
+           [](const PyComPWA::Tools::ParticleDatabase &Database, int Pid) {
+             return findParticle(Database, Database.findByPid(Pid));
+           },
+           "Particle dict with this pid or None.", py::arg("pid"))
+      .def("particle_list",
+           [](const PyComPWA::Tools::ParticleDatabase &Database) {
+             ComPWA::ParticleList partlist;
+             ComPWA::insertParticles(partlist, Database.particleList());
+             return partlist;
+           },
+           "The particles as ComPWA particle list.");
 
   // ------- Kinematics
 
@@ -257,21 +612,22 @@ PYBIND11_MODULE(ui, m) {
 
   m.def("create_helicity_kinematics",
         [&](const std::string &filename, ComPWA::ParticleList partL) {
-          boost::property_tree::ptree pt;
-          boost::property_tree::xml_parser::read_xml(filename, pt);
-          auto it = pt.find("HelicityKinematics");
-          if (it != pt.not_found()) {
-            return ComPWA::Physics::createHelicityKinematics(partL, it->second);
-          } else {
-            throw ComPWA::BadConfig(
-                "pycompwa::create_helicity_kinematics(): "
-                "HelicityKinematics tag not found in xml file!");
-          }
+          return createHelicityKinematics(
+              PyComPWA::Tools::readModel(filename), partL);
         },
-        "Create a helicity kinematics from a xml file. The file "
-        "should contain a kinematics section.",
+        "Create a helicity kinematics from a xml file or a binary model file. "
+        "The file should contain a kinematics section.",
         py::arg("xml_filename"), py::arg("particle_list"));
 
+  m.def("create_helicity_kinematics",
+        [&](const py::dict &model, ComPWA::ParticleList partL) {
+          return createHelicityKinematics(asPropertyTree(model), partL);
+        },
+        "Create a helicity kinematics from a model dict in the format of "
+        "xmltodict, e.g. HelicityAmplitudeGeneratorXML.get_model_dict(), "
+        "without writing it to a file.",
+        py::arg("model"), py::arg("particle_list"));
+
   // ------- Intensity
 
   py::class_<ComPWA::Intensity, std::shared_ptr<ComPWA::Intensity>>(
@@ -292,29 +648,395 @@ PYBIND11_MODULE(ui, m) {
       .def("print", &ComPWA::FunctionTree::FunctionTreeIntensity::print,
            "print function tree");
 
+  py::class_<PyComPWA::Tools::VectorizedIntensity, ComPWA::Intensity,
+             std::shared_ptr<PyComPWA::Tools::VectorizedIntensity>>(
+      m, "VectorizedIntensity",
+      "Intensity defined by a python function, which is called once per "
+      "block of events as function(columns, parameters). The columns are a "
+      "list of read only numpy arrays of the kinematic variables of the "
+      "block, the parameters a dict of their current values. It returns the "
+      "intensities of the block as array.")
+      .def(py::init([](py::function function, const py::dict &parameters,
+                       std::size_t block_size) {
+             std::vector<ComPWA::Parameter> Parameters;
+             std::vector<std::string> ParameterNames;
+             for (auto Item : parameters) {
+               ParameterNames.push_back(py::str(Item.first));
+               Parameters.push_back(
+                   {ParameterNames.back(), Item.second.cast<double>()});
+             }
+             return std::make_shared<PyComPWA::Tools::VectorizedIntensity>(
+                 asBlockFunction(function, ParameterNames), Parameters,
+                 block_size);
+           }),
+           py::arg("function"), py::arg("parameters") = py::dict(),
+           py::arg("block_size") = 65536)
+      .def("evaluate", &PyComPWA::Tools::VectorizedIntensity::evaluate,
+           py::call_guard<py::gil_scoped_release>())
+      .def("updateParametersFrom",
+           [](PyComPWA::Tools::VectorizedIntensity &x,
+              ComPWA::FitParameterList pars) {
+             std::vector<double> params;
+             for (auto x : pars)
+               params.push_back(x.Value);
+             x.updateParametersFrom(params);
+           })
+      .def_property_readonly(
+          "parameters", [](const PyComPWA::Tools::VectorizedIntensity &x) {
+            py::dict Parameters;
+            for (auto const &Parameter : x.getParameters())
+              Parameters[py::str(Parameter.Name)] = Parameter.Value;
+            return Parameters;
+          });
+
+  m.def("load_plugin", &PyComPWA::Tools::loadPlugin,
+        "Load a shared library with compiled intensity functions, see "
+        "PyComPWA/Tools/PluginInterface.h. Returns the names of the "
+        "functions. Nothing is registered if the library is invalid.",
+        py::arg("filename"));
+
+  m.def("plugin_intensity_functions",
+        &PyComPWA::Tools::pluginIntensityFunctions,
+        "Names of the intensity functions of all loaded plugins.");
+
+  m.def("create_plugin_intensity", &PyComPWA::Tools::createPluginIntensity,
+        "Create an intensity evaluated by a plugin function. Parameters "
+        "which are not given have their default values.",
+        py::arg("name"),
+        py::arg("parameters") = std::map<std::string, double>(),
+        py::arg("block_size") = 65536);
+
+  py::class_<PyComPWA::Tools::TabulatedFunction,
+             std::shared_ptr<PyComPWA::Tools::TabulatedFunction>>(
+      m, "TabulatedFunction",
+      "Function of one variable, e.g. a lineshape with fixed parameters, "
+      "which is sampled once on an equidistant grid and evaluated by cubic "
+      "spline interpolation. Points outside of the grid are evaluated "
+      "directly.")
+      .def(py::init([](py::function function, double minimum, double maximum,
+                       std::size_t number_of_points) {
+             auto SharedFunction = sharePythonFunction(std::move(function));
+             return std::make_shared<PyComPWA::Tools::TabulatedFunction>(
+                 [SharedFunction](const std::vector<double> &Points) {
+                   py::gil_scoped_acquire Acquire;
+                   auto Values = DoubleArray((*SharedFunction)(
+                       py::array_t<double>(Points.size(), Points.data())));
+                   return std::vector<double>(Values.data(),
+                                              Values.data() + Values.size());
+                 },
+                 minimum, maximum, number_of_points);
+           }),
+           "Tabulate a python function, which is called with a numpy array "
+           "of points.",
+           py::arg("function"), py::arg("minimum"), py::arg("maximum"),
+           py::arg("number_of_points") = 1000)
+      .def_static(
+          "from_intensity",
+          [](std::shared_ptr<ComPWA::Intensity> intensity,
+             std::size_t variable_index,
+             const std::vector<double> &reference_values, double minimum,
+             double maximum, std::size_t number_of_points) {
+            return std::make_shared<PyComPWA::Tools::TabulatedFunction>(
+                PyComPWA::Tools::intensitySlice(intensity, variable_index,
+                                                reference_values),
+                minimum, maximum, number_of_points);
+          },
+          "Tabulate an intensity as function of one kinematic variable, with "
+          "all other variables at their reference values.",
+          py::arg("intensity"), py::arg("variable_index"),
+          py::arg("reference_values"), py::arg("minimum"), py::arg("maximum"),
+          py::arg("number_of_points") = 1000)
+      .def("evaluate",
+           [](const PyComPWA::Tools::TabulatedFunction &Table,
+              const DoubleArray &points) {
+             return py::array(
+                 py::cast(Table.evaluate(points.data(), points.size())));
+           },
+           py::arg("points"))
+      .def("estimate_accuracy",
+           [](const PyComPWA::Tools::TabulatedFunction &Table) {
+             auto Accuracy = Table.estimateAccuracy();
+             py::dict Result;
+             Result["maximum_absolute_error"] = Accuracy.MaximumAbsoluteError;
+             Result["maximum_relative_error"] = Accuracy.MaximumRelativeError;
+             Result["worst_point"] = Accuracy.WorstPoint;
+             return Result;
+           },
+           "Compare the interpolation with the direct evaluation at the "
+           "centers of the grid intervals.")
+      .def("intensity",
+           [](std::shared_ptr<PyComPWA::Tools::TabulatedFunction> Table,
+              std::size_t variable_index) {
+             return PyComPWA::Tools::createTabulatedIntensity(Table,
+                                                              variable_index);
+           },
+           "Intensity which interpolates the table at a kinematic variable.",
+           py::arg("variable_index"))
+      .def_property_readonly("minimum",
+                             &PyComPWA::Tools::TabulatedFunction::minimum)
+      .def_property_readonly("maximum",
+                             &PyComPWA::Tools::TabulatedFunction::maximum)
+      .def_property_readonly(
+          "number_of_points",
+          &PyComPWA::Tools::TabulatedFunction::numberOfPoints);
+
+  py::class_<PyComPWA::Tools::ComplexTabulatedFunction,
+             std::shared_ptr<PyComPWA::Tools::ComplexTabulatedFunction>>(
+      m, "ComplexTabulatedFunction",
+      "Complex function of one variable, e.g. a lineshape with fixed "
+      "parameters, which is tabulated like a TabulatedFunction. The real "
+      "and imaginary parts are interpolated by separate splines.")
+      .def(py::init([](py::function function, double minimum, double maximum,
+                       std::size_t number_of_points) {
+             auto SharedFunction = sharePythonFunction(std::move(function));
+             return std::make_shared<
+                 PyComPWA::Tools::ComplexTabulatedFunction>(
+                 [SharedFunction](const std::vector<double> &Points) {
+                   py::gil_scoped_acquire Acquire;
+                   auto Values = ComplexArray((*SharedFunction)(
+                       py::array_t<double>(Points.size(), Points.data())));
+                   return std::vector<std::complex<double>>(
+                       Values.data(), Values.data() + Values.size());
+                 },
+                 minimum, maximum, number_of_points);
+           }),
+           "Tabulate a python function, which is called with a numpy array "
+           "of points and returns complex values.",
+           py::arg("function"), py::arg("minimum"), py::arg("maximum"),
+           py::arg("number_of_points") = 1000)
+      .def("evaluate",
+           [](const PyComPWA::Tools::ComplexTabulatedFunction &Table,
+              const DoubleArray &points) {
+             return py::array(
+                 py::cast(Table.evaluate(points.data(), points.size())));
+           },
+           py::arg("points"))
+      .def("estimate_accuracy",
+           [](const PyComPWA::Tools::ComplexTabulatedFunction &Table) {
+             auto Accuracy = Table.estimateAccuracy();
+             py::dict Result;
+             Result["maximum_absolute_error"] = Accuracy.MaximumAbsoluteError;
+             Result["maximum_relative_error"] = Accuracy.MaximumRelativeError;
+             Result["worst_point"] = Accuracy.WorstPoint;
+             return Result;
+           },
+           "Compare the interpolation with the direct evaluation at the "
+           "centers of the grid intervals.")
+      .def_property_readonly(
+          "minimum", &PyComPWA::Tools::ComplexTabulatedFunction::minimum)
+      .def_property_readonly(
+          "maximum", &PyComPWA::Tools::ComplexTabulatedFunction::maximum)
+      .def_property_readonly(
+          "number_of_points",
+          &PyComPWA::Tools::ComplexTabulatedFunction::numberOfPoints);
+
+  m.def(
+      "solve_complex_linear_systems",
+      [](const ComplexArray &matrices, const ComplexArray &vectors) {
+        if (matrices.ndim() != 3 || vectors.ndim() != 2 ||
+            matrices.shape(1) != matrices.shape(2) ||
+            matrices.shape(0) != vectors.shape(0) ||
+            matrices.shape(1) != vectors.shape(1))
+          throw ComPWA::BadParameter(
+              "pycompwa::solve_complex_linear_systems(): expected matrices of "
+              "shape (events, n, n) and vectors of shape (events, n)!");
+        std::size_t Size = matrices.shape(0);
+        std::size_t n = matrices.shape(1);
+        // numpy arrays are one system after another, the solver works on
+        // structure of arrays
+        std::vector<double> ARe(n * n * Size), AIm(n * n * Size);
+        std::vector<double> BRe(n * Size), BIm(n * Size);
+        std::vector<double> XRe(n * Size), XIm(n * Size);
+        auto A = matrices.data();
+        auto B = vectors.data();
+        for (std::size_t e = 0; e < Size; ++e) {
+          for (std::size_t i = 0; i < n * n; ++i) {
+            ARe[i * Size + e] = A[e * n * n + i].real();
+            AIm[i * Size + e] = A[e * n * n + i].imag();
+          }
+          for (std::size_t i = 0; i < n; ++i) {
+            BRe[i * Size + e] = B[e * n + i].real();
+            BIm[i * Size + e] = B[e * n + i].imag();
+          }
+        }
+        {
+          py::gil_scoped_release Release;
+          PyComPWA::Tools::solveComplexLinearSystems(
+              n, Size, ARe.data(), AIm.data(), BRe.data(), BIm.data(),
+              XRe.data(), XIm.data());
+        }
+        ComplexArray Solutions({Size, n});
+        auto X = Solutions.mutable_data();
+        for (std::size_t e = 0; e < Size; ++e) {
+          for (std::size_t i = 0; i < n; ++i)
+            X[e * n + i] = {XRe[i * Size + e], XIm[i * Size + e]};
+        }
+        return Solutions;
+      },
+      "Solve many complex linear systems of dimension up to 5, e.g. the "
+      "K-matrix equations of all events.",
+      py::arg("matrices"), py::arg("vectors"));
+
+  m.def(
+      "create_kmatrix_intensity",
+      [](const std::string &name,
+         std::vector<std::pair<double, double>> channel_masses,
+         const std::vector<double> &pole_masses,
+         const std::vector<std::vector<double>> &couplings,
+         const std::vector<std::complex<double>> &production_couplings,
+         const std::vector<std::vector<double>> &background,
+         std::size_t channel, std::size_t variable_index,
+         std::size_t block_size) {
+        PyComPWA::Tools::KMatrixParameters Parameters;
+        Parameters.PoleMasses = pole_masses;
+        Parameters.Couplings = couplings;
+        Parameters.Background = background;
+        Parameters.ProductionCouplings = production_couplings;
+        return PyComPWA::Tools::createKMatrixIntensity(
+            name, std::move(channel_masses), Parameters, channel,
+            variable_index, block_size);
+      },
+      "Create the intensity of one channel of a K-matrix with up to 5 two "
+      "body channels in the P-vector approach. The kinematic variable has "
+      "to be the invariant mass squared.",
+      py::arg("name"), py::arg("channel_masses"), py::arg("pole_masses"),
+      py::arg("couplings"), py::arg("production_couplings"),
+      py::arg("background") = std::vector<std::vector<double>>(),
+      py::arg("channel") = 0, py::arg("variable_index") = 0,
+      py::arg("block_size") = 65536);
+
+  py::class_<PyComPWA::Tools::BarrierFactorCache>(
+      m, "BarrierFactorCache",
+      "Break-up momenta and Blatt-Weisskopf barrier factors as extra data "
+      "columns. Identical requests share a column, which is computed once "
+      "per data set. The columns are meant for user defined intensities, "
+      "ComPWA's amplitudes compute their form factors themselves.")
+      .def(py::init<>())
+      .def("request_breakup_momentum",
+           &PyComPWA::Tools::BarrierFactorCache::requestBreakupMomentum,
+           "Returns the name of the column.", py::arg("mass_squared_variable"),
+           py::arg("mass_a"), py::arg("mass_b"))
+      .def("request_barrier_factor",
+           &PyComPWA::Tools::BarrierFactorCache::requestBarrierFactor,
+           "Returns the name of the column.", py::arg("mass_squared_variable"),
+           py::arg("mass_a"), py::arg("mass_b"), py::arg("L"),
+           py::arg("meson_radius") = 1.5)
+      .def_property_readonly(
+          "column_names",
+          &PyComPWA::Tools::BarrierFactorCache::columnNames)
+      .def("compute",
+           [](const PyComPWA::Tools::BarrierFactorCache &Cache,
+              const std::map<std::string, DoubleArray> &variables) {
+             std::vector<std::string> VariableNames;
+             std::vector<PyComPWA::Tools::ColumnView> Columns;
+             for (auto const &x : variables) {
+               VariableNames.push_back(x.first);
+               Columns.push_back(asColumnView(x.second));
+             }
+             auto Values = Cache.computeColumns(VariableNames, Columns);
+             auto Names = Cache.columnNames();
+             py::dict Result;
+             for (std::size_t i = 0; i < Names.size(); ++i)
+               Result[py::str(Names[i])] = py::array(py::cast(Values[i]));
+             return Result;
+           },
+           "Compute all requested columns from a dict of numpy arrays.",
+           py::arg("variables"))
+      .def("add_columns", &PyComPWA::Tools::BarrierFactorCache::addColumns,
+           "Append the requested columns, which are missing, to a data set.",
+           py::arg("data_set"), py::call_guard<py::gil_scoped_release>());
+
   m.def(
       "create_intensity",
       [&](const std::string &filename, ComPWA::ParticleList partL,
           ComPWA::Kinematics &kin,
           const std::vector<ComPWA::Event> &PhspSample) {
-        boost::property_tree::ptree pt;
-        boost::property_tree::xml_parser::read_xml(filename, pt);
-        auto it = pt.find("Intensity");
-        if (it != pt.not_found()) {
-          ComPWA::Physics::IntensityBuilderXML Builder(partL, kin, it->second,
-                                                       PhspSample);
-          return Builder.createIntensity();
-        } else {
-          throw ComPWA::BadConfig(
-              "pycompwa::create_helicity_kinematics(): "
-              "HelicityKinematics tag not found in xml file!");
-        }
+        return createIntensity(PyComPWA::Tools::readModel(filename), partL,
+                               kin, PhspSample);
       },
-      "Create an intensity and a helicity kinematics from a xml file. The file "
-      "should contain a particle list, and a kinematics and intensity section.",
+      "Create an intensity and a helicity kinematics from a xml file or a "
+      "binary model file. The file should contain a particle list, and a "
+      "kinematics and intensity section.",
       py::arg("xml_filename"), py::arg("particle_list"), py::arg("kinematics"),
       py::arg("phsp_sample"));
 
+  m.def(
+      "create_intensity",
+      [&](const py::dict &model, ComPWA::ParticleList partL,
+          ComPWA::Kinematics &kin,
+          const std::vector<ComPWA::Event> &PhspSample) {
+        return createIntensity(asPropertyTree(model), partL, kin, PhspSample);
+      },
+      "Create an intensity from a model dict in the format of xmltodict, "
+      "e.g. HelicityAmplitudeGeneratorXML.get_model_dict(), without writing "
+      "it to a file.",
+      py::arg("model"), py::arg("particle_list"), py::arg("kinematics"),
+      py::arg("phsp_sample"));
+
+  m.def(
+      "write_binary_model",
+      [](const std::string &filename, const std::string &output_filename,
+         const ComPWA::FitParameterList &fit_parameters) {
+        auto pt = PyComPWA::Tools::readModel(filename);
+        ComPWA::Tools::updateParameter(pt, fit_parameters);
+        PyComPWA::Tools::writeBinaryModel(output_filename, pt);
+      },
+      "Write a xml model file to a binary model file, which can be passed to "
+      "read_particles(), create_helicity_kinematics() and create_intensity() "
+      "instead of the xml file. The values of the fit parameters, e.g. the "
+      "final parameters of a fit result, are stored in the model.",
+      py::arg("xml_filename"), py::arg("output_filename"),
+      py::arg("fit_parameters") = ComPWA::FitParameterList());
+
+  m.def(
+      "write_binary_model",
+      [](const py::dict &model, const std::string &output_filename,
+         const ComPWA::FitParameterList &fit_parameters) {
+        auto pt = asPropertyTree(model);
+        ComPWA::Tools::updateParameter(pt, fit_parameters);
+        PyComPWA::Tools::writeBinaryModel(output_filename, pt);
+      },
+      "Write a model dict in the format of xmltodict to a binary model file.",
+      py::arg("model"), py::arg("output_filename"),
+      py::arg("fit_parameters") = ComPWA::FitParameterList());
+
+  py::class_<PyComPWA::Tools::IntensityCache>(
+      m, "IntensityCache",
+      "Cache of intensities for models which are edited between the calls "
+      "of create_intensity(). If only parameter values changed compared to "
+      "one of the cached intensities, and no earlier result still holds it, "
+      "that intensity and its cached amplitude values are reused. Otherwise "
+      "the whole intensity is built again. The phase space sample is "
+      "compared by content.")
+      .def(py::init<std::size_t>(),
+           py::arg("maximum_number_of_intensities") = 4)
+      .def("create_intensity",
+           [](PyComPWA::Tools::IntensityCache &Cache,
+              const std::string &filename, ComPWA::ParticleList partL,
+              ComPWA::Kinematics &kin,
+              const std::vector<ComPWA::Event> &PhspSample) {
+             return Cache.createIntensity(
+                 PyComPWA::Tools::readModel(filename), partL, kin,
+                 PhspSample);
+           },
+           "Create an intensity from a xml file or a binary model file.",
+           py::arg("xml_filename"), py::arg("particle_list"),
+           py::arg("kinematics"), py::arg("phsp_sample"))
+      .def("create_intensity",
+           [](PyComPWA::Tools::IntensityCache &Cache, const py::dict &model,
+              ComPWA::ParticleList partL, ComPWA::Kinematics &kin,
+              const std::vector<ComPWA::Event> &PhspSample) {
+             return Cache.createIntensity(asPropertyTree(model), partL, kin,
+                                          PhspSample);
+           },
+           "Create an intensity from a model dict in the format of xmltodict.",
+           py::arg("model"), py::arg("particle_list"), py::arg("kinematics"),
+           py::arg("phsp_sample"))
+      .def_property_readonly("number_of_builds",
+                             &PyComPWA::Tools::IntensityCache::numberOfBuilds)
+      .def("reset", &PyComPWA::Tools::IntensityCache::reset,
+           "Forget the built intensities.");
+
   //------- Generate
 
   py::class_<ComPWA::UniformRealNumberGenerator>(m,
@@ -392,7 +1114,9 @@ PYBIND11_MODULE(ui, m) {
   py::class_<ComPWA::FunctionTree::FunctionTreeEstimator,
              ComPWA::Estimator::Estimator<double>>(m, "FunctionTreeEstimator")
       .def("print", &ComPWA::FunctionTree::FunctionTreeEstimator::print,
-           "print function tree");
+           "print function tree")
+      .def("evaluate", &ComPWA::FunctionTree::FunctionTreeEstimator::evaluate,
+           py::call_guard<py::gil_scoped_release>());
 
   m.def("create_unbinned_log_likelihood_function_tree_estimator",
         (std::pair<ComPWA::FunctionTree::FunctionTreeEstimator,
@@ -448,6 +1172,141 @@ PYBIND11_MODULE(ui, m) {
         "Initializes an Intensity with the parameters of a FitResult.",
         py::arg("intensity"), py::arg("fit_result"));
 
+  //------- Fit campaign
+
+  py::class_<PyComPWA::Tools::HypothesisFitResult>(m, "HypothesisFitResult")
+      .def_readonly("name", &PyComPWA::Tools::HypothesisFitResult::Name)
+      .def_readonly(
+          "number_of_free_parameters",
+          &PyComPWA::Tools::HypothesisFitResult::NumberOfFreeParameters)
+      .def_readonly(
+          "negative_log_likelihood",
+          &PyComPWA::Tools::HypothesisFitResult::NegativeLogLikelihood)
+      .def_readonly("aic", &PyComPWA::Tools::HypothesisFitResult::AIC)
+      .def_readonly("bic", &PyComPWA::Tools::HypothesisFitResult::BIC)
+      .def_readonly("fit_result",
+                    &PyComPWA::Tools::HypothesisFitResult::Result);
+
+  py::class_<PyComPWA::Tools::FitCampaign>(
+      m, "FitCampaign",
+      "Fits several hypotheses to the same data sample in parallel and "
+      "compares them by their likelihood, AIC and BIC. Each hypothesis uses "
+      "the kinematics of its own model, so the fits share no state.")
+      .def(py::init<ComPWA::ParticleList, std::vector<ComPWA::Event>,
+                    std::vector<ComPWA::Event>>(),
+           py::arg("particle_list"), py::arg("data_sample"),
+           py::arg("phsp_sample"))
+      .def("add_hypothesis",
+           [](PyComPWA::Tools::FitCampaign &Campaign, const std::string &name,
+              const std::string &filename) {
+             Campaign.addHypothesis(name,
+                                    PyComPWA::Tools::readModel(filename));
+           },
+           "Add the kinematics and intensity of a xml file or a binary model "
+           "file.",
+           py::arg("name"), py::arg("xml_filename"))
+      .def("add_hypothesis",
+           [](PyComPWA::Tools::FitCampaign &Campaign, const std::string &name,
+              const py::dict &model) {
+             Campaign.addHypothesis(name, asPropertyTree(model));
+           },
+           "Add the kinematics and intensity of a model dict in the format of "
+           "xmltodict.",
+           py::arg("name"), py::arg("model"))
+      .def("__len__", &PyComPWA::Tools::FitCampaign::numberOfHypotheses)
+      .def("run", &PyComPWA::Tools::FitCampaign::run,
+           "Fit all hypotheses, using all threads by default.",
+           py::arg("number_of_threads") = 0,
+           py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("results",
+                             &PyComPWA::Tools::FitCampaign::results)
+      .def("table", &PyComPWA::Tools::FitCampaign::table,
+           "Results sorted by AIC, with the differences to the best "
+           "hypothesis.");
+
+  m.def(
+      "find_incoherent_blocks",
+      [](const std::string &filename) {
+        std::vector<std::string> Names;
+        auto Model = PyComPWA::Tools::readModel(filename);
+        for (auto const &x : PyComPWA::Tools::findIncoherentBlocks(
+                 Model.get_child("Intensity")))
+          Names.push_back(x.Name);
+        return Names;
+      },
+      "Names of the intensities of a xml file or a binary model file, which "
+      "do not interfere with each other.",
+      py::arg("xml_filename"));
+  m.def(
+      "find_incoherent_blocks",
+      [](const py::dict &model) {
+        std::vector<std::string> Names;
+        auto Model = asPropertyTree(model);
+        for (auto const &x : PyComPWA::Tools::findIncoherentBlocks(
+                 Model.get_child("Intensity")))
+          Names.push_back(x.Name);
+        return Names;
+      },
+      "Names of the intensities of a model dict, which do not interfere with "
+      "each other.",
+      py::arg("model"));
+
+  py::class_<PyComPWA::Tools::BlockNormalization,
+             std::shared_ptr<PyComPWA::Tools::BlockNormalization>>(
+      m, "BlockNormalization",
+      "Normalization integral of an intensity, computed from the integrals "
+      "of its non-interfering blocks, i.e. the terms of its incoherent sums. "
+      "Only blocks with changed parameters are evaluated again.")
+      .def(py::init([](const std::string &filename,
+                       ComPWA::ParticleList partL, ComPWA::Kinematics &kin,
+                       const std::vector<ComPWA::Event> &PhspSample) {
+             return std::make_shared<PyComPWA::Tools::BlockNormalization>(
+                 PyComPWA::Tools::readModel(filename), partL, kin,
+                 PhspSample);
+           }),
+           py::arg("xml_filename"), py::arg("particle_list"),
+           py::arg("kinematics"), py::arg("phsp_sample"))
+      .def(py::init([](const py::dict &model, ComPWA::ParticleList partL,
+                       ComPWA::Kinematics &kin,
+                       const std::vector<ComPWA::Event> &PhspSample) {
+             return std::make_shared<PyComPWA::Tools::BlockNormalization>(
+                 asPropertyTree(model), partL, kin, PhspSample);
+           }),
+           py::arg("model"), py::arg("particle_list"), py::arg("kinematics"),
+           py::arg("phsp_sample"))
+      .def("__len__", &PyComPWA::Tools::BlockNormalization::numberOfBlocks)
+      .def("integral", &PyComPWA::Tools::BlockNormalization::integral,
+           "Integral with the given parameter values, all other parameters "
+           "keep their values.",
+           py::arg("parameters") = std::map<std::string, double>(),
+           py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly(
+          "block_names", &PyComPWA::Tools::BlockNormalization::blockNames)
+      .def_property_readonly(
+          "block_integrals",
+          &PyComPWA::Tools::BlockNormalization::blockIntegrals)
+      .def_property_readonly(
+          "number_of_block_evaluations",
+          &PyComPWA::Tools::BlockNormalization::numberOfBlockEvaluations);
+
+  py::class_<PyComPWA::Tools::BlockNormalizedLogLikelihood,
+             ComPWA::Estimator::Estimator<double>>(
+      m, "BlockNormalizedLogLikelihood",
+      "Unbinned negative log likelihood of a data sample, normalized with a "
+      "BlockNormalization. It takes the parameters in the order of "
+      "fit_parameters, e.g. the FitParameterList of the function tree "
+      "estimator of the same model, and can be minimized with MinuitIF. It "
+      "is opt-in, the standard fits use the function tree estimator. The "
+      "data set has to be converted with the kinematics of the "
+      "normalization after the normalization was created.")
+      .def(py::init<std::shared_ptr<PyComPWA::Tools::BlockNormalization>,
+                    ComPWA::Data::DataSet, const ComPWA::FitParameterList &>(),
+           py::arg("normalization"), py::arg("data_set"),
+           py::arg("fit_parameters"))
+      .def("evaluate",
+           &PyComPWA::Tools::BlockNormalizedLogLikelihood::evaluate,
+           py::call_guard<py::gil_scoped_release>());
+
   /*m.def("fit_fractions", &ComPWA::Tools::calculateFitFractions,
         "Calculates the fit fractions for all components of a given coherent "
         "intensity.",
@@ -531,4 +1390,530 @@ PYBIND11_MODULE(ui, m) {
           std::map<std::string, std::shared_ptr<ComPWA::Intensity>>(),
       py::arg("hit_and_miss_sample") = ComPWA::Data::DataSet(),
       py::arg("tfile_option") = "RECREATE");
+
+  m.def(
+      "create_numpyplotdata",
+      [](const std::string &directory, std::shared_ptr<ComPWA::Kinematics> kin,
+         const ComPWA::Data::DataSet &DataSample,
+         const ComPWA::Data::DataSet &PhspSample,
+         std::shared_ptr<ComPWA::Intensity> Intensity,
+         std::map<std::string, std::shared_ptr<ComPWA::Intensity>>
+             IntensityComponents,
+         const ComPWA::Data::DataSet &HitAndMissSample) {
+        try {
+          auto KinematicsInfo =
+              (std::dynamic_pointer_cast<
+                   ComPWA::Physics::HelicityFormalism::HelicityKinematics>(kin)
+                   ->getParticleStateTransitionKinematicsInfo());
+          PyComPWA::Tools::NumpyPlotData plotdata(KinematicsInfo, directory);
+          plotdata.writeData(DataSample);
+          if (Intensity) {
+            plotdata.writeIntensityWeightedPhspSample(
+                PhspSample, *Intensity,
+                std::string("intensity_weighted_phspdata"),
+                IntensityComponents);
+          }
+          plotdata.writeHitMissSample(HitAndMissSample);
+        } catch (const std::exception &e) {
+          LOG(ERROR) << e.what();
+        }
+      },
+      "Write plot data as memory mappable numpy files into a directory. "
+      "Use pycompwa.plotting.numpyplotdatareader to read them.",
+      py::arg("directory"), py::arg("kinematics"), py::arg("data_sample"),
+      py::arg("phsp_sample") = ComPWA::Data::DataSet(),
+      py::arg("intensity") = std::shared_ptr<ComPWA::Intensity>(nullptr),
+      py::arg("intensity_components") =
+          std::map<std::string, std::shared_ptr<ComPWA::Intensity>>(),
+      py::arg("hit_and_miss_sample") = ComPWA::Data::DataSet());
+
+  m.def(
+      "write_npy_record_array",
+      [](const std::string &filename,
+         const std::vector<std::string> &ColumnNames,
+         const std::vector<std::vector<double>> &Columns) {
+        std::vector<const std::vector<double> *> ColumnPointers;
+        for (auto const &x : Columns)
+          ColumnPointers.push_back(&x);
+        PyComPWA::Tools::writeNpyRecordArray(filename, ColumnNames,
+                                             ColumnPointers);
+      },
+      "Write columns as a structured numpy file, in the format of "
+      "create_numpyplotdata.",
+      py::arg("filename"), py::arg("column_names"), py::arg("columns"));
+
+  //------- Binned integration
+
+  m.def(
+      "integrate_function_in_bins",
+      [](py::function Function,
+         const std::vector<std::vector<double>> &BinEdges,
+         unsigned int PointsPerBin) {
+        auto Result = PyComPWA::Tools::integrateFunctionInBins(
+            [&Function](const std::vector<std::vector<double>> &Points) {
+              py::list Columns;
+              for (auto const &Column : Points)
+                Columns.append(
+                    py::array_t<double>(Column.size(), Column.data()));
+              auto Values = py::array_t<double, py::array::c_style |
+                                                    py::array::forcecast>(
+                  Function(*Columns));
+              return std::vector<double>(Values.data(),
+                                         Values.data() + Values.size());
+            },
+            BinEdges, PointsPerBin);
+        return std::make_pair(Result.Values, Result.Errors);
+      },
+      "Integrate a function over all bins of a histogram using quasi-random "
+      "points. The function is called once with one numpy array per "
+      "dimension. Returns the integrals and their errors in row-major order.",
+      py::arg("function"), py::arg("bin_edges"),
+      py::arg("points_per_bin") = 64);
+
+  m.def(
+      "integrate_intensity_in_bins",
+      [](std::shared_ptr<ComPWA::Intensity> Intensity,
+         const ComPWA::Data::DataSet &PhspSample,
+         const std::vector<std::string> &VariableNames,
+         const std::vector<std::vector<double>> &BinEdges) {
+        auto Result = PyComPWA::Tools::integrateIntensityInBins(
+            *Intensity, PhspSample, VariableNames, BinEdges);
+        return std::make_pair(Result.Values, Result.Errors);
+      },
+      "Integrate an intensity over all bins of a histogram, using the phase "
+      "space sample as Monte Carlo points. Returns the integrals and their "
+      "errors in row-major order.",
+      py::arg("intensity"), py::arg("phsp_sample"), py::arg("variable_names"),
+      py::arg("bin_edges"));
+
+  m.def(
+      "binned_chisquare",
+      [](const std::vector<double> &Observed,
+         const std::vector<double> &ObservedErrors,
+         const std::vector<double> &Expected,
+         const std::vector<double> &ExpectedErrors, bool Normalize) {
+        auto Result = PyComPWA::Tools::chiSquare(
+            Observed, ObservedErrors, {Expected, ExpectedErrors}, Normalize);
+        return std::make_tuple(Result.ChiSquare, Result.DegreesOfFreedom,
+                               Result.Scale);
+      },
+      "Chi square of an observed histogram and an expectation. Returns the "
+      "chi square, the degrees of freedom and the scale of the expectation. "
+      "Bins with vanishing variance are skipped and do not count as degrees "
+      "of freedom.",
+      py::arg("observed"), py::arg("observed_errors"), py::arg("expected"),
+      py::arg("expected_errors") = std::vector<double>(),
+      py::arg("normalize") = true);
+
+  m.def(
+      "adaptive_binning_chisquare",
+      [](const std::vector<DoubleArray> &DataColumns,
+         const DoubleArray &DataWeights,
+         const std::vector<DoubleArray> &ModelColumns,
+         const DoubleArray &ModelWeights, unsigned int MinimalEventsPerBin,
+         std::vector<std::pair<double, double>> Ranges) {
+        auto DataViews = asColumnViews(DataColumns);
+        auto DataWeightView = asColumnView(DataWeights);
+        auto ModelViews = asColumnViews(ModelColumns);
+        auto ModelWeightView = asColumnView(ModelWeights);
+        PyComPWA::Tools::AdaptiveChiSquareResult Result;
+        {
+          py::gil_scoped_release Release;
+          Result = PyComPWA::Tools::adaptiveChiSquare(
+              DataViews, DataWeightView, ModelViews, ModelWeightView,
+              MinimalEventsPerBin, Ranges);
+        }
+        std::size_t NumberOfBins = Result.Bins.size();
+        std::size_t Dimension = DataColumns.size();
+        py::array_t<double> LowerEdges({NumberOfBins, Dimension});
+        py::array_t<double> UpperEdges({NumberOfBins, Dimension});
+        for (std::size_t Bin = 0; Bin < NumberOfBins; ++Bin) {
+          std::copy(Result.Bins[Bin].LowerEdges.begin(),
+                    Result.Bins[Bin].LowerEdges.end(),
+                    LowerEdges.mutable_data(Bin, 0));
+          std::copy(Result.Bins[Bin].UpperEdges.begin(),
+                    Result.Bins[Bin].UpperEdges.end(),
+                    UpperEdges.mutable_data(Bin, 0));
+        }
+        py::dict Binning;
+        Binning["chi_square"] = Result.ChiSquare.ChiSquare;
+        Binning["degrees_of_freedom"] = Result.ChiSquare.DegreesOfFreedom;
+        Binning["lower_edges"] = LowerEdges;
+        Binning["upper_edges"] = UpperEdges;
+        Binning["data"] = py::array(py::cast(Result.Data.Values));
+        Binning["data_errors"] = py::array(py::cast(Result.Data.Errors));
+        Binning["model"] = py::array(py::cast(Result.Model.Values));
+        Binning["model_errors"] = py::array(py::cast(Result.Model.Errors));
+        return Binning;
+      },
+      "Chi square of a data sample and a weighted model sample in an "
+      "adaptive binning with nearly equal numbers of data events per bin. "
+      "Returns a dictionary with the chi square, the degrees of freedom, the "
+      "lower and upper edges of all bins and the data and model contents. "
+      "The model is scaled to the data.",
+      py::arg("data_columns"), py::arg("data_weights"),
+      py::arg("model_columns"), py::arg("model_weights"),
+      py::arg("minimal_events_per_bin") = 20,
+      py::arg("ranges") = std::vector<std::pair<double, double>>());
+
+  //------- Angular moments
+
+  m.def(
+      "angular_moments",
+      [](const DoubleArray &CosTheta, const DoubleArray &Phi,
+         const DoubleArray &Weights, unsigned int MaxL, const DoubleArray &Mass,
+         std::vector<double> MassBinEdges) {
+        auto CosThetaView = asColumnView(CosTheta);
+        auto PhiView = asColumnView(Phi);
+        auto WeightView = asColumnView(Weights);
+        auto MassView = asColumnView(Mass);
+        PyComPWA::Tools::AngularMoments Moments;
+        {
+          py::gil_scoped_release Release;
+          Moments = PyComPWA::Tools::computeAngularMoments(
+              CosThetaView, PhiView, WeightView, MaxL, MassView,
+              MassBinEdges);
+        }
+        return asTuple(Moments);
+      },
+      "Weighted sums of the Legendre polynomials P_L(cos theta) or, if phi is "
+      "given, of the real spherical harmonics up to max_l, computed in a "
+      "single pass. Returns the (L, M) indices, the moments with the shape "
+      "(mass bins, moments) and their covariance matrices. Without mass bin "
+      "edges there is a single bin.",
+      py::arg("cos_theta"), py::arg("phi") = DoubleArray(),
+      py::arg("weights") = DoubleArray(), py::arg("max_l") = 4,
+      py::arg("mass") = DoubleArray(),
+      py::arg("mass_bin_edges") = std::vector<double>());
+
+  m.def(
+      "angular_moments",
+      [](const ComPWA::Data::DataSet &Sample, const std::string &ThetaName,
+         const std::string &PhiName, unsigned int MaxL,
+         const std::string &MassName, std::vector<double> MassBinEdges) {
+        PyComPWA::Tools::AngularMoments Moments;
+        {
+          py::gil_scoped_release Release;
+          Moments = PyComPWA::Tools::computeAngularMoments(
+              Sample, ThetaName, PhiName, MaxL, MassName, MassBinEdges);
+        }
+        return asTuple(Moments);
+      },
+      "Angular moments of the helicity angles theta and phi (optional) of a "
+      "data set, optionally in bins of an invariant mass.",
+      py::arg("sample"), py::arg("theta_name"), py::arg("phi_name") = "",
+      py::arg("max_l") = 4, py::arg("mass_name") = "",
+      py::arg("mass_bin_edges") = std::vector<double>());
+
+  //------- Density estimation
+
+  m.def(
+      "kernel_density_estimate",
+      [](const std::vector<DoubleArray> &Columns,
+         std::vector<unsigned int> NumberOfBins, const DoubleArray &Weights,
+         std::vector<std::pair<double, double>> Ranges, bool Adaptive,
+         double BandwidthScale) {
+        PyComPWA::Tools::KernelDensitySettings Settings;
+        Settings.NumberOfBins = NumberOfBins;
+        Settings.Ranges = Ranges;
+        Settings.Adaptive = Adaptive;
+        Settings.BandwidthScale = BandwidthScale;
+        auto ColumnViews = asColumnViews(Columns);
+        auto WeightView = asColumnView(Weights);
+        PyComPWA::Tools::DensityGrid Density;
+        {
+          py::gil_scoped_release Release;
+          Density = PyComPWA::Tools::estimateDensity(ColumnViews, WeightView,
+                                                     Settings);
+        }
+        std::vector<std::size_t> Shape;
+        for (auto const &x : Density.BinEdges)
+          Shape.push_back(x.size() - 1);
+        py::array_t<double> Values(Shape);
+        std::copy(Density.Values.begin(), Density.Values.end(),
+                  Values.mutable_data());
+        return std::make_tuple(Density.BinEdges, Values, Density.Bandwidths);
+      },
+      "Gaussian kernel density estimate of a weighted sample in one to three "
+      "dimensions on a grid. Returns the bin edges, the estimated sum of "
+      "weights in each grid cell and the global bandwidths. The range of the "
+      "sample is used if no ranges are given.",
+      py::arg("columns"), py::arg("number_of_bins"),
+      py::arg("weights") = DoubleArray(),
+      py::arg("ranges") = std::vector<std::pair<double, double>>(),
+      py::arg("adaptive") = true, py::arg("bandwidth_scale") = 1.0);
+
+  //------- Goodness of fit
+
+  py::class_<PyComPWA::Tools::UnbinnedGoodnessOfFit>(
+      m, "UnbinnedGoodnessOfFit",
+      "Unbinned two-sample goodness of fit tests of a data sample against a "
+      "weighted model sample, e.g. the phase space sample weighted with the "
+      "fit result. All tests return the test statistic and a permutation "
+      "p-value. Large statistics indicate a bad fit.")
+      .def(py::init<const ComPWA::Data::DataSet &,
+                    const ComPWA::Data::DataSet &, std::vector<std::string>,
+                    bool>(),
+           py::arg("data_sample"), py::arg("model_sample"),
+           py::arg("variable_names") = std::vector<std::string>(),
+           py::arg("standardize") = true)
+      .def(py::init([](const std::vector<DoubleArray> &DataColumns,
+                       const DoubleArray &DataWeights,
+                       const std::vector<DoubleArray> &ModelColumns,
+                       const DoubleArray &ModelWeights, bool Standardize) {
+             return std::make_unique<PyComPWA::Tools::UnbinnedGoodnessOfFit>(
+                 asColumnViews(DataColumns), asColumnView(DataWeights),
+                 asColumnViews(ModelColumns), asColumnView(ModelWeights),
+                 Standardize);
+           }),
+           py::arg("data_columns"), py::arg("data_weights"),
+           py::arg("model_columns"), py::arg("model_weights"),
+           py::arg("standardize") = true)
+      .def(
+          "energy_test",
+          [](const PyComPWA::Tools::UnbinnedGoodnessOfFit &GoF,
+             unsigned int NumberOfPermutations, unsigned int Seed,
+             double Epsilon) {
+            py::gil_scoped_release Release;
+            auto Result = GoF.energyTest(NumberOfPermutations, Seed, Epsilon);
+            return std::make_pair(Result.Statistic, Result.PValue);
+          },
+          "Energy test with a logarithmic distance function. The run time is "
+          "quadratic in the number of events.",
+          py::arg("number_of_permutations") = 100, py::arg("seed") = 1234,
+          py::arg("epsilon") = 1e-4)
+      .def(
+          "point_to_point_dissimilarity",
+          [](const PyComPWA::Tools::UnbinnedGoodnessOfFit &GoF, double Sigma,
+             unsigned int NumberOfPermutations, unsigned int Seed) {
+            py::gil_scoped_release Release;
+            auto Result = GoF.pointToPointDissimilarity(
+                Sigma, NumberOfPermutations, Seed);
+            return std::make_pair(Result.Statistic, Result.PValue);
+          },
+          "Point-to-point dissimilarity test with a Gaussian distance "
+          "function of width sigma.",
+          py::arg("sigma") = 0.1, py::arg("number_of_permutations") = 100,
+          py::arg("seed") = 1234)
+      .def(
+          "mixed_sample_nearest_neighbours",
+          [](const PyComPWA::Tools::UnbinnedGoodnessOfFit &GoF, unsigned int K,
+             unsigned int NumberOfPermutations, unsigned int Seed) {
+            py::gil_scoped_release Release;
+            auto Result = GoF.mixedSampleNearestNeighbours(
+                K, NumberOfPermutations, Seed);
+            return std::make_pair(Result.Statistic, Result.PValue);
+          },
+          "Mixed sample test using the fraction of the k nearest neighbours "
+          "of each event which belong to the same sample.",
+          py::arg("k") = 10, py::arg("number_of_permutations") = 100,
+          py::arg("seed") = 1234);
+
+  //------- Expert system
+
+  py::class_<PyComPWA::ExpertSystem::ConservationRule,
+             std::shared_ptr<PyComPWA::ExpertSystem::ConservationRule>>(
+      m, "ConservationRule",
+      "Native implementation of a conservation rule of the expert system. "
+      "The type is the class name of the python rule.")
+      .def(py::init([](const std::string &Type,
+                       const std::string &QuantumNumber, bool UseProjection,
+                       double WidthFactor) {
+             return PyComPWA::ExpertSystem::createConservationRule(
+                 {Type, QuantumNumber, UseProjection, WidthFactor});
+           }),
+           py::arg("type"), py::arg("quantum_number") = "",
+           py::arg("use_projection") = true, py::arg("width_factor") = 3.0)
+      .def_property_readonly("name",
+                             &PyComPWA::ExpertSystem::ConservationRule::name);
+
+  m.def("supported_conservation_rules",
+        &PyComPWA::ExpertSystem::supportedConservationRules,
+        "Class names of the conservation rules with a native implementation.");
+
+  m.def(
+      "clebsch_gordan",
+      [](double j1, double m1, double j2, double m2, double j, double m) {
+        return PyComPWA::ExpertSystem::clebschGordan(
+                   twiceSpin(j1), twiceSpin(m1), twiceSpin(j2), twiceSpin(m2),
+                   twiceSpin(j), twiceSpin(m))
+            .value();
+      },
+      "Clebsch-Gordan coefficient <j1 m1 j2 m2 | j m> from the exact native "
+      "table of all spins up to 10, which is computed on first use.",
+      py::arg("j1"), py::arg("m1"), py::arg("j2"), py::arg("m2"), py::arg("j"),
+      py::arg("m"));
+
+  m.def(
+      "clebsch_gordan_squared",
+      [](double j1, double m1, double j2, double m2, double j, double m) {
+        auto Coefficient = PyComPWA::ExpertSystem::clebschGordan(
+            twiceSpin(j1), twiceSpin(m1), twiceSpin(j2), twiceSpin(m2),
+            twiceSpin(j), twiceSpin(m));
+        return py::make_tuple(Coefficient.Sign, Coefficient.Numerator,
+                              Coefficient.Denominator);
+      },
+      "Exact Clebsch-Gordan coefficient as (sign, numerator, denominator) of "
+      "its square.",
+      py::arg("j1"), py::arg("m1"), py::arg("j2"), py::arg("m2"), py::arg("j"),
+      py::arg("m"));
+
+  m.def(
+      "wigner_3j",
+      [](double j1, double m1, double j2, double m2, double j3, double m3) {
+        return PyComPWA::ExpertSystem::wigner3j(
+                   twiceSpin(j1), twiceSpin(m1), twiceSpin(j2), twiceSpin(m2),
+                   twiceSpin(j3), twiceSpin(m3))
+            .value();
+      },
+      py::arg("j1"), py::arg("m1"), py::arg("j2"), py::arg("m2"),
+      py::arg("j3"), py::arg("m3"));
+
+  m.def(
+      "ls_coupling_coefficient",
+      [](double J, double L, double S, double s1, double lambda1, double s2,
+         double lambda2) {
+        return PyComPWA::ExpertSystem::lsCouplingCoefficient(
+                   twiceSpin(J), twiceSpin(L), twiceSpin(S), twiceSpin(s1),
+                   twiceSpin(lambda1), twiceSpin(s2), twiceSpin(lambda2))
+            .value();
+      },
+      "Coefficient of the canonical amplitude a^J_LS in the helicity "
+      "amplitude F^J_lambda1,lambda2: sqrt((2L+1)/(2J+1)) "
+      "<L 0 S lambda | J lambda> <s1 lambda1 s2 -lambda2 | S lambda>.",
+      py::arg("J"), py::arg("L"), py::arg("S"), py::arg("s1"),
+      py::arg("lambda1"), py::arg("s2"), py::arg("lambda2"));
+
+  py::class_<PyComPWA::ExpertSystem::QuantumNumberProblem>(
+      m, "QuantumNumberProblem",
+      "Constraint satisfaction problem of the quantum number propagation. "
+      "Quantum number values are encoded as (defined, value, projection, "
+      "real), with spin-like values times two.")
+      .def(py::init<>())
+      .def(
+          "add_variable",
+          [](PyComPWA::ExpertSystem::QuantumNumberProblem &Problem,
+             const std::vector<EncodedQuantumNumber> &Domain) {
+            std::vector<PyComPWA::ExpertSystem::QuantumNumberValue> Values;
+            for (auto const &x : Domain)
+              Values.push_back(asQuantumNumberValue(x));
+            return Problem.addVariable(Values);
+          },
+          "Adds a variable and returns its index.", py::arg("domain"))
+      .def(
+          "add_constraint",
+          [](PyComPWA::ExpertSystem::QuantumNumberProblem &Problem,
+             std::shared_ptr<PyComPWA::ExpertSystem::ConservationRule> Rule,
+             const std::vector<EncodedConstraintState> &Ingoing,
+             const std::vector<EncodedConstraintState> &Outgoing,
+             const EncodedConstraintState &Interaction) {
+            Problem.addConstraint(Rule, asConstraintStates(Ingoing),
+                                  asConstraintStates(Outgoing),
+                                  asConstraintState(Interaction));
+          },
+          "Adds a rule as constraint. Each edge and the node is given as "
+          "lists of fixed values and variable indices.",
+          py::arg("rule"), py::arg("ingoing"), py::arg("outgoing"),
+          py::arg("interaction"))
+      .def(
+          "solve",
+          [](PyComPWA::ExpertSystem::QuantumNumberProblem &Problem) {
+            py::gil_scoped_release Release;
+            return Problem.solve();
+          },
+          "All solutions as the indices of the values in the variable "
+          "domains.")
+      .def(
+          "statistics",
+          [](const PyComPWA::ExpertSystem::QuantumNumberProblem &Problem) {
+            std::vector<std::tuple<std::size_t, std::size_t, bool>> Result;
+            for (auto const &x : Problem.statistics())
+              Result.emplace_back(x.Failed, x.Passed, x.ConditionsNeverMet);
+            return Result;
+          },
+          "Number of failed and passed checks of each constraint and whether "
+          "the rule requirements were not met, for the last solve().")
+      .def_property_readonly(
+          "number_of_variables",
+          &PyComPWA::ExpertSystem::QuantumNumberProblem::numberOfVariables);
+
+  py::class_<PyComPWA::ExpertSystem::GraphFingerprinter>(
+      m, "GraphFingerprinter",
+      "Fingerprint of a state transition graph, which is the same for graphs "
+      "that are equal apart from the ignored quantum numbers.")
+      .def(py::init<std::vector<std::string>>(),
+           py::arg("ignored_quantum_numbers") = std::vector<std::string>())
+      .def(
+          "__call__",
+          [](const PyComPWA::ExpertSystem::GraphFingerprinter &Fingerprinter,
+             const std::vector<int> &Nodes,
+             const std::vector<std::tuple<int, int, int>> &Edges,
+             const std::vector<EncodedGraphElementProperties> &NodeProperties,
+             const std::vector<EncodedGraphElementProperties>
+                 &EdgeProperties) {
+            std::vector<PyComPWA::ExpertSystem::GraphEdge> GraphEdges;
+            for (auto const &x : Edges) {
+              PyComPWA::ExpertSystem::GraphEdge Edge;
+              std::tie(Edge.Id, Edge.OriginatingNode, Edge.EndingNode) = x;
+              GraphEdges.push_back(Edge);
+            }
+            auto Fingerprint = Fingerprinter(
+                Nodes, GraphEdges, asGraphElementProperties(NodeProperties),
+                asGraphElementProperties(EdgeProperties));
+            return std::make_pair(Fingerprint.High, Fingerprint.Low);
+          },
+          "Fingerprint as pair of 64 bit integers. The edges are given as "
+          "(id, originating node, ending node), with -1 for unconnected ends.",
+          py::arg("nodes"), py::arg("edges"), py::arg("node_properties"),
+          py::arg("edge_properties"));
+
+  m.def(
+      "solve_quantum_number_problems",
+      [](const std::vector<PyComPWA::ExpertSystem::QuantumNumberProblem *>
+             &Problems,
+         int NumberOfThreads) {
+        py::gil_scoped_release Release;
+        return PyComPWA::ExpertSystem::solveQuantumNumberProblems(
+            Problems, NumberOfThreads);
+      },
+      "Solves all problems on a thread pool and returns their solutions. "
+      "All threads are used if number_of_threads is not positive.",
+      py::arg("problems"), py::arg("number_of_threads") = 0);
+
+  py::class_<PyComPWA::ExpertSystem::TopologyGenerator>(
+      m, "TopologyGenerator",
+      "Enumerates the non-isomorphic topologies of interaction nodes, given "
+      "as (number of ingoing edges, number of outgoing edges).")
+      .def(py::init([](const std::vector<std::pair<unsigned int, unsigned int>>
+                           &InteractionNodes) {
+             std::vector<PyComPWA::ExpertSystem::InteractionNodeType> Types;
+             for (auto const &x : InteractionNodes) {
+               PyComPWA::ExpertSystem::InteractionNodeType Type;
+               Type.NumberOfIngoingEdges = x.first;
+               Type.NumberOfOutgoingEdges = x.second;
+               Types.push_back(Type);
+             }
+             return PyComPWA::ExpertSystem::TopologyGenerator(Types);
+           }),
+           py::arg("interaction_nodes"))
+      .def(
+          "generate",
+          [](PyComPWA::ExpertSystem::TopologyGenerator &Generator,
+             std::size_t NumberOfInitialEdges, std::size_t NumberOfFinalEdges) {
+            std::vector<
+                std::pair<std::size_t, std::vector<std::pair<int, int>>>>
+                Result;
+            for (auto const &x : Generator.generate(NumberOfInitialEdges,
+                                                    NumberOfFinalEdges)) {
+              std::vector<std::pair<int, int>> Edges;
+              for (auto const &Edge : x.Edges)
+                Edges.emplace_back(Edge.OriginatingNode, Edge.EndingNode);
+              Result.emplace_back(x.NumberOfNodes, Edges);
+            }
+            return Result;
+          },
+          "Topologies as (number of nodes, edges). The edges are given as "
+          "(originating node, ending node), with -1 for the initial and final "
+          "state. The results are memoized.",
+          py::arg("number_of_initial_edges"), py::arg("number_of_final_edges"));
 }
@@ -0,0 +1,240 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "Core/Exceptions.hpp"
+
+#include "PyComPWA/ExpertSystem/ClebschGordan.hpp"
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+namespace {
+
+using Int128 = __int128;
+using UInt128 = unsigned __int128;
+
+/// All prime factors of the factorials in Racah's formula up to
+/// MaximumTwiceSpin.
+const std::array<int, 11> Primes{{2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31}};
+
+/// Rational number as exponents of Primes.
+using PrimeExponents = std::array<int, 11>;
+
+void addFactorial(PrimeExponents &Exponents, int n, int Power) {
+  for (std::size_t i = 0; i < Primes.size(); ++i) {
+    for (int p = Primes[i]; p <= n; p *= Primes[i])
+      Exponents[i] += Power * (n / p);
+  }
+}
+
+/// Divides all factors of Primes out of \p x and adds them to \p Exponents.
+UInt128 addPrimeFactors(PrimeExponents &Exponents, UInt128 x, int Power) {
+  for (std::size_t i = 0; i < Primes.size(); ++i) {
+    while (x % Primes[i] == 0) {
+      x /= Primes[i];
+      Exponents[i] += Power;
+    }
+  }
+  return x;
+}
+
+UInt128 factorial(int n) {
+  UInt128 Result(1);
+  for (int i = 2; i <= n; ++i)
+    Result *= i;
+  return Result;
+}
+
+UInt128 gcd(UInt128 a, UInt128 b) {
+  while (b != 0) {
+    UInt128 Remainder = a % b;
+    a = b;
+    b = Remainder;
+  }
+  return a;
+}
+
+const UInt128 MaximumUInt64 = std::numeric_limits<std::uint64_t>::max();
+
+/// Multiplies \p x by \p y and throws if the result exceeds 64 bit.
+UInt128 multiplyChecked(UInt128 x, UInt128 y) {
+  if (y != 0 && x > MaximumUInt64 / y)
+    throw ComPWA::BadParameter("PyComPWA::ExpertSystem::clebschGordan(): "
+                               "the coefficient exceeds 64 bit integers!");
+  return x * y;
+}
+
+/// Reduces the fraction, which has to fit into 64 bit afterwards.
+SquaredCoefficient makeCoefficient(int Sign, UInt128 Numerator,
+                                   UInt128 Denominator) {
+  if (Sign == 0 || Numerator == 0)
+    return SquaredCoefficient{0, 0, 1};
+  UInt128 Divisor = gcd(Numerator, Denominator);
+  return SquaredCoefficient{
+      Sign, static_cast<std::uint64_t>(multiplyChecked(Numerator / Divisor, 1)),
+      static_cast<std::uint64_t>(multiplyChecked(Denominator / Divisor, 1))};
+}
+
+SquaredCoefficient multiply(const SquaredCoefficient &x,
+                            const SquaredCoefficient &y) {
+  return makeCoefficient(x.Sign * y.Sign, UInt128(x.Numerator) * y.Numerator,
+                         UInt128(x.Denominator) * y.Denominator);
+}
+
+bool isValid(int TwiceJ, int TwiceM) {
+  return TwiceJ >= 0 && std::abs(TwiceM) <= TwiceJ &&
+         (TwiceJ + TwiceM) % 2 == 0;
+}
+
+/// Racah's formula in exact arithmetic. The prefactor is kept as prime
+/// exponents, as the products of its factorials exceed 128 bit.
+SquaredCoefficient computeClebschGordan(int tj1, int tm1, int tj2, int tm2,
+                                        int tj, int tm) {
+  if (tm1 + tm2 != tm || !isValid(tj1, tm1) || !isValid(tj2, tm2) ||
+      !isValid(tj, tm) || tj < std::abs(tj1 - tj2) || tj > tj1 + tj2 ||
+      (tj1 + tj2 + tj) % 2 != 0)
+    return SquaredCoefficient{0, 0, 1};
+  int J = (tj1 + tj2 + tj) / 2;
+  int j1PlusJ2MinusJ = (tj1 + tj2 - tj) / 2;
+  int j1MinusM1 = (tj1 - tm1) / 2;
+  int j2PlusM2 = (tj2 + tm2) / 2;
+  int jMinusJ2PlusM1 = (tj - tj2 + tm1) / 2;
+  int jMinusJ1MinusM2 = (tj - tj1 - tm2) / 2;
+
+  // the sum is an integer in units of 1 / J!
+  UInt128 JFactorial = factorial(J);
+  Int128 Sum(0);
+  int kMinimum = std::max({0, -jMinusJ2PlusM1, -jMinusJ1MinusM2});
+  int kMaximum = std::min({j1PlusJ2MinusJ, j1MinusM1, j2PlusM2});
+  for (int k = kMinimum; k <= kMaximum; ++k) {
+    UInt128 Denominator = factorial(k) * factorial(j1PlusJ2MinusJ - k) *
+                          factorial(j1MinusM1 - k) * factorial(j2PlusM2 - k) *
+                          factorial(jMinusJ2PlusM1 + k) *
+                          factorial(jMinusJ1MinusM2 + k);
+    Int128 Term = JFactorial / Denominator;
+    Sum += k % 2 ? -Term : Term;
+  }
+  if (Sum == 0)
+    return SquaredCoefficient{0, 0, 1};
+
+  PrimeExponents Exponents{};
+  UInt128 Remainder = addPrimeFactors(Exponents, tj + 1, 1);
+  addFactorial(Exponents, (tj + tj1 - tj2) / 2, 1);
+  addFactorial(Exponents, (tj - tj1 + tj2) / 2, 1);
+  addFactorial(Exponents, j1PlusJ2MinusJ, 1);
+  addFactorial(Exponents, J + 1, -1);
+  addFactorial(Exponents, (tj + tm) / 2, 1);
+  addFactorial(Exponents, (tj - tm) / 2, 1);
+  addFactorial(Exponents, j1MinusM1, 1);
+  addFactorial(Exponents, (tj1 + tm1) / 2, 1);
+  addFactorial(Exponents, (tj2 - tm2) / 2, 1);
+  addFactorial(Exponents, j2PlusM2, 1);
+  addFactorial(Exponents, J, -2);
+  UInt128 SumRemainder =
+      addPrimeFactors(Exponents, Sum > 0 ? UInt128(Sum) : UInt128(-Sum), 2);
+
+  UInt128 Numerator =
+      multiplyChecked(Remainder, multiplyChecked(SumRemainder, SumRemainder));
+  UInt128 Denominator(1);
+  for (std::size_t i = 0; i < Primes.size(); ++i) {
+    for (int e = 0; e < std::abs(Exponents[i]); ++e) {
+      if (Exponents[i] > 0)
+        Numerator = multiplyChecked(Numerator, Primes[i]);
+      else
+        Denominator = multiplyChecked(Denominator, Primes[i]);
+    }
+  }
+  return makeCoefficient(Sum > 0 ? 1 : -1, Numerator, Denominator);
+}
+
+/// All coefficients up to MaximumTwiceSpin. The coefficients of the allowed
+/// spins (j1, j2, j) are stored in blocks of (2 j1 + 1) (2 j2 + 1)
+/// projections, as m = m1 + m2. Offsets holds the start of each block or -1
+/// if the spins cannot couple.
+struct CoefficientTable {
+  static const int Size = MaximumTwiceSpin + 1;
+  std::vector<int> Offsets;
+  std::vector<SquaredCoefficient> Coefficients;
+
+  CoefficientTable() : Offsets(Size * Size * Size, -1) {
+    for (int tj1 = 0; tj1 < Size; ++tj1) {
+      for (int tj2 = 0; tj2 < Size; ++tj2) {
+        for (int tj = std::abs(tj1 - tj2); tj <= std::min(tj1 + tj2, Size - 1);
+             tj += 2) {
+          Offsets[block(tj1, tj2, tj)] = Coefficients.size();
+          for (int tm1 = -tj1; tm1 <= tj1; tm1 += 2) {
+            for (int tm2 = -tj2; tm2 <= tj2; tm2 += 2)
+              Coefficients.push_back(
+                  computeClebschGordan(tj1, tm1, tj2, tm2, tj, tm1 + tm2));
+          }
+        }
+      }
+    }
+  }
+
+  static int block(int tj1, int tj2, int tj) {
+    return (tj1 * Size + tj2) * Size + tj;
+  }
+};
+
+/// The table is filled once on first use, afterwards it is only read. Hence
+/// lookups from several threads need no locking.
+const CoefficientTable &table() {
+  static const CoefficientTable Table;
+  return Table;
+}
+
+} // namespace
+
+SquaredCoefficient clebschGordan(int TwiceJ1, int TwiceM1, int TwiceJ2,
+                                 int TwiceM2, int TwiceJ, int TwiceM) {
+  if (std::min({TwiceJ1, TwiceJ2, TwiceJ}) < 0 ||
+      std::max({TwiceJ1, TwiceJ2, TwiceJ}) > MaximumTwiceSpin)
+    throw ComPWA::BadParameter(
+        "PyComPWA::ExpertSystem::clebschGordan(): spins have to be between 0 "
+        "and " +
+        std::to_string(MaximumTwiceSpin / 2) + "!");
+  if (TwiceM1 + TwiceM2 != TwiceM || !isValid(TwiceJ1, TwiceM1) ||
+      !isValid(TwiceJ2, TwiceM2) || !isValid(TwiceJ, TwiceM))
+    return SquaredCoefficient{0, 0, 1};
+  auto const &Table = table();
+  int Offset = Table.Offsets[CoefficientTable::block(TwiceJ1, TwiceJ2, TwiceJ)];
+  if (Offset < 0)
+    return SquaredCoefficient{0, 0, 1};
+  return Table.Coefficients[Offset + (TwiceJ1 + TwiceM1) / 2 * (TwiceJ2 + 1) +
+                            (TwiceJ2 + TwiceM2) / 2];
+}
+
+SquaredCoefficient wigner3j(int TwiceJ1, int TwiceM1, int TwiceJ2, int TwiceM2,
+                            int TwiceJ3, int TwiceM3) {
+  auto Coefficient =
+      clebschGordan(TwiceJ1, TwiceM1, TwiceJ2, TwiceM2, TwiceJ3, -TwiceM3);
+  // (-1)^(j1 - j2 - m3), the exponent is an integer for valid spins
+  int Sign = ((TwiceJ1 - TwiceJ2 - TwiceM3) % 4 + 4) % 4 == 2 ? -1 : 1;
+  return multiply(Coefficient,
+                  SquaredCoefficient{Sign, 1, std::uint64_t(TwiceJ3 + 1)});
+}
+
+SquaredCoefficient lsCouplingCoefficient(int TwiceJ, int TwiceL, int TwiceS,
+                                         int TwiceS1, int TwiceLambda1,
+                                         int TwiceS2, int TwiceLambda2) {
+  int TwiceLambda = TwiceLambda1 - TwiceLambda2;
+  auto Coefficient = multiply(
+      clebschGordan(TwiceL, 0, TwiceS, TwiceLambda, TwiceJ, TwiceLambda),
+      clebschGordan(TwiceS1, TwiceLambda1, TwiceS2, -TwiceLambda2, TwiceS,
+                    TwiceLambda));
+  return multiply(Coefficient,
+                  SquaredCoefficient{1, std::uint64_t(TwiceL + 1),
+                                     std::uint64_t(TwiceJ + 1)});
+}
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
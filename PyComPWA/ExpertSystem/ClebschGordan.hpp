@@ -0,0 +1,63 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_EXPERTSYSTEM_CLEBSCHGORDAN_HPP_
+#define PYCOMPWA_EXPERTSYSTEM_CLEBSCHGORDAN_HPP_
+
+#include <cmath>
+#include <cstdint>
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+/// Largest twice spin of the coefficient tables. The intermediate results of
+/// Racah's formula fit into 128 bit integers up to this spin.
+const int MaximumTwiceSpin = 20;
+
+///
+/// \struct SquaredCoefficient
+/// Exact value of a coupling coefficient c, which is a signed square root of
+/// a rational number: \f$c = Sign \sqrt{Numerator / Denominator}\f$. The
+/// fraction is reduced and Sign is 0 if the coefficient vanishes.
+///
+struct SquaredCoefficient {
+  int Sign;
+  std::uint64_t Numerator;
+  std::uint64_t Denominator;
+
+  double value() const {
+    return Sign * std::sqrt(static_cast<double>(Numerator) / Denominator);
+  }
+};
+
+/// Clebsch-Gordan coefficient \f$\langle j_1 m_1 j_2 m_2 | j m \rangle\f$,
+/// with all spins given as twice their values. The coefficients are evaluated
+/// in exact integer arithmetic. All coefficients up to MaximumTwiceSpin are
+/// computed at the first call (about 400000 entries), later calls only look
+/// them up and can run concurrently without locking. Throws if a spin exceeds
+/// MaximumTwiceSpin.
+SquaredCoefficient clebschGordan(int TwiceJ1, int TwiceM1, int TwiceJ2,
+                                 int TwiceM2, int TwiceJ, int TwiceM);
+
+/// Wigner 3j symbol, with all spins given as twice their values.
+SquaredCoefficient wigner3j(int TwiceJ1, int TwiceM1, int TwiceJ2, int TwiceM2,
+                            int TwiceJ3, int TwiceM3);
+
+/// Coefficient of the canonical amplitude \f$a^J_{LS}\f$ in the helicity
+/// amplitude \f$F^J_{\lambda_1 \lambda_2}\f$:
+/// \f[
+///   \sqrt{\frac{2L + 1}{2J + 1}}
+///   \langle L 0 S \lambda | J \lambda \rangle
+///   \langle s_1 \lambda_1 s_2 -\lambda_2 | S \lambda \rangle, \quad
+///   \lambda = \lambda_1 - \lambda_2,
+/// \f]
+/// with all spins given as twice their values.
+SquaredCoefficient lsCouplingCoefficient(int TwiceJ, int TwiceL, int TwiceS,
+                                         int TwiceS1, int TwiceLambda1,
+                                         int TwiceS2, int TwiceLambda2);
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
+
+#endif
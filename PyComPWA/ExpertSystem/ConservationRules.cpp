@@ -0,0 +1,664 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+
+#include "Core/Exceptions.hpp"
+
+#include "PyComPWA/ExpertSystem/ClebschGordan.hpp"
+#include "PyComPWA/ExpertSystem/ConservationRules.hpp"
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+namespace {
+
+using QN = QuantumNumberName;
+
+/// Spin as twice the magnitude and twice the projection.
+using SpinPair = std::pair<int, int>;
+
+bool isInteractionQuantumNumber(QuantumNumberName Name) {
+  return Name == QN::L || Name == QN::S || Name == QN::ParityPrefactor;
+}
+
+/// Implements \f$(-1)^{x/2}\f$ for \p TwiceExponent = x. Python yields a
+/// complex number for half-integer exponents, which never equals a sign. It
+/// is represented by 2.
+int minusOnePower(int TwiceExponent) {
+  if (TwiceExponent % 2 != 0)
+    return 2;
+  return (TwiceExponent / 2) % 2 == 0 ? 1 : -1;
+}
+
+bool isBoson(const QuantumNumbers &State) {
+  return State[QN::Spin].Value % 2 == 0;
+}
+
+SpinPair spinPair(const QuantumNumberValue &Value) {
+  return SpinPair(Value.Value, Value.Projection);
+}
+
+int product(const std::vector<QuantumNumbers> &States, QuantumNumberName Name) {
+  int Product(1);
+  for (auto const &State : States)
+    Product *= State[Name].Value;
+  return Product;
+}
+
+bool definedForAll(const std::vector<QuantumNumbers> &States,
+                   QuantumNumberName Name) {
+  return std::all_of(
+      States.begin(), States.end(),
+      [Name](const QuantumNumbers &State) { return State.defined(Name); });
+}
+
+/// Checks if an integer valued spin difference (times two) is odd.
+bool isOddDifference(int TwiceDifference) {
+  return std::abs(TwiceDifference) % 4 == 2;
+}
+
+/// Selection rules of the Clebsch-Gordan coefficients for some special cases,
+/// see is_clebsch_gordan_coefficient_zero() in conservationrules.py.
+bool isClebschGordanCoefficientZero(SpinPair Spin1, SpinPair Spin2,
+                                    SpinPair Coupled) {
+  int j1 = Spin1.first, m1 = Spin1.second;
+  int j2 = Spin2.first, m2 = Spin2.second;
+  int j = Coupled.first, m = Coupled.second;
+  if ((j1 == j2 && m1 == m2) || (m1 == 0 && m2 == 0))
+    return isOddDifference(j - j1 - j2);
+  if (j1 == j && m1 == -m)
+    return isOddDifference(j2 - j1 - j);
+  if (j2 == j && m2 == -m)
+    return isOddDifference(j1 - j2 - j);
+  return false;
+}
+
+/// Exact check with the coefficient table, see
+/// is_exact_clebsch_gordan_coefficient_zero() in conservationrules.py. Throws
+/// for spins beyond MaximumTwiceSpin.
+bool isExactClebschGordanCoefficientZero(SpinPair Spin1, SpinPair Spin2,
+                                         SpinPair Coupled) {
+  return clebschGordan(Spin1.first, Spin1.second, Spin2.first, Spin2.second,
+                       Coupled.first, Coupled.second)
+             .Sign == 0;
+}
+
+class AdditiveQuantumNumberConservation : public ConservationRule {
+public:
+  explicit AdditiveQuantumNumberConservation(QuantumNumberName Name)
+      : ConservationRule(quantumNumberNameString(Name) + "Conservation"),
+        QuantumNumber(Name) {
+    addRequiredQuantumNumber(Name, {Condition::DefinedForAllEdges});
+  }
+
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &) const override {
+    return sum(Ingoing) == sum(Outgoing);
+  }
+
+private:
+  int sum(const std::vector<QuantumNumbers> &States) const {
+    int Sum(0);
+    for (auto const &State : States) {
+      if (State.defined(QuantumNumber))
+        Sum += State[QuantumNumber].Value;
+    }
+    return Sum;
+  }
+
+  QuantumNumberName QuantumNumber;
+};
+
+class ParityConservation : public ConservationRule {
+public:
+  ParityConservation() : ConservationRule("ParityConservation") {
+    addRequiredQuantumNumber(QN::Parity, {Condition::DefinedForAllEdges});
+    addRequiredQuantumNumber(QN::L, {Condition::DefinedForInteractionNode});
+  }
+
+  /// \f$P_{in} = P_{out} \cdot (-1)^L\f$
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &Interaction) const override {
+    return product(Ingoing, QN::Parity) ==
+           product(Outgoing, QN::Parity) *
+               minusOnePower(Interaction[QN::L].Value);
+  }
+};
+
+class ParityConservationHelicity : public ConservationRule {
+public:
+  ParityConservationHelicity()
+      : ConservationRule("ParityConservationHelicity") {
+    addRequiredQuantumNumber(QN::Parity, {Condition::DefinedForAllEdges});
+    addRequiredQuantumNumber(QN::Spin, {Condition::DefinedForAllEdges});
+    addRequiredQuantumNumber(QN::ParityPrefactor,
+                             {Condition::DefinedForInteractionNode});
+  }
+
+  /// \f$A_{-\lambda_1-\lambda_2} = P_1 P_2 P_3 (-1)^{S_2+S_3-S_1}
+  /// A_{\lambda_1\lambda_2}\f$ for two body decays.
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &Interaction) const override {
+    if (Ingoing.size() != 1 || Outgoing.size() != 2)
+      return true;
+    int Prefactor =
+        product(Ingoing, QN::Parity) * product(Outgoing, QN::Parity) *
+        minusOnePower(Outgoing[0][QN::Spin].Value +
+                      Outgoing[1][QN::Spin].Value - Ingoing[0][QN::Spin].Value);
+    if (Outgoing[0][QN::Spin].Projection == 0 &&
+        Outgoing[1][QN::Spin].Projection == 0 && Prefactor == -1)
+      return false;
+    return Interaction.defined(QN::ParityPrefactor) &&
+           Prefactor == Interaction[QN::ParityPrefactor].Value;
+  }
+};
+
+/// Base of the C- and G-parity rules, which need the spin, L, S and the
+/// particle ids to determine the parity of particle antiparticle pairs.
+class MultiplicativeParityConservation : public ConservationRule {
+public:
+  MultiplicativeParityConservation(std::string Name, QuantumNumberName Parity,
+                                   std::vector<QuantumNumberName> Others)
+      : ConservationRule(std::move(Name)), Parity(Parity) {
+    addRequiredQuantumNumber(Parity);
+    for (auto Other : Others)
+      addRequiredQuantumNumber(
+          Other, {Condition::DefinedIfOtherQnNotDefinedInOutSeperate}, Parity);
+  }
+
+protected:
+  /// Parity of a particle antiparticle pair with the exponent \p TwiceOffset
+  /// (times two) in addition to L (and S for fermions), or 0 if the pair is
+  /// no particle antiparticle pair.
+  int pairParity(const std::vector<QuantumNumbers> &Pair,
+                 const QuantumNumbers &Interaction, int TwiceOffset) const {
+    if (Pair.size() != 2 || !Pair[0].defined(QN::Pid) ||
+        !Pair[1].defined(QN::Pid) ||
+        Pair[0][QN::Pid].Value != -Pair[1][QN::Pid].Value)
+      return 0;
+    if (!Pair[0].defined(QN::Spin) || !Interaction.defined(QN::L))
+      return 0;
+    int TwiceExponent = Interaction[QN::L].Value + TwiceOffset;
+    if (!isBoson(Pair[0])) {
+      if (!Interaction.defined(QN::S))
+        return 0;
+      TwiceExponent += Interaction[QN::S].Value;
+    }
+    return minusOnePower(TwiceExponent);
+  }
+
+  QuantumNumberName Parity;
+};
+
+class CParityConservation : public MultiplicativeParityConservation {
+public:
+  CParityConservation()
+      : MultiplicativeParityConservation(
+            "CParityConservation", QN::Cparity,
+            {QN::Spin, QN::L, QN::S, QN::Pid}) {}
+
+  /// \f$C_{in} = C_{out}\f$
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &Interaction) const override {
+    int CParityIn = multiParticleCParity(Ingoing, Interaction);
+    if (CParityIn == 0)
+      return true;
+    int CParityOut = multiParticleCParity(Outgoing, Interaction);
+    if (CParityOut == 0)
+      return true;
+    return CParityIn == CParityOut;
+  }
+
+private:
+  /// Returns 0 if the C-parity cannot be determined.
+  int multiParticleCParity(const std::vector<QuantumNumbers> &States,
+                           const QuantumNumbers &Interaction) const {
+    if (definedForAll(States, Parity))
+      return product(States, Parity);
+    return pairParity(States, Interaction, 0);
+  }
+};
+
+class GParityConservation : public MultiplicativeParityConservation {
+public:
+  GParityConservation()
+      : MultiplicativeParityConservation(
+            "GParityConservation", QN::Gparity,
+            {QN::Spin, QN::L, QN::S, QN::IsoSpin, QN::Pid}) {}
+
+  /// \f$G_{in} = G_{out}\f$
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &Interaction) const override {
+    if (definedForAll(Ingoing, Parity) && definedForAll(Outgoing, Parity))
+      return product(Ingoing, Parity) == product(Outgoing, Parity);
+
+    if (Ingoing.size() == 1 && Outgoing.size() == 2)
+      return checkSingleState(Ingoing, Outgoing, Interaction);
+    if (Ingoing.size() == 2 && Outgoing.size() == 1)
+      return checkSingleState(Outgoing, Ingoing, Interaction);
+    return true;
+  }
+
+private:
+  bool checkSingleState(const std::vector<QuantumNumbers> &Single,
+                        const std::vector<QuantumNumbers> &Pair,
+                        const QuantumNumbers &Interaction) const {
+    if (!Single[0].defined(Parity) || !Single[0].defined(QN::IsoSpin))
+      return true;
+    int PairGParity =
+        pairParity(Pair, Interaction, Single[0][QN::IsoSpin].Value);
+    if (PairGParity == 0)
+      return true;
+    return PairGParity == Single[0][Parity].Value;
+  }
+};
+
+class IdenticalParticleSymmetrization : public ConservationRule {
+public:
+  IdenticalParticleSymmetrization()
+      : ConservationRule("IdenticalParticleSymmetrization") {
+    addRequiredQuantumNumber(QN::Parity);
+    addRequiredQuantumNumber(QN::Pid, {Condition::DefinedForAllOutgoingEdges});
+    addRequiredQuantumNumber(QN::Spin, {Condition::DefinedForAllOutgoingEdges});
+  }
+
+  /// Identical bosons (fermions) require an even (odd) parity of the mother.
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &) const override {
+    if (Outgoing.empty() || Ingoing.empty() ||
+        !Ingoing[0].defined(QN::Parity))
+      return true;
+    for (auto const &State : Outgoing) {
+      if (State[QN::Pid] != Outgoing[0][QN::Pid] ||
+          State[QN::Spin] != Outgoing[0][QN::Spin])
+        return true;
+    }
+    int MotherParity = Ingoing[0][QN::Parity].Value;
+    return isBoson(Outgoing[0]) ? MotherParity != -1 : MotherParity != 1;
+  }
+};
+
+class SpinConservation : public ConservationRule {
+public:
+  SpinConservation(QuantumNumberName Name, bool UseProjection)
+      : ConservationRule(quantumNumberNameString(Name) + "Conservation"),
+        SpinLike(Name), UseProjection(UseProjection) {
+    if (Name != QN::Spin && Name != QN::IsoSpin)
+      throw ComPWA::BadParameter("PyComPWA::ExpertSystem::SpinConservation: " +
+                                 quantumNumberNameString(Name) +
+                                 " is not a spin-like quantum number!");
+    addRequiredQuantumNumber(Name, {Condition::DefinedForAllEdges});
+    // for actual spins the angular momentum is included
+    if (Name == QN::Spin) {
+      addRequiredQuantumNumber(QN::L, {Condition::DefinedForInteractionNode});
+      addRequiredQuantumNumber(QN::S, {Condition::DefinedForInteractionNode});
+    }
+  }
+
+  /// \f$|S_1 - S_2| \leq S \leq |S_1 + S_2|\f$ and optionally
+  /// \f$|L - S| \leq J \leq |L + S|\f$. With projections also
+  /// \f$M_1 + M_2 = M\f$ and vanishing Clebsch-Gordan coefficients are
+  /// checked.
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &Interaction) const override {
+    std::vector<SpinPair> InSpins, OutSpins;
+    int InProjection(0), OutProjection(0);
+    for (auto const &State : Ingoing) {
+      InSpins.push_back(spinPair(State[SpinLike]));
+      InProjection += State[SpinLike].Projection;
+    }
+    for (auto const &State : Outgoing) {
+      OutSpins.push_back(spinPair(State[SpinLike]));
+      OutProjection += State[SpinLike].Projection;
+    }
+    if (UseProjection && InProjection != OutProjection)
+      return false;
+    auto InTotal = totalSpins(InSpins, Interaction);
+    auto OutTotal = totalSpins(OutSpins, Interaction);
+    return std::any_of(InTotal.begin(), InTotal.end(),
+                       [&OutTotal](const SpinPair &x) {
+                         return OutTotal.count(x) > 0;
+                       });
+  }
+
+private:
+  std::set<SpinPair> totalSpins(std::vector<SpinPair> Spins,
+                                const QuantumNumbers &Interaction) const {
+    std::set<SpinPair> Total;
+    if (Spins.size() == 1) {
+      Total.insert(UseProjection ? Spins[0] : SpinPair(Spins[0].first, 0));
+      return Total;
+    }
+    // first couple all spins together
+    std::set<SpinPair> Coupled;
+    while (!Spins.empty()) {
+      SpinPair Next = Spins.back();
+      Spins.pop_back();
+      if (Coupled.empty()) {
+        Coupled.insert(Next);
+        continue;
+      }
+      std::set<SpinPair> NewCoupled;
+      for (auto const &x : Coupled) {
+        auto Couplings = spinCouplings(x, Next);
+        NewCoupled.insert(Couplings.begin(), Couplings.end());
+      }
+      Coupled = std::move(NewCoupled);
+    }
+    if (Interaction.has(QN::L)) {
+      SpinPair L = spinPair(Interaction[QN::L]);
+      SpinPair S = spinPair(Interaction[QN::S]);
+      bool Found =
+          UseProjection
+              ? Coupled.count(S) > 0
+              : std::any_of(Coupled.begin(), Coupled.end(),
+                            [&S](const SpinPair &x) {
+                              return x.first == S.first;
+                            });
+      if (Found) {
+        auto Couplings = spinCouplings(S, L);
+        Total.insert(Couplings.begin(), Couplings.end());
+      }
+    } else if (UseProjection) {
+      Total = std::move(Coupled);
+    } else {
+      for (auto const &x : Coupled)
+        Total.insert(SpinPair(x.first, 0));
+    }
+    return Total;
+  }
+
+  /// \f$|S_1 - S_2| \leq S \leq |S_1 + S_2|\f$ and \f$M_1 + M_2 = M\f$
+  std::vector<SpinPair> spinCouplings(SpinPair Spin1, SpinPair Spin2) const {
+    std::vector<SpinPair> Couplings;
+    int Projection = UseProjection ? Spin1.second + Spin2.second : 0;
+    for (int j = std::abs(Spin1.first - Spin2.first);
+         j <= Spin1.first + Spin2.first; j += 2) {
+      if (!UseProjection) {
+        Couplings.emplace_back(j, 0);
+        continue;
+      }
+      if (j >= std::abs(Projection) &&
+          !isClebschGordanCoefficientZero(Spin1, Spin2,
+                                          SpinPair(j, Projection)))
+        Couplings.emplace_back(j, Projection);
+    }
+    return Couplings;
+  }
+
+  QuantumNumberName SpinLike;
+  bool UseProjection;
+};
+
+class ClebschGordanCheckHelicityToCanonical : public ConservationRule {
+public:
+  ClebschGordanCheckHelicityToCanonical()
+      : ClebschGordanCheckHelicityToCanonical(
+            "ClebschGordanCheckHelicityToCanonical",
+            isClebschGordanCoefficientZero) {}
+
+protected:
+  using CoefficientCheck = bool (*)(SpinPair, SpinPair, SpinPair);
+
+  ClebschGordanCheckHelicityToCanonical(std::string Name,
+                                        CoefficientCheck IsZero)
+      : ConservationRule(std::move(Name)), IsZero(IsZero) {
+    addRequiredQuantumNumber(QN::Spin, {Condition::DefinedForAllEdges});
+    addRequiredQuantumNumber(QN::L, {Condition::DefinedForInteractionNode});
+    addRequiredQuantumNumber(QN::S, {Condition::DefinedForInteractionNode});
+  }
+
+public:
+  /// Clebsch-Gordan checks of the \f$S_1, S_2\f$ to \f$S\f$ and the
+  /// \f$L, S\f$ to \f$J\f$ couplings of the canonical amplitudes.
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &Interaction) const override {
+    if (Ingoing.size() != 1 || Outgoing.size() != 2)
+      return false;
+    SpinPair Daughter1 = spinPair(Outgoing[0][QN::Spin]);
+    SpinPair Daughter2 = spinPair(Outgoing[1][QN::Spin]);
+    Daughter2.second = -Daughter2.second;
+    int HelicityDifference = Daughter1.second + Daughter2.second;
+    SpinPair L = spinPair(Interaction[QN::L]);
+    SpinPair S = spinPair(Interaction[QN::S]);
+    int MotherSpin = Ingoing[0][QN::Spin].Value;
+    if (S.first < std::abs(HelicityDifference) ||
+        MotherSpin < std::abs(HelicityDifference))
+      return false;
+    S.second = HelicityDifference;
+    if (IsZero(Daughter1, Daughter2, S))
+      return false;
+    return !IsZero(L, S, SpinPair(MotherSpin, HelicityDifference));
+  }
+
+private:
+  CoefficientCheck IsZero;
+};
+
+/// Opt-in variant, which rejects all couplings with a vanishing coefficient.
+class ExactClebschGordanCheckHelicityToCanonical
+    : public ClebschGordanCheckHelicityToCanonical {
+public:
+  ExactClebschGordanCheckHelicityToCanonical()
+      : ClebschGordanCheckHelicityToCanonical(
+            "ExactClebschGordanCheckHelicityToCanonical",
+            isExactClebschGordanCoefficientZero) {}
+};
+
+class HelicityConservation : public ConservationRule {
+public:
+  HelicityConservation() : ConservationRule("HelicityConservation") {
+    addRequiredQuantumNumber(QN::Spin, {Condition::DefinedForAllEdges});
+  }
+
+  /// \f$|\lambda_2-\lambda_3| \leq S_1\f$
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &) const override {
+    if (Ingoing.size() != 1 || Outgoing.size() != 2)
+      return false;
+    return Ingoing[0][QN::Spin].Value >=
+           std::abs(Outgoing[0][QN::Spin].Projection -
+                    Outgoing[1][QN::Spin].Projection);
+  }
+};
+
+class GellMannNishijimaRule : public ConservationRule {
+public:
+  GellMannNishijimaRule() : ConservationRule("GellMannNishijimaRule") {
+    addRequiredQuantumNumber(QN::Charge, {Condition::DefinedForAllEdges});
+    addRequiredQuantumNumber(QN::IsoSpin, {Condition::DefinedForAllEdges});
+    for (auto Name : {QN::Strangeness, QN::Charm, QN::Bottomness, QN::Topness,
+                      QN::BaryonNumber, QN::ElectronLN, QN::MuonLN, QN::TauLN})
+      addRequiredQuantumNumber(Name);
+  }
+
+  /// \f$Q = I_3 + \frac{Y}{2}\f$ for each particle, except for leptons.
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &) const override {
+    for (auto const *States : {&Ingoing, &Outgoing}) {
+      for (auto const &State : *States) {
+        if (!isCompatible(State))
+          return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  static int value(const QuantumNumbers &State, QuantumNumberName Name) {
+    return State.defined(Name) ? State[Name].Value : 0;
+  }
+
+  static bool isCompatible(const QuantumNumbers &State) {
+    if (std::abs(value(State, QN::ElectronLN)) +
+            std::abs(value(State, QN::MuonLN)) +
+            std::abs(value(State, QN::TauLN)) >
+        0)
+      return true;
+    int TwiceIsoSpinProjection =
+        State.defined(QN::IsoSpin) ? State[QN::IsoSpin].Projection : 0;
+    int HyperCharge = value(State, QN::Strangeness) +
+                      value(State, QN::Charm) + value(State, QN::Bottomness) +
+                      value(State, QN::Topness) +
+                      value(State, QN::BaryonNumber);
+    return 2 * value(State, QN::Charge) ==
+           TwiceIsoSpinProjection + HyperCharge;
+  }
+};
+
+class MassConservation : public ConservationRule {
+public:
+  explicit MassConservation(double WidthFactor)
+      : ConservationRule("MassConservation"), WidthFactor(WidthFactor) {
+    addRequiredQuantumNumber(QN::Mass, {Condition::DefinedForAllEdges});
+    addRequiredQuantumNumber(QN::Width);
+  }
+
+  /// \f$M_{out} - N \cdot W_{out} < M_{in} + N \cdot W_{in}\f$
+  bool check(const std::vector<QuantumNumbers> &Ingoing,
+             const std::vector<QuantumNumbers> &Outgoing,
+             const QuantumNumbers &) const override {
+    return sum(Outgoing, QN::Mass) - WidthFactor * sum(Outgoing, QN::Width) <
+           sum(Ingoing, QN::Mass) + WidthFactor * sum(Ingoing, QN::Width);
+  }
+
+private:
+  static double sum(const std::vector<QuantumNumbers> &States,
+                    QuantumNumberName Name) {
+    double Sum(0.0);
+    for (auto const &State : States) {
+      if (State.defined(Name))
+        Sum += State[Name].Real;
+    }
+    return Sum;
+  }
+
+  double WidthFactor;
+};
+
+} // namespace
+
+void ConservationRule::addRequiredQuantumNumber(
+    QuantumNumberName QuantumNumber, std::vector<Condition> Conditions,
+    QuantumNumberName Other) {
+  RequiredQuantumNumbers.push_back(QuantumNumber);
+  for (auto Type : Conditions)
+    Requirements.push_back(Requirement{QuantumNumber, Type, Other});
+}
+
+bool ConservationRule::checkRequirements(
+    const std::vector<QuantumNumbers> &Ingoing,
+    const std::vector<QuantumNumbers> &Outgoing,
+    const QuantumNumbers &Interaction) const {
+  auto HasForAll = [](const std::vector<QuantumNumbers> &States,
+                      QuantumNumberName Name) {
+    return std::all_of(
+        States.begin(), States.end(),
+        [Name](const QuantumNumbers &State) { return State.has(Name); });
+  };
+  // in contrast to the other conditions, undefined values do not count here
+  auto DefinedIfOtherNotDefined = [&Interaction](
+                                      const std::vector<QuantumNumbers> &States,
+                                      const Requirement &R) {
+    bool OtherDefined = isInteractionQuantumNumber(R.Other)
+                            ? Interaction.defined(R.Other)
+                            : definedForAll(States, R.Other);
+    if (OtherDefined)
+      return true;
+    return isInteractionQuantumNumber(R.QuantumNumber)
+               ? Interaction.defined(R.QuantumNumber)
+               : definedForAll(States, R.QuantumNumber);
+  };
+
+  for (auto const &R : Requirements) {
+    bool Met(true);
+    switch (R.Type) {
+    case Condition::DefinedForAllEdges:
+      Met = HasForAll(Ingoing, R.QuantumNumber) &&
+            HasForAll(Outgoing, R.QuantumNumber);
+      break;
+    case Condition::DefinedForAllOutgoingEdges:
+      Met = HasForAll(Outgoing, R.QuantumNumber);
+      break;
+    case Condition::DefinedForInteractionNode:
+      Met = Interaction.has(R.QuantumNumber);
+      break;
+    case Condition::DefinedIfOtherQnNotDefinedInOutSeperate:
+      Met = DefinedIfOtherNotDefined(Ingoing, R) &&
+            DefinedIfOtherNotDefined(Outgoing, R);
+      break;
+    }
+    if (!Met)
+      return false;
+  }
+  return true;
+}
+
+std::shared_ptr<ConservationRule>
+createConservationRule(const ConservationRuleSettings &Settings) {
+  auto const &Type = Settings.Type;
+  if (Type == "AdditiveQuantumNumberConservation")
+    return std::make_shared<AdditiveQuantumNumberConservation>(
+        quantumNumberName(Settings.QuantumNumber));
+  if (Type == "ParityConservation")
+    return std::make_shared<ParityConservation>();
+  if (Type == "ParityConservationHelicity")
+    return std::make_shared<ParityConservationHelicity>();
+  if (Type == "CParityConservation")
+    return std::make_shared<CParityConservation>();
+  if (Type == "GParityConservation")
+    return std::make_shared<GParityConservation>();
+  if (Type == "IdenticalParticleSymmetrization")
+    return std::make_shared<IdenticalParticleSymmetrization>();
+  if (Type == "SpinConservation")
+    return std::make_shared<SpinConservation>(
+        quantumNumberName(Settings.QuantumNumber), Settings.UseProjection);
+  if (Type == "ClebschGordanCheckHelicityToCanonical")
+    return std::make_shared<ClebschGordanCheckHelicityToCanonical>();
+  if (Type == "ExactClebschGordanCheckHelicityToCanonical")
+    return std::make_shared<ExactClebschGordanCheckHelicityToCanonical>();
+  if (Type == "HelicityConservation")
+    return std::make_shared<HelicityConservation>();
+  if (Type == "GellMannNishijimaRule")
+    return std::make_shared<GellMannNishijimaRule>();
+  if (Type == "MassConservation")
+    return std::make_shared<MassConservation>(Settings.WidthFactor);
+  throw ComPWA::BadParameter(
+      "PyComPWA::ExpertSystem::createConservationRule(): there is no native "
+      "implementation of " +
+      Type + "!");
+}
+
+const std::vector<std::string> &supportedConservationRules() {
+  static const std::vector<std::string> Rules = {
+      "AdditiveQuantumNumberConservation",
+      "ParityConservation",
+      "ParityConservationHelicity",
+      "CParityConservation",
+      "GParityConservation",
+      "IdenticalParticleSymmetrization",
+      "SpinConservation",
+      "ClebschGordanCheckHelicityToCanonical",
+      "ExactClebschGordanCheckHelicityToCanonical",
+      "HelicityConservation",
+      "GellMannNishijimaRule",
+      "MassConservation"};
+  return Rules;
+}
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
@@ -0,0 +1,96 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_EXPERTSYSTEM_CONSERVATIONRULES_HPP_
+#define PYCOMPWA_EXPERTSYSTEM_CONSERVATIONRULES_HPP_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PyComPWA/ExpertSystem/QuantumNumbers.hpp"
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+/// Conditions on the availability of quantum numbers, see the condition
+/// functors in conservationrules.py.
+enum class Condition {
+  DefinedForAllEdges,
+  DefinedForAllOutgoingEdges,
+  DefinedForInteractionNode,
+  /// Defined for all edges of the ingoing (outgoing) side, if the other
+  /// quantum number is not defined for all edges of this side.
+  DefinedIfOtherQnNotDefinedInOutSeperate
+};
+
+///
+/// \class ConservationRule
+/// Native implementation of the conservation rules of conservationrules.py,
+/// which work on integer encoded quantum numbers. As in python, a rule is
+/// only checked if its requirements on the availability of the quantum
+/// numbers are met.
+///
+class ConservationRule {
+public:
+  explicit ConservationRule(std::string Name) : Name(std::move(Name)) {}
+  virtual ~ConservationRule() = default;
+
+  const std::string &name() const { return Name; }
+
+  const std::vector<QuantumNumberName> &requiredQuantumNumbers() const {
+    return RequiredQuantumNumbers;
+  }
+
+  bool checkRequirements(const std::vector<QuantumNumbers> &Ingoing,
+                         const std::vector<QuantumNumbers> &Outgoing,
+                         const QuantumNumbers &Interaction) const;
+
+  virtual bool check(const std::vector<QuantumNumbers> &Ingoing,
+                     const std::vector<QuantumNumbers> &Outgoing,
+                     const QuantumNumbers &Interaction) const = 0;
+
+protected:
+  /// \p Other is only used by DefinedIfOtherQnNotDefinedInOutSeperate.
+  void addRequiredQuantumNumber(QuantumNumberName QuantumNumber,
+                                std::vector<Condition> Conditions = {},
+                                QuantumNumberName Other = {});
+
+private:
+  struct Requirement {
+    QuantumNumberName QuantumNumber;
+    Condition Type;
+    QuantumNumberName Other;
+  };
+
+  std::string Name;
+  std::vector<QuantumNumberName> RequiredQuantumNumbers;
+  std::vector<Requirement> Requirements;
+};
+
+/// Parameters of a rule, as given by the attributes of the python rule.
+struct ConservationRuleSettings {
+  /// Class name of the python rule, e.g. "AdditiveQuantumNumberConservation".
+  std::string Type;
+  /// Quantum number of AdditiveQuantumNumberConservation and
+  /// SpinConservation.
+  std::string QuantumNumber;
+  /// Only used by SpinConservation.
+  bool UseProjection = true;
+  /// Only used by MassConservation.
+  double WidthFactor = 3.0;
+};
+
+/// Throws if there is no native implementation of the rule.
+std::shared_ptr<ConservationRule>
+createConservationRule(const ConservationRuleSettings &Settings);
+
+/// Class names of the python rules which have a native implementation.
+const std::vector<std::string> &supportedConservationRules();
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,133 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+
+#include "PyComPWA/ExpertSystem/GraphFingerprint.hpp"
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+namespace {
+
+/// Two independent 64 bit FNV-1a hashes, finalized with the mixing function
+/// of splitmix64.
+class FingerprintHasher {
+public:
+  void add(const std::string &Bytes) {
+    // the length separates consecutive strings
+    add(static_cast<std::uint64_t>(Bytes.size()));
+    for (unsigned char c : Bytes)
+      addByte(c);
+  }
+
+  void add(std::uint64_t Value) {
+    for (int i = 0; i < 8; ++i)
+      addByte(static_cast<unsigned char>(Value >> (8 * i)));
+  }
+
+  GraphFingerprint fingerprint() const { return {mix(High), mix(Low)}; }
+
+private:
+  void addByte(unsigned char c) {
+    High = (High ^ c) * 0x100000001b3ULL;
+    Low = (Low ^ c) * 0x100000001b3ULL;
+    Low ^= Low >> 29;
+  }
+
+  static std::uint64_t mix(std::uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  std::uint64_t High = 0xcbf29ce484222325ULL;
+  std::uint64_t Low = 0x84222325cbf29ce4ULL;
+};
+
+template <typename T>
+std::vector<const T *> sortedById(const std::vector<T> &x) {
+  std::vector<const T *> Sorted;
+  for (auto const &Element : x)
+    Sorted.push_back(&Element);
+  std::sort(Sorted.begin(), Sorted.end(),
+            [](const T *a, const T *b) { return a->Id < b->Id; });
+  return Sorted;
+}
+
+} // namespace
+
+GraphFingerprinter::GraphFingerprinter(
+    std::vector<std::string> IgnoredQuantumNumbers)
+    : IgnoredQuantumNumbers(IgnoredQuantumNumbers.begin(),
+                            IgnoredQuantumNumbers.end()) {}
+
+GraphFingerprint GraphFingerprinter::operator()(
+    const std::vector<int> &Nodes, const std::vector<GraphEdge> &Edges,
+    const std::vector<GraphElementProperties> &NodeProperties,
+    const std::vector<GraphElementProperties> &EdgeProperties) const {
+  FingerprintHasher Hasher;
+  std::vector<int> SortedNodes(Nodes);
+  std::sort(SortedNodes.begin(), SortedNodes.end());
+  SortedNodes.erase(std::unique(SortedNodes.begin(), SortedNodes.end()),
+                    SortedNodes.end());
+  Hasher.add(SortedNodes.size());
+  for (auto Node : SortedNodes)
+    Hasher.add(static_cast<std::uint64_t>(Node));
+  Hasher.add(Edges.size());
+  for (auto Edge : sortedById(Edges)) {
+    Hasher.add(static_cast<std::uint64_t>(Edge->Id));
+    Hasher.add(static_cast<std::uint64_t>(Edge->OriginatingNode));
+    Hasher.add(static_cast<std::uint64_t>(Edge->EndingNode));
+  }
+
+  auto AddProperties = [this, &Hasher](
+                           const std::vector<GraphElementProperties> &x) {
+    Hasher.add(x.size());
+    for (auto Element : sortedById(x)) {
+      Hasher.add(static_cast<std::uint64_t>(Element->Id));
+      auto Properties = Element->Properties;
+      std::sort(Properties.begin(), Properties.end());
+      Hasher.add(Properties.size());
+      for (auto const &Property : Properties) {
+        Hasher.add(Property.first);
+        Hasher.add(Property.second);
+      }
+
+      // the last quantum number of each type is kept, in the order of types
+      std::vector<std::pair<std::string,
+                            std::vector<std::pair<std::string, std::string>>>>
+          QuantumNumbers;
+      for (auto it = Element->QuantumNumbers.rbegin();
+           it != Element->QuantumNumbers.rend(); ++it) {
+        if (IgnoredQuantumNumbers.count(it->first))
+          continue;
+        auto Found = std::find_if(
+            QuantumNumbers.begin(), QuantumNumbers.end(),
+            [&it](const decltype(QuantumNumbers)::value_type &QuantumNumber) {
+              return QuantumNumber.first == it->first;
+            });
+        if (Found == QuantumNumbers.end())
+          QuantumNumbers.push_back(*it);
+      }
+      std::sort(QuantumNumbers.begin(), QuantumNumbers.end());
+      Hasher.add(QuantumNumbers.size());
+      for (auto &QuantumNumber : QuantumNumbers) {
+        Hasher.add(QuantumNumber.first);
+        std::sort(QuantumNumber.second.begin(), QuantumNumber.second.end());
+        Hasher.add(QuantumNumber.second.size());
+        for (auto const &Attribute : QuantumNumber.second) {
+          Hasher.add(Attribute.first);
+          Hasher.add(Attribute.second);
+        }
+      }
+    }
+  };
+  AddProperties(NodeProperties);
+  AddProperties(EdgeProperties);
+  return Hasher.fingerprint();
+}
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
@@ -0,0 +1,74 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_EXPERTSYSTEM_GRAPHFINGERPRINT_HPP_
+#define PYCOMPWA_EXPERTSYSTEM_GRAPHFINGERPRINT_HPP_
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+/// Properties of a node or an edge of a StateTransitionGraph.
+struct GraphElementProperties {
+  int Id = 0;
+  /// Type of each quantum number and its other attributes, e.g. ("Spin",
+  /// {("@Value", "1.0"), ("@Projection", "0.0")}). As in the python graph
+  /// comparison, only the last entry of a type counts.
+  std::vector<std::pair<std::string,
+                        std::vector<std::pair<std::string, std::string>>>>
+      QuantumNumbers;
+  /// All other properties with their serialized values.
+  std::vector<std::pair<std::string, std::string>> Properties;
+};
+
+/// Topology of an edge, negative node ids stand for unconnected ends.
+struct GraphEdge {
+  int Id = 0;
+  int OriginatingNode = -1;
+  int EndingNode = -1;
+};
+
+struct GraphFingerprint {
+  std::uint64_t High = 0;
+  std::uint64_t Low = 0;
+};
+
+inline bool operator==(const GraphFingerprint &lhs,
+                       const GraphFingerprint &rhs) {
+  return lhs.High == rhs.High && lhs.Low == rhs.Low;
+}
+
+///
+/// \class GraphFingerprinter
+/// 128 bit fingerprint of a state transition graph, which is independent of
+/// the order of the nodes, edges, properties and quantum numbers. Graphs
+/// which are equal in the sense of CompareGraphElementPropertiesFunctor,
+/// ignoring the given quantum numbers, have the same fingerprint. Hence,
+/// duplicate graphs can be found with a hash set instead of comparing all
+/// pairs of graphs.
+///
+class GraphFingerprinter {
+public:
+  explicit GraphFingerprinter(
+      std::vector<std::string> IgnoredQuantumNumbers = {});
+
+  GraphFingerprint
+  operator()(const std::vector<int> &Nodes,
+             const std::vector<GraphEdge> &Edges,
+             const std::vector<GraphElementProperties> &NodeProperties,
+             const std::vector<GraphElementProperties> &EdgeProperties) const;
+
+private:
+  std::set<std::string> IgnoredQuantumNumbers;
+};
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
+
+#endif
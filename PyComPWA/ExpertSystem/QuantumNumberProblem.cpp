@@ -0,0 +1,319 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <deque>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/ExpertSystem/QuantumNumberProblem.hpp"
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+namespace {
+/// Constraints with more combinations of the values of their variables are
+/// left to the forward checking of the search.
+const std::size_t MaximalArcConsistencyCombinations = 1 << 17;
+} // namespace
+
+std::size_t
+QuantumNumberProblem::addVariable(std::vector<QuantumNumberValue> Domain) {
+  // an assigned variable is always part of the state, even without value
+  for (auto &Value : Domain)
+    Value.Present = true;
+  Domains.push_back(std::move(Domain));
+  VariableConstraints.emplace_back();
+  return Domains.size() - 1;
+}
+
+void QuantumNumberProblem::addConstraint(
+    std::shared_ptr<const ConservationRule> Rule,
+    std::vector<ConstraintState> Ingoing, std::vector<ConstraintState> Outgoing,
+    ConstraintState Interaction) {
+  if (!Rule)
+    throw ComPWA::BadParameter(
+        "PyComPWA::ExpertSystem::QuantumNumberProblem::addConstraint(): "
+        "no rule given!");
+  Constraint C;
+  C.Rule = std::move(Rule);
+  C.Ingoing.resize(Ingoing.size());
+  C.Outgoing.resize(Outgoing.size());
+
+  auto AddState = [this, &C](const ConstraintState &State,
+                             std::size_t StateIndex, QuantumNumbers &Target) {
+    for (auto const &Fixed : State.FixedValues) {
+      Target[Fixed.first] = Fixed.second;
+      Target[Fixed.first].Present = true;
+    }
+    for (auto const &Variable : State.Variables) {
+      if (Variable.second >= Domains.size())
+        throw ComPWA::BadParameter(
+            "PyComPWA::ExpertSystem::QuantumNumberProblem::addConstraint(): "
+            "unknown variable!");
+      C.Slots.push_back(Constraint::Slot{StateIndex, Variable.first,
+                                         Variable.second});
+      C.Variables.push_back(Variable.second);
+    }
+  };
+  for (std::size_t i = 0; i < Ingoing.size(); ++i)
+    AddState(Ingoing[i], i, C.Ingoing[i]);
+  for (std::size_t i = 0; i < Outgoing.size(); ++i)
+    AddState(Outgoing[i], Ingoing.size() + i, C.Outgoing[i]);
+  AddState(Interaction, Ingoing.size() + Outgoing.size(), C.Interaction);
+
+  std::sort(C.Variables.begin(), C.Variables.end());
+  C.Variables.erase(std::unique(C.Variables.begin(), C.Variables.end()),
+                    C.Variables.end());
+  for (auto Variable : C.Variables)
+    VariableConstraints[Variable].push_back(Constraints.size());
+  C.Statistics.ConditionsNeverMet = C.Variables.empty();
+  Constraints.push_back(std::move(C));
+}
+
+std::vector<ConstraintStatistics> QuantumNumberProblem::statistics() const {
+  std::vector<ConstraintStatistics> Statistics;
+  Statistics.reserve(Constraints.size());
+  for (auto const &C : Constraints)
+    Statistics.push_back(C.Statistics);
+  return Statistics;
+}
+
+void QuantumNumberProblem::resetStatistics() {
+  for (auto &C : Constraints) {
+    C.Statistics = ConstraintStatistics();
+    C.Statistics.ConditionsNeverMet = C.Variables.empty();
+  }
+}
+
+bool QuantumNumberProblem::evaluate(Constraint &C,
+                                    const std::vector<std::size_t> &Values) {
+  std::size_t NumberOfIngoing = C.Ingoing.size();
+  std::size_t NumberOfOutgoing = C.Outgoing.size();
+  for (auto const &Slot : C.Slots) {
+    QuantumNumbers &State =
+        Slot.State < NumberOfIngoing
+            ? C.Ingoing[Slot.State]
+            : (Slot.State < NumberOfIngoing + NumberOfOutgoing
+                   ? C.Outgoing[Slot.State - NumberOfIngoing]
+                   : C.Interaction);
+    State[Slot.Name] = Domains[Slot.Variable][Values[Slot.Variable]];
+  }
+  if (!C.Rule->checkRequirements(C.Ingoing, C.Outgoing, C.Interaction)) {
+    // the rule has to be validated later on
+    C.Statistics.ConditionsNeverMet = true;
+    return true;
+  }
+  bool Passed = C.Rule->check(C.Ingoing, C.Outgoing, C.Interaction);
+  if (Passed)
+    ++C.Statistics.Passed;
+  else
+    ++C.Statistics.Failed;
+  return Passed;
+}
+
+bool QuantumNumberProblem::makeArcConsistent(
+    std::vector<std::vector<std::size_t>> &LiveDomains) {
+  std::vector<std::size_t> Values(Domains.size(), 0);
+  std::deque<std::size_t> Queue;
+  std::vector<bool> Queued(Constraints.size(), true);
+  for (std::size_t c = 0; c < Constraints.size(); ++c)
+    Queue.push_back(c);
+
+  while (!Queue.empty()) {
+    std::size_t c = Queue.front();
+    Queue.pop_front();
+    Queued[c] = false;
+    Constraint &C = Constraints[c];
+    if (C.Variables.empty())
+      continue;
+    std::size_t NumberOfCombinations(1);
+    for (auto Variable : C.Variables) {
+      NumberOfCombinations *= LiveDomains[Variable].size();
+      if (NumberOfCombinations > MaximalArcConsistencyCombinations)
+        break;
+    }
+    if (NumberOfCombinations == 0)
+      return false;
+    if (NumberOfCombinations > MaximalArcConsistencyCombinations)
+      continue;
+
+    // all combinations are checked once, and each value which is part of a
+    // valid combination is supported
+    std::size_t NumberOfVariables = C.Variables.size();
+    std::vector<std::size_t> Positions(NumberOfVariables, 0);
+    std::vector<std::vector<bool>> Supported(NumberOfVariables);
+    for (std::size_t k = 0; k < NumberOfVariables; ++k)
+      Supported[k].assign(LiveDomains[C.Variables[k]].size(), false);
+    for (std::size_t n = 0; n < NumberOfCombinations; ++n) {
+      for (std::size_t k = 0; k < NumberOfVariables; ++k)
+        Values[C.Variables[k]] = LiveDomains[C.Variables[k]][Positions[k]];
+      if (evaluate(C, Values)) {
+        for (std::size_t k = 0; k < NumberOfVariables; ++k)
+          Supported[k][Positions[k]] = true;
+      }
+      for (std::size_t k = 0; k < NumberOfVariables; ++k) {
+        if (++Positions[k] < LiveDomains[C.Variables[k]].size())
+          break;
+        Positions[k] = 0;
+      }
+    }
+
+    for (std::size_t k = 0; k < NumberOfVariables; ++k) {
+      std::size_t Variable = C.Variables[k];
+      auto &Domain = LiveDomains[Variable];
+      std::vector<std::size_t> Reduced;
+      for (std::size_t i = 0; i < Domain.size(); ++i) {
+        if (Supported[k][i])
+          Reduced.push_back(Domain[i]);
+      }
+      if (Reduced.size() == Domain.size())
+        continue;
+      if (Reduced.empty())
+        return false;
+      Domain = std::move(Reduced);
+      for (auto Other : VariableConstraints[Variable]) {
+        if (Other != c && !Queued[Other]) {
+          Queued[Other] = true;
+          Queue.push_back(Other);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void QuantumNumberProblem::search(
+    std::vector<std::vector<std::size_t>> &LiveDomains,
+    std::vector<std::size_t> &Values, std::vector<bool> &Assigned,
+    std::size_t NumberOfAssigned,
+    std::vector<std::vector<std::size_t>> &Solutions) {
+  if (NumberOfAssigned == Domains.size()) {
+    Solutions.push_back(Values);
+    return;
+  }
+  // the variable with the fewest values left is assigned first
+  std::size_t Variable = Domains.size();
+  for (std::size_t v = 0; v < Domains.size(); ++v) {
+    if (Assigned[v])
+      continue;
+    if (Variable == Domains.size() ||
+        LiveDomains[v].size() < LiveDomains[Variable].size() ||
+        (LiveDomains[v].size() == LiveDomains[Variable].size() &&
+         VariableConstraints[v].size() > VariableConstraints[Variable].size()))
+      Variable = v;
+  }
+
+  Assigned[Variable] = true;
+  auto Candidates = LiveDomains[Variable];
+  for (auto Value : Candidates) {
+    Values[Variable] = Value;
+    // forward checking: reduce the domains of variables which are the last
+    // unassigned variable of a constraint
+    std::vector<std::pair<std::size_t, std::vector<std::size_t>>> Removed;
+    bool Consistent(true);
+    for (auto c : VariableConstraints[Variable]) {
+      Constraint &C = Constraints[c];
+      std::size_t NumberOfUnassigned(0), Unassigned(0);
+      for (auto v : C.Variables) {
+        if (!Assigned[v]) {
+          ++NumberOfUnassigned;
+          Unassigned = v;
+        }
+      }
+      if (NumberOfUnassigned == 0) {
+        Consistent = evaluate(C, Values);
+      } else if (NumberOfUnassigned == 1) {
+        std::vector<std::size_t> Reduced;
+        for (auto x : LiveDomains[Unassigned]) {
+          Values[Unassigned] = x;
+          if (evaluate(C, Values))
+            Reduced.push_back(x);
+        }
+        if (Reduced.size() != LiveDomains[Unassigned].size()) {
+          Removed.emplace_back(Unassigned, std::move(LiveDomains[Unassigned]));
+          LiveDomains[Unassigned] = std::move(Reduced);
+        }
+        Consistent = !LiveDomains[Unassigned].empty();
+      }
+      if (!Consistent)
+        break;
+    }
+    if (Consistent)
+      search(LiveDomains, Values, Assigned, NumberOfAssigned + 1, Solutions);
+    for (auto it = Removed.rbegin(); it != Removed.rend(); ++it)
+      LiveDomains[it->first] = std::move(it->second);
+  }
+  Assigned[Variable] = false;
+}
+
+std::vector<std::vector<std::size_t>> QuantumNumberProblem::solve() {
+  auto Solutions = findSolutions();
+  LOG(DEBUG) << "QuantumNumberProblem::solve(): found " << Solutions.size()
+             << " solutions for " << Domains.size() << " variables and "
+             << Constraints.size() << " constraints";
+  return Solutions;
+}
+
+std::vector<std::vector<std::size_t>> QuantumNumberProblem::findSolutions() {
+  resetStatistics();
+  // as for python-constraint, a problem without variables has no solutions
+  std::vector<std::vector<std::size_t>> Solutions;
+  if (Domains.empty())
+    return Solutions;
+  std::vector<std::vector<std::size_t>> LiveDomains(Domains.size());
+  for (std::size_t v = 0; v < Domains.size(); ++v) {
+    if (Domains[v].empty())
+      return Solutions;
+    LiveDomains[v].resize(Domains[v].size());
+    for (std::size_t i = 0; i < Domains[v].size(); ++i)
+      LiveDomains[v][i] = i;
+  }
+  if (!makeArcConsistent(LiveDomains))
+    return Solutions;
+
+  std::vector<std::size_t> Values(Domains.size(), 0);
+  std::vector<bool> Assigned(Domains.size(), false);
+  search(LiveDomains, Values, Assigned, 0, Solutions);
+  return Solutions;
+}
+
+std::vector<std::vector<std::vector<std::size_t>>>
+solveQuantumNumberProblems(const std::vector<QuantumNumberProblem *> &Problems,
+                           int NumberOfThreads) {
+  for (auto Problem : Problems) {
+    if (!Problem)
+      throw ComPWA::BadParameter(
+          "PyComPWA::ExpertSystem::solveQuantumNumberProblems(): "
+          "no problem given!");
+  }
+#ifdef _OPENMP
+  if (NumberOfThreads <= 0)
+    NumberOfThreads = omp_get_max_threads();
+#else
+  NumberOfThreads = 1;
+#endif
+  std::vector<std::vector<std::vector<std::size_t>>> Solutions(
+      Problems.size());
+  long NumberOfProblems = Problems.size();
+#pragma omp parallel for schedule(dynamic, 1) num_threads(NumberOfThreads)
+  for (long i = 0; i < NumberOfProblems; ++i)
+    Solutions[i] = Problems[i]->findSolutions();
+
+  std::size_t NumberOfSolutions(0);
+  for (auto const &x : Solutions)
+    NumberOfSolutions += x.size();
+  LOG(DEBUG) << "solveQuantumNumberProblems(): found " << NumberOfSolutions
+             << " solutions for " << Problems.size() << " problems with "
+             << NumberOfThreads << " threads";
+  return Solutions;
+}
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
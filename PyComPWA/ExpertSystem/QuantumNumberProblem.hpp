@@ -0,0 +1,132 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_EXPERTSYSTEM_QUANTUMNUMBERPROBLEM_HPP_
+#define PYCOMPWA_EXPERTSYSTEM_QUANTUMNUMBERPROBLEM_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "PyComPWA/ExpertSystem/ConservationRules.hpp"
+#include "PyComPWA/ExpertSystem/QuantumNumbers.hpp"
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+/// Quantum numbers of an edge or the interaction node entering a constraint.
+/// Fixed values are known beforehand, e.g. the quantum numbers of the initial
+/// and final state particles. The others are variables of the problem.
+struct ConstraintState {
+  std::vector<std::pair<QuantumNumberName, QuantumNumberValue>> FixedValues;
+  /// Quantum numbers and the indices of their variables.
+  std::vector<std::pair<QuantumNumberName, std::size_t>> Variables;
+};
+
+/// Outcome of all checks of a constraint during the search, see
+/// ConservationLawConstraintWrapper in propagation.py.
+struct ConstraintStatistics {
+  std::size_t Failed = 0;
+  std::size_t Passed = 0;
+  /// True if the requirements of the rule were not met for some assignment,
+  /// or if the constraint has no variables at all.
+  bool ConditionsNeverMet = false;
+};
+
+///
+/// \class QuantumNumberProblem
+/// Constraint satisfaction problem of the quantum number propagation through
+/// a state transition graph, the native counterpart of the CSPPropagator.
+/// The variables are the quantum numbers of the intermediate edges and of
+/// the interaction nodes. Each conservation rule at a node is a constraint
+/// on the variables of the edges of that node.
+///
+/// A constraint is checked for every complete assignment of its variables
+/// for which the requirements of its rule are met. All solutions are found by
+/// a backtracking search with forward checking, after the domains have been
+/// reduced to arc consistency.
+///
+/// The statistics of a solve() are deterministic. Reducing the domains checks
+/// all value combinations of each constraint up to a size limit, so such a
+/// constraint that never passed is violated by all values left at that
+/// point. These rules are reported as violated if there are no solutions.
+///
+class QuantumNumberProblem {
+public:
+  /// Returns the index of the new variable.
+  std::size_t addVariable(std::vector<QuantumNumberValue> Domain);
+
+  void addConstraint(std::shared_ptr<const ConservationRule> Rule,
+                     std::vector<ConstraintState> Ingoing,
+                     std::vector<ConstraintState> Outgoing,
+                     ConstraintState Interaction);
+
+  std::size_t numberOfVariables() const { return Domains.size(); }
+  std::size_t numberOfConstraints() const { return Constraints.size(); }
+
+  /// All solutions as the indices of the values in the variable domains.
+  std::vector<std::vector<std::size_t>> solve();
+
+  /// Statistics of each constraint of the last solve().
+  std::vector<ConstraintStatistics> statistics() const;
+
+  friend std::vector<std::vector<std::vector<std::size_t>>>
+  solveQuantumNumberProblems(
+      const std::vector<QuantumNumberProblem *> &Problems,
+      int NumberOfThreads);
+
+private:
+  struct Constraint {
+    std::shared_ptr<const ConservationRule> Rule;
+    std::vector<QuantumNumbers> Ingoing;
+    std::vector<QuantumNumbers> Outgoing;
+    QuantumNumbers Interaction;
+    /// Variables and the quantum numbers they are assigned to. State
+    /// indices below Ingoing.size() refer to the ingoing edges, followed by
+    /// the outgoing edges and the interaction node.
+    struct Slot {
+      std::size_t State;
+      QuantumNumberName Name;
+      std::size_t Variable;
+    };
+    std::vector<Slot> Slots;
+    /// Distinct variables of the slots.
+    std::vector<std::size_t> Variables;
+    ConstraintStatistics Statistics;
+  };
+
+  std::vector<std::vector<std::size_t>> findSolutions();
+
+  void resetStatistics();
+
+  /// Checks a constraint with the current values of its variables.
+  bool evaluate(Constraint &C, const std::vector<std::size_t> &Values);
+
+  bool makeArcConsistent(std::vector<std::vector<std::size_t>> &LiveDomains);
+
+  void search(std::vector<std::vector<std::size_t>> &LiveDomains,
+              std::vector<std::size_t> &Values, std::vector<bool> &Assigned,
+              std::size_t NumberOfAssigned,
+              std::vector<std::vector<std::size_t>> &Solutions);
+
+  std::vector<std::vector<QuantumNumberValue>> Domains;
+  std::vector<Constraint> Constraints;
+  /// Constraints of each variable.
+  std::vector<std::vector<std::size_t>> VariableConstraints;
+};
+
+/// Solves independent problems, e.g. for all graphs and interaction settings
+/// of a StateTransitionManager, on a thread pool. The sizes of the problems
+/// differ a lot, hence they are handed out one by one to idle threads. The
+/// rules can be shared between the problems. All threads are used if
+/// \p NumberOfThreads is not positive.
+std::vector<std::vector<std::vector<std::size_t>>>
+solveQuantumNumberProblems(const std::vector<QuantumNumberProblem *> &Problems,
+                           int NumberOfThreads = 0);
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,45 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <vector>
+
+#include "Core/Exceptions.hpp"
+
+#include "PyComPWA/ExpertSystem/QuantumNumbers.hpp"
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+namespace {
+
+/// In the order of the QuantumNumberName enum.
+const std::vector<std::string> &quantumNumberNames() {
+  static const std::vector<std::string> Names = {
+      "Charge",     "Spin",        "Parity",       "Cparity",
+      "Gparity",    "IsoSpin",     "Strangeness",  "Charm",
+      "Bottomness", "Topness",     "BaryonNumber", "ElectronLN",
+      "MuonLN",     "TauLN",       "Pid",          "Mass",
+      "Width",      "L",           "S",            "ParityPrefactor"};
+  return Names;
+}
+
+} // namespace
+
+QuantumNumberName quantumNumberName(const std::string &Name) {
+  auto const &Names = quantumNumberNames();
+  auto it = std::find(Names.begin(), Names.end(), Name);
+  if (it == Names.end())
+    throw ComPWA::BadParameter(
+        "PyComPWA::ExpertSystem::quantumNumberName(): unknown quantum number " +
+        Name + "!");
+  return static_cast<QuantumNumberName>(std::distance(Names.begin(), it));
+}
+
+const std::string &quantumNumberNameString(QuantumNumberName Name) {
+  return quantumNumberNames()[static_cast<std::size_t>(Name)];
+}
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
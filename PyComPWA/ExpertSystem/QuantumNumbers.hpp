@@ -0,0 +1,100 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_EXPERTSYSTEM_QUANTUMNUMBERS_HPP_
+#define PYCOMPWA_EXPERTSYSTEM_QUANTUMNUMBERS_HPP_
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+/// Quantum numbers and particle properties used by the conservation rules.
+/// The names are those of the python enums StateQuantumNumberNames,
+/// ParticlePropertyNames, ParticleDecayPropertyNames and
+/// InteractionQuantumNumberNames.
+enum class QuantumNumberName : std::size_t {
+  Charge,
+  Spin,
+  Parity,
+  Cparity,
+  Gparity,
+  IsoSpin,
+  Strangeness,
+  Charm,
+  Bottomness,
+  Topness,
+  BaryonNumber,
+  ElectronLN,
+  MuonLN,
+  TauLN,
+  Pid,
+  Mass,
+  Width,
+  L,
+  S,
+  ParityPrefactor
+};
+
+constexpr std::size_t NumberOfQuantumNumberNames = 20;
+
+/// Throws if \p Name is not a known quantum number.
+QuantumNumberName quantumNumberName(const std::string &Name);
+
+const std::string &quantumNumberNameString(QuantumNumberName Name);
+
+///
+/// \struct QuantumNumberValue
+/// Integer encoded value of a quantum number, so that all comparisons are
+/// exact. Spin-like quantum numbers store twice their magnitude in Value and
+/// twice their projection in Projection. Masses and widths are stored in Real.
+///
+struct QuantumNumberValue {
+  /// False if the quantum number is not part of the state.
+  bool Present = false;
+  /// False if the quantum number is part of the state, but has no value
+  /// (None in python).
+  bool Defined = false;
+  int Value = 0;
+  int Projection = 0;
+  double Real = 0.0;
+
+  /// Spin-like values are equal if magnitude and projection are equal.
+  bool operator==(const QuantumNumberValue &Other) const {
+    return Defined == Other.Defined && Value == Other.Value &&
+           Projection == Other.Projection && Real == Other.Real;
+  }
+  bool operator!=(const QuantumNumberValue &Other) const {
+    return !(*this == Other);
+  }
+};
+
+/// Quantum numbers of an edge (particle) or an interaction node.
+class QuantumNumbers {
+public:
+  QuantumNumberValue &operator[](QuantumNumberName Name) {
+    return Values[static_cast<std::size_t>(Name)];
+  }
+  const QuantumNumberValue &operator[](QuantumNumberName Name) const {
+    return Values[static_cast<std::size_t>(Name)];
+  }
+
+  /// True if \p Name is part of the state (even without value).
+  bool has(QuantumNumberName Name) const { return (*this)[Name].Present; }
+
+  /// True if \p Name is part of the state and has a value.
+  bool defined(QuantumNumberName Name) const {
+    return (*this)[Name].Present && (*this)[Name].Defined;
+  }
+
+private:
+  std::array<QuantumNumberValue, NumberOfQuantumNumberNames> Values;
+};
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
+
+#endif
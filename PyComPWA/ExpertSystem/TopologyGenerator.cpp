@@ -0,0 +1,207 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <set>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/ExpertSystem/TopologyGenerator.hpp"
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+namespace {
+
+std::size_t numberOfColors(std::vector<int> Colors) {
+  std::sort(Colors.begin(), Colors.end());
+  return std::distance(Colors.begin(),
+                       std::unique(Colors.begin(), Colors.end()));
+}
+
+/// Color refinement of the nodes: nodes keep the same color only if they
+/// have the same number of edges to and from each color. The colors are
+/// ranks, hence they only depend on the structure of the graph.
+std::vector<int> refine(const Topology &Graph, std::vector<int> Colors) {
+  std::size_t NumberOfColors = numberOfColors(Colors);
+  while (true) {
+    std::vector<std::vector<int>> Signatures(Graph.NumberOfNodes);
+    for (std::size_t Node = 0; Node < Graph.NumberOfNodes; ++Node)
+      Signatures[Node].push_back(Colors[Node]);
+    for (auto const &Edge : Graph.Edges) {
+      // edges to the initial or final state are marked by zero
+      if (Edge.EndingNode >= 0)
+        Signatures[Edge.EndingNode].push_back(
+            2 * (Edge.OriginatingNode >= 0 ? Colors[Edge.OriginatingNode] + 1
+                                           : 0));
+      if (Edge.OriginatingNode >= 0)
+        Signatures[Edge.OriginatingNode].push_back(
+            2 * (Edge.EndingNode >= 0 ? Colors[Edge.EndingNode] + 1 : 0) +
+            1);
+    }
+    for (auto &x : Signatures)
+      std::sort(x.begin() + 1, x.end());
+
+    auto Sorted = Signatures;
+    std::sort(Sorted.begin(), Sorted.end());
+    Sorted.erase(std::unique(Sorted.begin(), Sorted.end()), Sorted.end());
+    for (std::size_t Node = 0; Node < Graph.NumberOfNodes; ++Node)
+      Colors[Node] = std::distance(
+          Sorted.begin(),
+          std::lower_bound(Sorted.begin(), Sorted.end(), Signatures[Node]));
+    // the signatures start with the old color, so the partition can only
+    // become finer
+    if (Sorted.size() == NumberOfColors)
+      return Colors;
+    NumberOfColors = Sorted.size();
+  }
+}
+
+/// Individualizes each node of the first non-trivial color class in turn,
+/// until all nodes have distinct colors which then define the labeling.
+void searchCanonicalForm(const Topology &Graph, std::vector<int> Colors,
+                         std::vector<std::pair<int, int>> &Best,
+                         bool &Found) {
+  Colors = refine(Graph, Colors);
+  std::vector<std::size_t> Counts(Graph.NumberOfNodes, 0);
+  for (auto x : Colors)
+    ++Counts[x];
+  auto Cell = std::find_if(Counts.begin(), Counts.end(),
+                           [](std::size_t x) { return x > 1; });
+  if (Cell == Counts.end()) {
+    std::vector<std::pair<int, int>> Form;
+    for (auto const &Edge : Graph.Edges)
+      Form.emplace_back(
+          Edge.OriginatingNode >= 0 ? Colors[Edge.OriginatingNode] : -1,
+          Edge.EndingNode >= 0 ? Colors[Edge.EndingNode] : -1);
+    std::sort(Form.begin(), Form.end());
+    if (!Found || Form < Best) {
+      Best = Form;
+      Found = true;
+    }
+    return;
+  }
+  int CellColor = std::distance(Counts.begin(), Cell);
+  for (std::size_t Node = 0; Node < Graph.NumberOfNodes; ++Node) {
+    if (Colors[Node] != CellColor)
+      continue;
+    std::vector<int> Individualized(Colors);
+    for (std::size_t Other = 0; Other < Graph.NumberOfNodes; ++Other)
+      Individualized[Other] =
+          2 * Colors[Other] + (Colors[Other] == CellColor && Other != Node);
+    searchCanonicalForm(Graph, Individualized, Best, Found);
+  }
+}
+
+} // namespace
+
+std::vector<std::pair<int, int>> canonicalForm(const Topology &Graph) {
+  std::vector<std::pair<int, int>> Form;
+  bool Found = false;
+  searchCanonicalForm(Graph, std::vector<int>(Graph.NumberOfNodes, 0), Form,
+                      Found);
+  return Form;
+}
+
+TopologyGenerator::TopologyGenerator(std::vector<InteractionNodeType> Types)
+    : NodeTypes(std::move(Types)) {
+  for (auto const &x : NodeTypes)
+    if (x.NumberOfIngoingEdges < 1 || x.NumberOfOutgoingEdges < 1)
+      throw ComPWA::BadParameter(
+          "PyComPWA::ExpertSystem::TopologyGenerator::TopologyGenerator(): "
+          "interaction nodes need ingoing and outgoing edges!");
+}
+
+const std::vector<Topology> &
+TopologyGenerator::generate(std::size_t NumberOfInitialEdges,
+                            std::size_t NumberOfFinalEdges) {
+  auto Key = std::make_pair(NumberOfInitialEdges, NumberOfFinalEdges);
+  auto Found = Topologies.find(Key);
+  if (Found == Topologies.end())
+    Found =
+        Topologies
+            .emplace(Key, grow(NumberOfInitialEdges, NumberOfFinalEdges))
+            .first;
+  return Found->second;
+}
+
+std::vector<Topology>
+TopologyGenerator::grow(std::size_t NumberOfInitialEdges,
+                        std::size_t NumberOfFinalEdges) const {
+  if (NumberOfInitialEdges < 1 || NumberOfFinalEdges < 1)
+    throw ComPWA::BadParameter(
+        "PyComPWA::ExpertSystem::TopologyGenerator::grow(): number of initial "
+        "and final state edges has to be larger than 0!");
+  std::size_t MaximumNumberOfNodes =
+      std::max<std::size_t>(1, NumberOfInitialEdges + NumberOfFinalEdges - 2);
+
+  std::vector<Topology> Results;
+  std::vector<Topology> Graphs(1);
+  Graphs.front().Edges.resize(NumberOfInitialEdges);
+  while (!Graphs.empty()) {
+    std::vector<Topology> ExtendedGraphs;
+    std::set<std::vector<std::pair<int, int>>> CanonicalForms;
+    for (auto const &Graph : Graphs) {
+      std::vector<std::size_t> OpenEdges;
+      for (std::size_t i = 0; i < Graph.Edges.size(); ++i)
+        if (Graph.Edges[i].EndingNode < 0)
+          OpenEdges.push_back(i);
+      if (OpenEdges.size() == NumberOfFinalEdges && Graph.NumberOfNodes > 0) {
+        Results.push_back(Graph);
+        continue;
+      }
+      if (Graph.NumberOfNodes == MaximumNumberOfNodes)
+        continue;
+
+      int NewNode = Graph.NumberOfNodes;
+      for (auto const &Type : NodeTypes) {
+        std::size_t k = Type.NumberOfIngoingEdges;
+        if (k > OpenEdges.size())
+          continue;
+        // open edges from the same nodes lead to isomorphic graphs
+        std::set<std::vector<int>> OriginatingNodes;
+        std::vector<std::size_t> Combination(k);
+        for (std::size_t i = 0; i < k; ++i)
+          Combination[i] = i;
+        while (true) {
+          std::vector<int> Origins;
+          for (auto i : Combination)
+            Origins.push_back(Graph.Edges[OpenEdges[i]].OriginatingNode);
+          std::sort(Origins.begin(), Origins.end());
+          if (OriginatingNodes.insert(Origins).second) {
+            Topology NewGraph(Graph);
+            ++NewGraph.NumberOfNodes;
+            for (auto i : Combination)
+              NewGraph.Edges[OpenEdges[i]].EndingNode = NewNode;
+            TopologyEdge NewEdge;
+            NewEdge.OriginatingNode = NewNode;
+            NewGraph.Edges.insert(NewGraph.Edges.end(),
+                                  Type.NumberOfOutgoingEdges, NewEdge);
+            if (CanonicalForms.insert(canonicalForm(NewGraph)).second)
+              ExtendedGraphs.push_back(NewGraph);
+          }
+
+          // next combination in lexicographic order
+          std::size_t i = k;
+          while (i > 0 && Combination[i - 1] == OpenEdges.size() - k + i - 1)
+            --i;
+          if (i == 0)
+            break;
+          ++Combination[i - 1];
+          for (std::size_t j = i; j < k; ++j)
+            Combination[j] = Combination[j - 1] + 1;
+        }
+      }
+    }
+    Graphs = std::move(ExtendedGraphs);
+  }
+  LOG(DEBUG) << "TopologyGenerator::grow(): " << Results.size()
+             << " topologies for " << NumberOfInitialEdges << " -> "
+             << NumberOfFinalEdges << " edges.";
+  return Results;
+}
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
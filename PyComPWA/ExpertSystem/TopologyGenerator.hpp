@@ -0,0 +1,78 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_EXPERTSYSTEM_TOPOLOGYGENERATOR_HPP_
+#define PYCOMPWA_EXPERTSYSTEM_TOPOLOGYGENERATOR_HPP_
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace PyComPWA {
+namespace ExpertSystem {
+
+/// Number of ingoing and outgoing edges of an interaction node, see
+/// InteractionNode in graph.py.
+struct InteractionNodeType {
+  unsigned int NumberOfIngoingEdges = 1;
+  unsigned int NumberOfOutgoingEdges = 2;
+};
+
+/// Nodes of an edge, negative ids stand for the initial (final) state.
+struct TopologyEdge {
+  int OriginatingNode = -1;
+  int EndingNode = -1;
+};
+
+/// Graph of nodes 0, ..., NumberOfNodes - 1 and the edges 0, ..., n - 1. The
+/// initial state edges come first.
+struct Topology {
+  std::size_t NumberOfNodes = 0;
+  std::vector<TopologyEdge> Edges;
+};
+
+///
+/// \class TopologyGenerator
+/// Enumerates all topologies that connect a number of initial state edges
+/// with a number of final state edges through the given interaction nodes,
+/// like the SimpleStateTransitionTopologyBuilder. Graphs are grown by
+/// attaching one node to the open edges at a time. Of all isomorphic graphs
+/// of a generation only the first one is extended, which is found through a
+/// canonical form of the graphs. Hence, each topology is returned once and
+/// the number of graphs stays small for many final state particles.
+///
+/// Graphs with a node that does not change the number of open edges could
+/// grow forever. Therefore, a graph has at most n_i + n_f - 2 nodes (but at
+/// least one), which is the maximum for trees of nodes with three or more
+/// edges.
+///
+/// The topologies are memoized for each number of initial and final state
+/// edges.
+///
+class TopologyGenerator {
+public:
+  explicit TopologyGenerator(std::vector<InteractionNodeType> NodeTypes);
+
+  const std::vector<Topology> &
+  generate(std::size_t NumberOfInitialEdges, std::size_t NumberOfFinalEdges);
+
+private:
+  std::vector<Topology> grow(std::size_t NumberOfInitialEdges,
+                             std::size_t NumberOfFinalEdges) const;
+
+  std::vector<InteractionNodeType> NodeTypes;
+  std::map<std::pair<std::size_t, std::size_t>, std::vector<Topology>>
+      Topologies;
+};
+
+/// Canonical form of a topology, which is the same for two topologies if
+/// and only if they are isomorphic. It is the smallest sorted list of edges
+/// over all node labelings that are consistent with a color refinement.
+std::vector<std::pair<int, int>> canonicalForm(const Topology &Graph);
+
+} // namespace ExpertSystem
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,215 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/Tools/AdaptiveBinning.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+AdaptiveBinning::AdaptiveBinning(
+    const std::vector<ColumnView> &Columns, unsigned int MinimalEventsPerBin,
+    std::vector<std::pair<double, double>> Ranges_)
+    : Ranges(std::move(Ranges_)) {
+  std::size_t NumberOfEvents =
+      checkColumnSizes(Columns, ColumnView{nullptr, 0});
+  if (MinimalEventsPerBin == 0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::AdaptiveBinning: the minimal "
+                               "number of events per bin has to be positive!");
+  if (Ranges.empty()) {
+    for (auto const &Column : Columns) {
+      auto MinMax = std::minmax_element(Column.Data, Column.Data + Column.Size);
+      Ranges.emplace_back(NumberOfEvents ? *MinMax.first : 0.0,
+                          NumberOfEvents ? *MinMax.second : 0.0);
+    }
+  }
+  if (Ranges.size() != Columns.size())
+    throw ComPWA::BadParameter("PyComPWA::Tools::AdaptiveBinning: number of "
+                               "ranges and columns mismatch!");
+  for (auto const &Range : Ranges) {
+    if (!(Range.first <= Range.second))
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::AdaptiveBinning: invalid range!");
+  }
+
+  // only the events inside of the full range are split
+  std::vector<std::size_t> Indices;
+  Indices.reserve(NumberOfEvents);
+  for (std::size_t i = 0; i < NumberOfEvents; ++i) {
+    bool Inside(true);
+    for (std::size_t d = 0; d < Columns.size(); ++d)
+      Inside &= Columns[d][i] >= Ranges[d].first &&
+                Columns[d][i] <= Ranges[d].second;
+    if (Inside)
+      Indices.push_back(i);
+  }
+  AdaptiveBin Box;
+  for (auto const &Range : Ranges) {
+    Box.LowerEdges.push_back(Range.first);
+    Box.UpperEdges.push_back(Range.second);
+  }
+  split(Columns, Indices.begin(), Indices.end(), Box, MinimalEventsPerBin);
+  LOG(DEBUG) << "AdaptiveBinning::AdaptiveBinning(): split " << Indices.size()
+             << " events into " << Bins.size() << " bins";
+}
+
+std::size_t AdaptiveBinning::split(const std::vector<ColumnView> &Columns,
+                                   std::vector<std::size_t>::iterator Begin,
+                                   std::vector<std::size_t>::iterator End,
+                                   AdaptiveBin Box,
+                                   unsigned int MinimalEventsPerBin) {
+  std::size_t NodeIndex = Nodes.size();
+  Nodes.push_back(Node{0, 0, 0, 0.0, 0});
+  std::size_t NumberOfEvents = std::distance(Begin, End);
+
+  // the widest dimension relative to the full range is split
+  std::size_t SplitDimension(0);
+  double MaximalWidth(-1.0);
+  for (std::size_t d = 0; d < Ranges.size(); ++d) {
+    double FullWidth = Ranges[d].second - Ranges[d].first;
+    double Width = FullWidth > 0.0
+                       ? (Box.UpperEdges[d] - Box.LowerEdges[d]) / FullWidth
+                       : 0.0;
+    if (Width > MaximalWidth) {
+      MaximalWidth = Width;
+      SplitDimension = d;
+    }
+  }
+  auto const &Column = Columns[SplitDimension];
+  auto Middle = Begin + NumberOfEvents / 2;
+  double SplitValue(0.0);
+  bool CanSplit = NumberOfEvents >= 2 * MinimalEventsPerBin && MaximalWidth > 0;
+  if (CanSplit) {
+    auto Less = [&Column](std::size_t a, std::size_t b) {
+      return Column[a] < Column[b];
+    };
+    std::nth_element(Begin, Middle, End, Less);
+    double Upper = Column[*Middle];
+    double Lower = Column[*std::max_element(Begin, Middle, Less)];
+    SplitValue = 0.5 * (Lower + Upper);
+    // events with equal values cannot be separated
+    CanSplit = Lower < Upper;
+  }
+  if (!CanSplit) {
+    Nodes[NodeIndex].Bin = Bins.size();
+    Bins.push_back(Box);
+    return NodeIndex;
+  }
+
+  AdaptiveBin LeftBox(Box), RightBox(Box);
+  LeftBox.UpperEdges[SplitDimension] = SplitValue;
+  RightBox.LowerEdges[SplitDimension] = SplitValue;
+  std::size_t Left =
+      split(Columns, Begin, Middle, std::move(LeftBox), MinimalEventsPerBin);
+  std::size_t Right =
+      split(Columns, Middle, End, std::move(RightBox), MinimalEventsPerBin);
+  Nodes[NodeIndex].Left = Left;
+  Nodes[NodeIndex].Right = Right;
+  Nodes[NodeIndex].SplitDimension = SplitDimension;
+  Nodes[NodeIndex].SplitValue = SplitValue;
+  return NodeIndex;
+}
+
+std::size_t AdaptiveBinning::findBin(const std::vector<double> &Point) const {
+  for (std::size_t d = 0; d < Ranges.size(); ++d) {
+    if (!(Point[d] >= Ranges[d].first && Point[d] <= Ranges[d].second))
+      return Bins.size();
+  }
+  std::size_t NodeIndex(0);
+  while (Nodes[NodeIndex].Left != 0) {
+    const Node &n = Nodes[NodeIndex];
+    NodeIndex = Point[n.SplitDimension] < n.SplitValue ? n.Left : n.Right;
+  }
+  return Nodes[NodeIndex].Bin;
+}
+
+BinnedExpectation AdaptiveBinning::fill(const std::vector<ColumnView> &Columns,
+                                        const ColumnView &Weights) const {
+  if (Columns.size() != dimension())
+    throw ComPWA::BadParameter("PyComPWA::Tools::AdaptiveBinning::fill(): "
+                               "number of columns and dimensions mismatch!");
+  std::size_t NumberOfEvents = checkColumnSizes(Columns, Weights);
+  std::vector<double> Sums(Bins.size(), 0.0);
+  std::vector<double> SquaredSums(Bins.size(), 0.0);
+#pragma omp parallel
+  {
+    std::vector<double> LocalSums(Bins.size(), 0.0);
+    std::vector<double> LocalSquaredSums(Bins.size(), 0.0);
+    std::vector<double> Point(Columns.size());
+#pragma omp for schedule(static)
+    for (long i = 0; i < static_cast<long>(NumberOfEvents); ++i) {
+      for (std::size_t d = 0; d < Columns.size(); ++d)
+        Point[d] = Columns[d][i];
+      std::size_t Bin = findBin(Point);
+      if (Bin == Bins.size())
+        continue;
+      double w = Weights.size() ? Weights[i] : 1.0;
+      LocalSums[Bin] += w;
+      LocalSquaredSums[Bin] += w * w;
+    }
+#pragma omp critical
+    for (std::size_t Bin = 0; Bin < Bins.size(); ++Bin) {
+      Sums[Bin] += LocalSums[Bin];
+      SquaredSums[Bin] += LocalSquaredSums[Bin];
+    }
+  }
+
+  BinnedExpectation Result;
+  Result.Values = std::move(Sums);
+  Result.Errors.reserve(Bins.size());
+  for (auto x : SquaredSums)
+    Result.Errors.push_back(std::sqrt(x));
+  return Result;
+}
+
+AdaptiveChiSquareResult
+adaptiveChiSquare(const std::vector<ColumnView> &DataColumns,
+                  const ColumnView &DataWeights,
+                  const std::vector<ColumnView> &ModelColumns,
+                  const ColumnView &ModelWeights,
+                  unsigned int MinimalEventsPerBin,
+                  std::vector<std::pair<double, double>> Ranges) {
+  if (DataColumns.size() != ModelColumns.size())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::adaptiveChiSquare(): data and model samples have a "
+        "different number of variables!");
+  if (Ranges.empty()) {
+    // the full range covers both samples
+    for (std::size_t d = 0; d < DataColumns.size(); ++d) {
+      double Min = std::numeric_limits<double>::max();
+      double Max = std::numeric_limits<double>::lowest();
+      for (auto const &Column : {DataColumns[d], ModelColumns[d]}) {
+        if (Column.Size == 0)
+          continue;
+        auto MinMax =
+            std::minmax_element(Column.Data, Column.Data + Column.Size);
+        Min = std::min(Min, *MinMax.first);
+        Max = std::max(Max, *MinMax.second);
+      }
+      Ranges.emplace_back(Min, Max);
+    }
+  }
+
+  AdaptiveBinning Binning(DataColumns, MinimalEventsPerBin, Ranges);
+  AdaptiveChiSquareResult Result;
+  Result.Bins = Binning.bins();
+  Result.Data = Binning.fill(DataColumns, DataWeights);
+  Result.Model = Binning.fill(ModelColumns, ModelWeights);
+  Result.ChiSquare =
+      chiSquare(Result.Data.Values, Result.Data.Errors, Result.Model, true);
+  for (std::size_t Bin = 0; Bin < Result.Bins.size(); ++Bin) {
+    Result.Model.Values[Bin] *= Result.ChiSquare.Scale;
+    Result.Model.Errors[Bin] *= Result.ChiSquare.Scale;
+  }
+  return Result;
+}
+
+} // namespace Tools
+} // namespace PyComPWA
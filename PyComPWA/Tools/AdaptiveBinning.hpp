@@ -0,0 +1,94 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_ADAPTIVEBINNING_HPP_
+#define PYCOMPWA_TOOLS_ADAPTIVEBINNING_HPP_
+
+#include <utility>
+#include <vector>
+
+#include "PyComPWA/Tools/BinnedIntegration.hpp"
+#include "PyComPWA/Tools/DataColumns.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+/// Hyperrectangle of an adaptive binning.
+struct AdaptiveBin {
+  std::vector<double> LowerEdges;
+  std::vector<double> UpperEdges;
+};
+
+///
+/// \class AdaptiveBinning
+/// Binning with (nearly) equal numbers of events per bin. The events of a
+/// reference sample are split recursively at the median of one dimension,
+/// until a bin holds less than twice \p MinimalEventsPerBin events. Each
+/// split divides the dimension in which the bin is widest relative to the
+/// full range. In contrast to a uniform binning, there are no empty bins even
+/// in many dimensions.
+///
+class AdaptiveBinning {
+public:
+  /// The full range covers the reference sample, if no \p Ranges are given.
+  AdaptiveBinning(const std::vector<ColumnView> &Columns,
+                  unsigned int MinimalEventsPerBin,
+                  std::vector<std::pair<double, double>> Ranges = {});
+
+  std::size_t numberOfBins() const { return Bins.size(); }
+  std::size_t dimension() const { return Ranges.size(); }
+  const std::vector<AdaptiveBin> &bins() const { return Bins; }
+
+  /// Index of the bin containing \p Point, or numberOfBins() if the point is
+  /// outside of the full range.
+  std::size_t findBin(const std::vector<double> &Point) const;
+
+  /// Sums of weights and their errors in all bins, filled in parallel. A
+  /// weight view of size zero stands for unit weights.
+  BinnedExpectation fill(const std::vector<ColumnView> &Columns,
+                         const ColumnView &Weights) const;
+
+private:
+  struct Node {
+    /// Children of inner nodes. Leaves have no children (zero).
+    std::size_t Left;
+    std::size_t Right;
+    std::size_t SplitDimension;
+    double SplitValue;
+    std::size_t Bin;
+  };
+
+  std::size_t split(const std::vector<ColumnView> &Columns,
+                    std::vector<std::size_t>::iterator Begin,
+                    std::vector<std::size_t>::iterator End, AdaptiveBin Box,
+                    unsigned int MinimalEventsPerBin);
+
+  std::vector<std::pair<double, double>> Ranges;
+  std::vector<Node> Nodes;
+  std::vector<AdaptiveBin> Bins;
+};
+
+struct AdaptiveChiSquareResult {
+  std::vector<AdaptiveBin> Bins;
+  BinnedExpectation Data;
+  /// Model expectation, scaled to the data.
+  BinnedExpectation Model;
+  ChiSquareResult ChiSquare;
+};
+
+/// Chi square of a data sample and a weighted model sample (for instance the
+/// phase space sample weighted with the fitted intensity) in an adaptive
+/// binning of the data sample.
+AdaptiveChiSquareResult
+adaptiveChiSquare(const std::vector<ColumnView> &DataColumns,
+                  const ColumnView &DataWeights,
+                  const std::vector<ColumnView> &ModelColumns,
+                  const ColumnView &ModelWeights,
+                  unsigned int MinimalEventsPerBin = 20,
+                  std::vector<std::pair<double, double>> Ranges = {});
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,200 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/Tools/AngularMoments.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+/// Fills \p AssociatedLegendre with \f$P_L^M(x)\f$ (including the
+/// Condon-Shortley phase) for 0 <= M <= L <= MaxL at [L * (MaxL + 1) + M].
+void associatedLegendre(double x, unsigned int MaxL,
+                        std::vector<double> &AssociatedLegendre) {
+  std::size_t Stride = MaxL + 1;
+  double Sine = std::sqrt(std::max(0.0, (1.0 - x) * (1.0 + x)));
+  double Pmm(1.0);
+  for (unsigned int M = 0; M <= MaxL; ++M) {
+    if (M > 0)
+      Pmm *= -(2.0 * M - 1.0) * Sine;
+    AssociatedLegendre[M * Stride + M] = Pmm;
+    if (M == MaxL)
+      break;
+    double Previous = Pmm;
+    double Current = x * (2.0 * M + 1.0) * Pmm;
+    AssociatedLegendre[(M + 1) * Stride + M] = Current;
+    for (unsigned int L = M + 2; L <= MaxL; ++L) {
+      double Next =
+          (x * (2.0 * L - 1.0) * Current - (L + M - 1.0) * Previous) / (L - M);
+      AssociatedLegendre[L * Stride + M] = Next;
+      Previous = Current;
+      Current = Next;
+    }
+  }
+}
+
+/// Normalization of the spherical harmonics
+/// \f$\sqrt{(2L+1)/4\pi \cdot (L-M)!/(L+M)!}\f$ at [L * (MaxL + 1) + M].
+std::vector<double> sphericalHarmonicNorms(unsigned int MaxL) {
+  std::size_t Stride = MaxL + 1;
+  std::vector<double> Norms(Stride * Stride, 0.0);
+  for (unsigned int L = 0; L <= MaxL; ++L) {
+    double FactorialRatio(1.0);
+    for (unsigned int M = 0; M <= L; ++M) {
+      if (M > 0)
+        FactorialRatio /= (L + M) * (L - M + 1.0);
+      Norms[L * Stride + M] =
+          std::sqrt((2.0 * L + 1.0) / (4.0 * M_PI) * FactorialRatio);
+    }
+  }
+  return Norms;
+}
+
+} // namespace
+
+AngularMoments computeAngularMoments(const ColumnView &CosTheta,
+                                     const ColumnView &Phi,
+                                     const ColumnView &Weights,
+                                     unsigned int MaxL, const ColumnView &Mass,
+                                     std::vector<double> MassBinEdges) {
+  std::size_t NumberOfEvents = checkColumnSizes({CosTheta}, Weights);
+  bool Spherical = Phi.size() != 0;
+  if (Spherical && Phi.size() != NumberOfEvents)
+    throw ComPWA::BadParameter("PyComPWA::Tools::computeAngularMoments(): "
+                               "theta and phi columns differ in length!");
+  bool Binned = !MassBinEdges.empty();
+  if (Binned) {
+    if (MassBinEdges.size() < 2 ||
+        !std::is_sorted(MassBinEdges.begin(), MassBinEdges.end()))
+      throw ComPWA::BadParameter("PyComPWA::Tools::computeAngularMoments(): "
+                                 "invalid mass bin edges!");
+    if (Mass.size() != NumberOfEvents)
+      throw ComPWA::BadParameter("PyComPWA::Tools::computeAngularMoments(): "
+                                 "mass and angle columns differ in length!");
+  }
+  std::size_t NumberOfMassBins = Binned ? MassBinEdges.size() - 1 : 1;
+
+  AngularMoments Result;
+  Result.MassBinEdges = MassBinEdges;
+  for (int L = 0; L <= static_cast<int>(MaxL); ++L) {
+    if (!Spherical) {
+      Result.Indices.emplace_back(L, 0);
+      continue;
+    }
+    for (int M = -L; M <= L; ++M)
+      Result.Indices.emplace_back(L, M);
+  }
+  std::size_t NumberOfMoments = Result.Indices.size();
+  Result.Values.assign(NumberOfMassBins,
+                       std::vector<double>(NumberOfMoments, 0.0));
+  Result.Covariances.assign(
+      NumberOfMassBins,
+      std::vector<double>(NumberOfMoments * NumberOfMoments, 0.0));
+
+  std::size_t Stride = MaxL + 1;
+  auto Norms = sphericalHarmonicNorms(MaxL);
+#pragma omp parallel
+  {
+    std::vector<std::vector<double>> Sums(
+        NumberOfMassBins, std::vector<double>(NumberOfMoments, 0.0));
+    std::vector<std::vector<double>> SquaredSums(
+        NumberOfMassBins,
+        std::vector<double>(NumberOfMoments * NumberOfMoments, 0.0));
+    std::vector<double> Legendre(Stride * Stride);
+    std::vector<double> Basis(NumberOfMoments);
+#pragma omp for schedule(static)
+    for (long i = 0; i < static_cast<long>(NumberOfEvents); ++i) {
+      std::size_t Bin(0);
+      if (Binned) {
+        auto it = std::upper_bound(MassBinEdges.begin(), MassBinEdges.end(),
+                                   Mass[i]);
+        if (it == MassBinEdges.begin() ||
+            (it == MassBinEdges.end() && Mass[i] != MassBinEdges.back()))
+          continue;
+        Bin = std::min<std::size_t>(
+            std::distance(MassBinEdges.begin(), it) - 1, NumberOfMassBins - 1);
+      }
+
+      associatedLegendre(CosTheta[i], MaxL, Legendre);
+      if (Spherical) {
+        std::size_t a(0);
+        for (unsigned int L = 0; L <= MaxL; ++L) {
+          for (int M = -static_cast<int>(L); M <= static_cast<int>(L); ++M) {
+            unsigned int AbsM = std::abs(M);
+            double Value =
+                Norms[L * Stride + AbsM] * Legendre[L * Stride + AbsM];
+            if (M > 0)
+              Value *= M_SQRT2 * std::cos(M * Phi[i]);
+            else if (M < 0)
+              Value *= M_SQRT2 * std::sin(AbsM * Phi[i]);
+            Basis[a++] = Value;
+          }
+        }
+      } else {
+        for (unsigned int L = 0; L <= MaxL; ++L)
+          Basis[L] = Legendre[L * Stride];
+      }
+
+      double w = Weights.size() ? Weights[i] : 1.0;
+      auto &Sum = Sums[Bin];
+      auto &SquaredSum = SquaredSums[Bin];
+      for (std::size_t a = 0; a < NumberOfMoments; ++a) {
+        Sum[a] += w * Basis[a];
+        double wwBasis = w * w * Basis[a];
+        for (std::size_t b = a; b < NumberOfMoments; ++b)
+          SquaredSum[a * NumberOfMoments + b] += wwBasis * Basis[b];
+      }
+    }
+#pragma omp critical
+    for (std::size_t Bin = 0; Bin < NumberOfMassBins; ++Bin) {
+      for (std::size_t a = 0; a < NumberOfMoments; ++a)
+        Result.Values[Bin][a] += Sums[Bin][a];
+      for (std::size_t ab = 0; ab < NumberOfMoments * NumberOfMoments; ++ab)
+        Result.Covariances[Bin][ab] += SquaredSums[Bin][ab];
+    }
+  }
+
+  // only the upper triangle was summed
+  for (auto &Covariance : Result.Covariances) {
+    for (std::size_t a = 0; a < NumberOfMoments; ++a)
+      for (std::size_t b = 0; b < a; ++b)
+        Covariance[a * NumberOfMoments + b] =
+            Covariance[b * NumberOfMoments + a];
+  }
+  LOG(DEBUG) << "PyComPWA::Tools::computeAngularMoments(): computed "
+             << NumberOfMoments << " moments in " << NumberOfMassBins
+             << " bins from " << NumberOfEvents << " events";
+  return Result;
+}
+
+AngularMoments computeAngularMoments(const ComPWA::Data::DataSet &Sample,
+                                     const std::string &ThetaName,
+                                     const std::string &PhiName,
+                                     unsigned int MaxL,
+                                     const std::string &MassName,
+                                     std::vector<double> MassBinEdges) {
+  auto Theta = selectColumns(Sample, {ThetaName}).front();
+  std::vector<double> CosTheta(Theta.size());
+  for (std::size_t i = 0; i < Theta.size(); ++i)
+    CosTheta[i] = std::cos(Theta[i]);
+  ColumnView Phi{nullptr, 0};
+  if (!PhiName.empty())
+    Phi = selectColumns(Sample, {PhiName}).front();
+  ColumnView Mass{nullptr, 0};
+  if (!MassName.empty())
+    Mass = selectColumns(Sample, {MassName}).front();
+  return computeAngularMoments(makeColumnView(CosTheta), Phi,
+                               makeColumnView(Sample.Weights), MaxL, Mass,
+                               MassBinEdges);
+}
+
+} // namespace Tools
+} // namespace PyComPWA
@@ -0,0 +1,58 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_ANGULARMOMENTS_HPP_
+#define PYCOMPWA_TOOLS_ANGULARMOMENTS_HPP_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Data/DataSet.hpp"
+#include "PyComPWA/Tools/DataColumns.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+/// Weighted sums of angular basis functions \f$\sum_i w_i f_a(\Omega_i)\f$ and
+/// their covariances \f$\sum_i w_i^2 f_a(\Omega_i) f_b(\Omega_i)\f$, for each
+/// bin of an (optional) invariant mass.
+struct AngularMoments {
+  /// (L, M) of each basis function.
+  std::vector<std::pair<int, int>> Indices;
+  /// Mass bin edges. Empty if the moments are not binned.
+  std::vector<double> MassBinEdges;
+  /// Moments of all basis functions for each mass bin.
+  std::vector<std::vector<double>> Values;
+  /// Row-major covariance matrix of the moments for each mass bin.
+  std::vector<std::vector<double>> Covariances;
+};
+
+/// Computes the moments of all basis functions up to \p MaxL in a single
+/// parallel pass over the events. If \p Phi is empty, the basis functions are
+/// the Legendre polynomials \f$P_L(\cos\theta)\f$. Otherwise they are the
+/// real spherical harmonics, i.e. \f$\sqrt{2}\,\mathrm{Re}\,Y_{LM}\f$ for
+/// M > 0, \f$Y_{L0}\f$ and \f$\sqrt{2}\,\mathrm{Im}\,Y_{L|M|}\f$ for M < 0.
+/// If \p MassBinEdges are given, the events are binned in \p Mass and events
+/// outside of the mass range are skipped.
+AngularMoments computeAngularMoments(const ColumnView &CosTheta,
+                                     const ColumnView &Phi,
+                                     const ColumnView &Weights,
+                                     unsigned int MaxL,
+                                     const ColumnView &Mass = {nullptr, 0},
+                                     std::vector<double> MassBinEdges = {});
+
+/// Moments of the angles \p ThetaName and \p PhiName (optional) of a data
+/// set, optionally in bins of \p MassName.
+AngularMoments computeAngularMoments(const ComPWA::Data::DataSet &Sample,
+                                     const std::string &ThetaName,
+                                     const std::string &PhiName,
+                                     unsigned int MaxL,
+                                     const std::string &MassName = "",
+                                     std::vector<double> MassBinEdges = {});
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
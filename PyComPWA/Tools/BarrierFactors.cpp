@@ -0,0 +1,214 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+
+#include "Core/Exceptions.hpp"
+
+#include "PyComPWA/Tools/BarrierFactors.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+/// Rounds \p Value to 12 significant digits, so that parameters which only
+/// differ by rounding errors are equal.
+double canonicalParameter(double Value, const std::string &Function) {
+  if (!std::isfinite(Value) || Value < 0.0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::BarrierFactorCache::" +
+                               Function +
+                               "(): masses and radii have to be finite and "
+                               "not negative!");
+  char Buffer[32];
+  std::snprintf(Buffer, sizeof(Buffer), "%.12g", Value);
+  // turns -0 into 0
+  return std::strtod(Buffer, nullptr) + 0.0;
+}
+
+} // namespace
+
+double breakupMomentumSquared(double S, double MassA, double MassB) {
+  double Sum = MassA + MassB;
+  double Difference = MassA - MassB;
+  return (S - Sum * Sum) * (S - Difference * Difference) / (4.0 * S);
+}
+
+double blattWeisskopfFactor(unsigned int L, double z) {
+  double FactorSquared(1.0);
+  switch (L) {
+  case 0:
+    break;
+  case 1:
+    FactorSquared = 2.0 * z / (z + 1.0);
+    break;
+  case 2:
+    FactorSquared = 13.0 * z * z / ((z - 3.0) * (z - 3.0) + 9.0 * z);
+    break;
+  case 3:
+    FactorSquared =
+        277.0 * z * z * z /
+        (z * (z - 15.0) * (z - 15.0) + 9.0 * (2.0 * z - 5.0) * (2.0 * z - 5.0));
+    break;
+  case 4: {
+    double a = z * z - 45.0 * z + 105.0;
+    FactorSquared = 12746.0 * z * z * z * z /
+                    (a * a + 25.0 * z * (2.0 * z - 21.0) * (2.0 * z - 21.0));
+    break;
+  }
+  default:
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::blattWeisskopfFactor(): L = " + std::to_string(L) +
+        " is not supported!");
+  }
+  return std::sqrt(FactorSquared);
+}
+
+std::string BarrierFactorCache::requestBreakupMomentum(
+    const std::string &MassSquaredVariable, double MassA, double MassB) {
+  MassA = canonicalParameter(MassA, "requestBreakupMomentum");
+  MassB = canonicalParameter(MassB, "requestBreakupMomentum");
+  SubSystem Key(MassSquaredVariable, std::min(MassA, MassB),
+                std::max(MassA, MassB));
+  auto Found = BreakupMomenta.find(Key);
+  if (Found != BreakupMomenta.end())
+    return Found->second;
+  // the columns are numbered, as the same variable can be used with
+  // different daughter masses or meson radii
+  std::string Name = "BreakupMomentum_" + MassSquaredVariable + "_" +
+                     std::to_string(BreakupMomenta.size());
+  BreakupMomenta[Key] = Name;
+  Names.push_back(Name);
+  return Name;
+}
+
+std::string BarrierFactorCache::requestBarrierFactor(
+    const std::string &MassSquaredVariable, double MassA, double MassB,
+    unsigned int L, double MesonRadius) {
+  if (L > 4)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::BarrierFactorCache::requestBarrierFactor(): L = " +
+        std::to_string(L) + " is not supported!");
+  MassA = canonicalParameter(MassA, "requestBarrierFactor");
+  MassB = canonicalParameter(MassB, "requestBarrierFactor");
+  BarrierFactor Key(SubSystem(MassSquaredVariable, std::min(MassA, MassB),
+                              std::max(MassA, MassB)),
+                    L, canonicalParameter(MesonRadius, "requestBarrierFactor"));
+  auto Found = BarrierFactors.find(Key);
+  if (Found != BarrierFactors.end())
+    return Found->second;
+  std::string Name = "BarrierFactor_L" + std::to_string(L) + "_" +
+                     MassSquaredVariable + "_" +
+                     std::to_string(BarrierFactors.size());
+  BarrierFactors[Key] = Name;
+  Names.push_back(Name);
+  return Name;
+}
+
+std::vector<std::string> BarrierFactorCache::columnNames() const {
+  return Names;
+}
+
+std::vector<std::vector<double>> BarrierFactorCache::computeColumns(
+    const std::vector<std::string> &VariableNames,
+    const std::vector<ColumnView> &Columns) const {
+  return computeColumns(VariableNames, Columns, Names);
+}
+
+std::vector<std::vector<double>> BarrierFactorCache::computeColumns(
+    const std::vector<std::string> &VariableNames,
+    const std::vector<ColumnView> &Columns,
+    const std::vector<std::string> &Selected) const {
+  if (VariableNames.size() != Columns.size())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::BarrierFactorCache::computeColumns(): number of "
+        "variable names and columns differ!");
+  std::set<std::string> SelectedNames(Selected.begin(), Selected.end());
+
+  // the break-up momenta are computed once for each subsystem
+  std::map<SubSystem, std::vector<double>> MomentaSquared;
+  auto momentaSquared =
+      [&](const SubSystem &System) -> const std::vector<double> & {
+    auto Found = MomentaSquared.find(System);
+    if (Found != MomentaSquared.end())
+      return Found->second;
+    auto Variable = std::find(VariableNames.begin(), VariableNames.end(),
+                              std::get<0>(System));
+    if (Variable == VariableNames.end())
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::BarrierFactorCache::computeColumns(): variable " +
+          std::get<0>(System) + " is not given!");
+    const ColumnView &S = Columns[Variable - VariableNames.begin()];
+    std::vector<double> Values(S.size());
+    long Size = S.size();
+#pragma omp parallel for schedule(static)
+    for (long i = 0; i < Size; ++i)
+      Values[i] = breakupMomentumSquared(S[i], std::get<1>(System),
+                                         std::get<2>(System));
+    return MomentaSquared[System] = std::move(Values);
+  };
+
+  std::map<std::string, std::vector<double>> Results;
+  for (auto const &x : BreakupMomenta) {
+    if (!SelectedNames.count(x.second))
+      continue;
+    auto const &QSquared = momentaSquared(x.first);
+    std::vector<double> Values(QSquared.size());
+    for (std::size_t i = 0; i < QSquared.size(); ++i)
+      Values[i] = std::sqrt(std::abs(QSquared[i]));
+    Results[x.second] = std::move(Values);
+  }
+  for (auto const &x : BarrierFactors) {
+    if (!SelectedNames.count(x.second))
+      continue;
+    auto const &QSquared = momentaSquared(std::get<0>(x.first));
+    unsigned int L = std::get<1>(x.first);
+    double RadiusSquared = std::get<2>(x.first) * std::get<2>(x.first);
+    std::vector<double> Values(QSquared.size());
+    long Size = QSquared.size();
+#pragma omp parallel for schedule(static)
+    for (long i = 0; i < Size; ++i)
+      Values[i] =
+          blattWeisskopfFactor(L, std::abs(QSquared[i]) * RadiusSquared);
+    Results[x.second] = std::move(Values);
+  }
+
+  std::vector<std::vector<double>> OrderedResults;
+  for (auto const &Name : Selected) {
+    auto Found = Results.find(Name);
+    if (Found == Results.end())
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::BarrierFactorCache::computeColumns(): column " +
+          Name + " was not requested!");
+    OrderedResults.push_back(std::move(Found->second));
+  }
+  return OrderedResults;
+}
+
+void BarrierFactorCache::addColumns(ComPWA::Data::DataSet &Sample) const {
+  std::vector<std::string> Missing;
+  for (auto const &Name : Names) {
+    if (std::find(Sample.VariableNames.begin(), Sample.VariableNames.end(),
+                  Name) == Sample.VariableNames.end())
+      Missing.push_back(Name);
+  }
+  if (Missing.empty())
+    return;
+
+  std::vector<ColumnView> Columns;
+  for (auto const &Column : Sample.Data)
+    Columns.push_back(makeColumnView(Column));
+  auto NewColumns = computeColumns(Sample.VariableNames, Columns, Missing);
+  for (std::size_t i = 0; i < Missing.size(); ++i) {
+    Sample.VariableNames.push_back(Missing[i]);
+    Sample.Data.push_back(std::move(NewColumns[i]));
+  }
+}
+
+} // namespace Tools
+} // namespace PyComPWA
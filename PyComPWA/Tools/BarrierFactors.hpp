@@ -0,0 +1,96 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_BARRIERFACTORS_HPP_
+#define PYCOMPWA_TOOLS_BARRIERFACTORS_HPP_
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Data/DataSet.hpp"
+
+#include "PyComPWA/Tools/DataColumns.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+/// Squared break-up momentum of a two body decay with invariant mass squared
+/// \p S into daughters with masses \p MassA and \p MassB. It is negative
+/// below threshold.
+double breakupMomentumSquared(double S, double MassA, double MassB);
+
+/// Blatt-Weisskopf barrier factor \f$B_L(z)\f$ with \f$z = q^2 R^2\f$, for
+/// orbital angular momenta \p L up to 4. Like ComPWA's form factor, it is the
+/// square root of the usual \f$B_L^2(z)\f$ with \f$B_L(z) \to 1\f$ for large
+/// \f$z\f$.
+double blattWeisskopfFactor(unsigned int L, double z);
+
+///
+/// \class BarrierFactorCache
+/// Break-up momenta and barrier factors depend only on the invariant mass of
+/// a subsystem and fixed parameters. Each request returns the name of a data
+/// column. Identical requests share a column, so each column is computed once
+/// per data set, and the break-up momentum of a subsystem is computed once
+/// for all its orbital angular momenta.
+///
+/// This is a standalone utility for user defined intensities, e.g. a
+/// VectorizedIntensity, which read the columns from the data. The amplitudes
+/// of ComPWA compute their form factors themselves and do not use the cache.
+///
+/// Requests are compared with canonical parameters: the daughter masses are
+/// ordered, as the break-up momentum is symmetric in them, and the masses and
+/// radii are rounded to 12 significant digits. Hence the same mass parsed
+/// from different xml files or computed in different ways shares a column.
+///
+/// Below threshold \f$q^2 < 0\f$. The columns are computed from \f$|q^2|\f$,
+/// i.e. the break-up momentum is the absolute value of the analytic
+/// continuation \f$i|q|\f$ and the barrier factor is \f$B_L(|q^2| R^2)\f$.
+/// Both are real and continuous at threshold, where they vanish for
+/// \f$L > 0\f$.
+///
+class BarrierFactorCache {
+public:
+  /// Name of the column with the break-up momenta of the subsystem with the
+  /// invariant mass squared \p MassSquaredVariable.
+  std::string requestBreakupMomentum(const std::string &MassSquaredVariable,
+                                     double MassA, double MassB);
+  /// Name of the column with the barrier factors of the subsystem for the
+  /// orbital angular momentum \p L and the meson radius \p MesonRadius.
+  std::string requestBarrierFactor(const std::string &MassSquaredVariable,
+                                   double MassA, double MassB, unsigned int L,
+                                   double MesonRadius);
+
+  std::vector<std::string> columnNames() const;
+
+  /// Computes all requested columns from the columns \p VariableNames. The
+  /// results are in the order of columnNames().
+  std::vector<std::vector<double>>
+  computeColumns(const std::vector<std::string> &VariableNames,
+                 const std::vector<ColumnView> &Columns) const;
+
+  /// Appends the requested columns to \p Sample, which are not already part
+  /// of it.
+  void addColumns(ComPWA::Data::DataSet &Sample) const;
+
+private:
+  using SubSystem = std::tuple<std::string, double, double>;
+  using BarrierFactor = std::tuple<SubSystem, unsigned int, double>;
+
+  std::vector<std::vector<double>>
+  computeColumns(const std::vector<std::string> &VariableNames,
+                 const std::vector<ColumnView> &Columns,
+                 const std::vector<std::string> &Selected) const;
+
+  std::map<SubSystem, std::string> BreakupMomenta;
+  std::map<BarrierFactor, std::string> BarrierFactors;
+  /// Requested columns in the order of their first request.
+  std::vector<std::string> Names;
+};
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
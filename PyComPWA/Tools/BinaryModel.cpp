@@ -0,0 +1,194 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include <vector>
+
+#include <boost/property_tree/xml_parser.hpp>
+
+#include "Core/Exceptions.hpp"
+
+#include "PyComPWA/Tools/BinaryModel.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+// The file starts with the magic string and the format version, followed by
+// the root of the tree. Each node is written in depth first order as
+//  - length and characters of its data
+//  - number of children, each written as the length and characters of its
+//    key followed by the child node
+// All numbers are unsigned 32 bit integers in little endian byte order.
+const char Magic[8] = {'P', 'C', 'P', 'W', 'A', 'M', 'D', 'L'};
+const std::uint32_t FormatVersion = 1;
+
+void writeNumber(std::vector<char> &Buffer, std::size_t Number) {
+  if (Number > 0xffffffff)
+    throw ComPWA::BadParameter("PyComPWA::Tools::writeBinaryModel(): "
+                               "model too large!");
+  for (int i = 0; i < 4; ++i)
+    Buffer.push_back(static_cast<char>((Number >> (8 * i)) & 0xff));
+}
+
+void writeString(std::vector<char> &Buffer, const std::string &String) {
+  writeNumber(Buffer, String.size());
+  Buffer.insert(Buffer.end(), String.begin(), String.end());
+}
+
+void writeTree(std::vector<char> &Buffer,
+               const boost::property_tree::ptree &Tree) {
+  writeString(Buffer, Tree.data());
+  writeNumber(Buffer, Tree.size());
+  for (auto const &Child : Tree) {
+    writeString(Buffer, Child.first);
+    writeTree(Buffer, Child.second);
+  }
+}
+
+/// Reads the encoded tree with bounds checks, so that truncated or corrupt
+/// files result in an exception.
+class TreeReader {
+public:
+  TreeReader(const std::string &FileName, const std::vector<char> &Buffer,
+             std::size_t Position)
+      : FileName(FileName), Buffer(Buffer), Position(Position) {}
+
+  std::uint32_t readNumber() {
+    require(4);
+    std::uint32_t Number(0);
+    for (int i = 0; i < 4; ++i)
+      Number |= std::uint32_t(static_cast<unsigned char>(Buffer[Position++]))
+                << (8 * i);
+    return Number;
+  }
+
+  std::string readString() {
+    std::uint32_t Size = readNumber();
+    require(Size);
+    std::string String(&Buffer[Position], Size);
+    Position += Size;
+    return String;
+  }
+
+  void readTree(boost::property_tree::ptree &Tree, unsigned int Depth = 0) {
+    // models are only a few levels deep, this guards the stack
+    if (Depth > 1000)
+      throw ComPWA::BadParameter("PyComPWA::Tools::readBinaryModel(): " +
+                                 FileName + " is corrupt!");
+    Tree.data() = readString();
+    std::uint32_t NumberOfChildren = readNumber();
+    for (std::uint32_t i = 0; i < NumberOfChildren; ++i) {
+      std::string Key = readString();
+      auto Child = Tree.push_back(
+          std::make_pair(std::move(Key), boost::property_tree::ptree()));
+      readTree(Child->second, Depth + 1);
+    }
+  }
+
+  bool atEnd() const { return Position == Buffer.size(); }
+
+private:
+  void require(std::size_t Size) const {
+    if (Buffer.size() - Position < Size)
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::readBinaryModel(): " + FileName +
+          " is truncated or corrupt!");
+  }
+
+  const std::string &FileName;
+  const std::vector<char> &Buffer;
+  std::size_t Position;
+};
+
+std::vector<char> readFile(const std::string &FileName) {
+  std::ifstream File(FileName, std::ios::binary);
+  if (!File)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::readBinaryModel(): cannot open " + FileName);
+  File.seekg(0, std::ios::end);
+  std::vector<char> Buffer(static_cast<std::size_t>(File.tellg()));
+  File.seekg(0, std::ios::beg);
+  File.read(Buffer.data(), Buffer.size());
+  return Buffer;
+}
+
+} // namespace
+
+void writeBinaryModel(const std::string &FileName,
+                      const boost::property_tree::ptree &Model) {
+  std::vector<char> Buffer(Magic, Magic + sizeof(Magic));
+  writeNumber(Buffer, FormatVersion);
+  writeTree(Buffer, Model);
+
+  // readers of the file, e.g. other fit jobs, never see a partial model
+  std::string TemporaryFile =
+      FileName + "." + std::to_string(::getpid()) + ".tmp";
+  {
+    std::ofstream File(TemporaryFile, std::ios::binary);
+    if (!File)
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::writeBinaryModel(): cannot open " +
+          TemporaryFile);
+    File.write(Buffer.data(), Buffer.size());
+    File.close();
+    if (!File) {
+      std::remove(TemporaryFile.c_str());
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::writeBinaryModel(): failed writing " +
+          TemporaryFile);
+    }
+  }
+  if (std::rename(TemporaryFile.c_str(), FileName.c_str()) != 0) {
+    std::remove(TemporaryFile.c_str());
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::writeBinaryModel(): cannot write " + FileName +
+        ": " + std::strerror(errno));
+  }
+}
+
+boost::property_tree::ptree readBinaryModel(const std::string &FileName) {
+  auto Buffer = readFile(FileName);
+  if (Buffer.size() < sizeof(Magic) ||
+      std::memcmp(Buffer.data(), Magic, sizeof(Magic)) != 0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::readBinaryModel(): " +
+                               FileName + " is not a binary model!");
+  TreeReader Reader(FileName, Buffer, sizeof(Magic));
+  auto Version = Reader.readNumber();
+  if (Version != FormatVersion)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::readBinaryModel(): " + FileName +
+        " has format version " + std::to_string(Version) + " instead of " +
+        std::to_string(FormatVersion) + ", please write it again!");
+  boost::property_tree::ptree Model;
+  Reader.readTree(Model);
+  if (!Reader.atEnd())
+    throw ComPWA::BadParameter("PyComPWA::Tools::readBinaryModel(): " +
+                               FileName + " is corrupt!");
+  return Model;
+}
+
+bool isBinaryModel(const std::string &FileName) {
+  std::ifstream File(FileName, std::ios::binary);
+  char Start[sizeof(Magic)];
+  return File.read(Start, sizeof(Start)) &&
+         std::memcmp(Start, Magic, sizeof(Magic)) == 0;
+}
+
+boost::property_tree::ptree readModel(const std::string &FileName) {
+  if (isBinaryModel(FileName))
+    return readBinaryModel(FileName);
+  boost::property_tree::ptree Model;
+  boost::property_tree::xml_parser::read_xml(FileName, Model);
+  return Model;
+}
+
+} // namespace Tools
+} // namespace PyComPWA
@@ -0,0 +1,35 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_BINARYMODEL_HPP_
+#define PYCOMPWA_TOOLS_BINARYMODEL_HPP_
+
+#include <string>
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace PyComPWA {
+namespace Tools {
+
+/// Writes the property tree of a model, i.e. the particle list, kinematics
+/// and intensity sections, to a versioned binary file. This is a
+/// serialization of the tree only: the particles are resolved and the
+/// function tree is built from it on each load, just like for a xml file.
+/// Reading is only about 20% faster than parsing the xml file. The file is
+/// replaced atomically.
+void writeBinaryModel(const std::string &FileName,
+                      const boost::property_tree::ptree &Model);
+
+/// Throws if the file is not a binary model of the current version.
+boost::property_tree::ptree readBinaryModel(const std::string &FileName);
+
+bool isBinaryModel(const std::string &FileName);
+
+/// Reads a binary model or a xml model file.
+boost::property_tree::ptree readModel(const std::string &FileName);
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,298 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/Tools/BinnedIntegration.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+/// Radical inverse of \p Index in base \p Base, which is the building block of
+/// the Halton sequence.
+double radicalInverse(unsigned long Index, unsigned int Base) {
+  double InverseBase = 1.0 / Base;
+  double Factor = InverseBase;
+  double Result = 0.0;
+  while (Index > 0) {
+    Result += Factor * (Index % Base);
+    Index /= Base;
+    Factor *= InverseBase;
+  }
+  return Result;
+}
+
+unsigned int nthPrime(unsigned int n) {
+  static const unsigned int Primes[] = {2,  3,  5,  7,  11, 13, 17, 19,
+                                        23, 29, 31, 37, 41, 43, 47, 53};
+  if (n >= sizeof(Primes) / sizeof(Primes[0]))
+    throw ComPWA::BadParameter("PyComPWA::Tools::nthPrime(): quasi-random "
+                               "sampling supports at most 16 dimensions!");
+  return Primes[n];
+}
+
+void checkBinEdges(const std::vector<std::vector<double>> &BinEdges) {
+  if (BinEdges.empty())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::checkBinEdges(): no bin edges given!");
+  for (auto const &Edges : BinEdges) {
+    if (Edges.size() < 2)
+      throw ComPWA::BadParameter("PyComPWA::Tools::checkBinEdges(): each "
+                                 "dimension needs at least two bin edges!");
+    if (!std::is_sorted(Edges.begin(), Edges.end()))
+      throw ComPWA::BadParameter("PyComPWA::Tools::checkBinEdges(): bin "
+                                 "edges have to be in increasing order!");
+  }
+}
+
+std::size_t numberOfBins(const std::vector<std::vector<double>> &BinEdges) {
+  std::size_t NumberOfBins(1);
+  for (auto const &Edges : BinEdges)
+    NumberOfBins *= Edges.size() - 1;
+  return NumberOfBins;
+}
+
+/// Row-major index of the bin containing the point \p Event of \p Columns.
+/// Returns false if the point lies outside of the histogram range.
+bool findBin(const std::vector<const std::vector<double> *> &Columns,
+             std::size_t Event,
+             const std::vector<std::vector<double>> &BinEdges,
+             std::size_t &BinIndex) {
+  BinIndex = 0;
+  for (std::size_t Dim = 0; Dim < BinEdges.size(); ++Dim) {
+    auto const &Edges = BinEdges[Dim];
+    double Value = (*Columns[Dim])[Event];
+    if (!(Value >= Edges.front() && Value <= Edges.back()))
+      return false;
+    std::size_t Index =
+        std::upper_bound(Edges.begin(), Edges.end(), Value) - Edges.begin();
+    // the upper edge of the last bin belongs to the last bin
+    Index = std::min(Index, Edges.size() - 1) - 1;
+    BinIndex = BinIndex * (Edges.size() - 1) + Index;
+  }
+  return true;
+}
+
+BinnedExpectation
+fillHistogram(const std::vector<const std::vector<double> *> &Columns,
+              const std::vector<double> &Weights,
+              const std::vector<std::vector<double>> &BinEdges) {
+  checkBinEdges(BinEdges);
+  if (Columns.size() != BinEdges.size())
+    throw ComPWA::BadParameter("PyComPWA::Tools::fillHistogram(): number of "
+                               "columns and bin edges mismatch!");
+  std::size_t NumberOfEvents(Weights.size());
+  for (auto Column : Columns) {
+    if (Column->size() != NumberOfEvents)
+      throw ComPWA::BadParameter("PyComPWA::Tools::fillHistogram(): column "
+                                 "and weight sizes mismatch!");
+  }
+
+  std::size_t NumberOfBins = numberOfBins(BinEdges);
+  std::vector<double> Sums(NumberOfBins, 0.0);
+  std::vector<double> SquaredSums(NumberOfBins, 0.0);
+
+#pragma omp parallel
+  {
+    // thread local histograms avoid any synchronization during filling
+    std::vector<double> LocalSums(NumberOfBins, 0.0);
+    std::vector<double> LocalSquaredSums(NumberOfBins, 0.0);
+#pragma omp for schedule(static)
+    for (long i = 0; i < static_cast<long>(NumberOfEvents); ++i) {
+      std::size_t Bin;
+      if (!findBin(Columns, i, BinEdges, Bin))
+        continue;
+      LocalSums[Bin] += Weights[i];
+      LocalSquaredSums[Bin] += Weights[i] * Weights[i];
+    }
+#pragma omp critical
+    for (std::size_t Bin = 0; Bin < NumberOfBins; ++Bin) {
+      Sums[Bin] += LocalSums[Bin];
+      SquaredSums[Bin] += LocalSquaredSums[Bin];
+    }
+  }
+
+  BinnedExpectation Result;
+  Result.Values = std::move(Sums);
+  Result.Errors.reserve(NumberOfBins);
+  for (auto x : SquaredSums)
+    Result.Errors.push_back(std::sqrt(x));
+  return Result;
+}
+
+} // namespace
+
+BinnedExpectation
+integrateFunctionInBins(const BinnedFunction &Function,
+                        const std::vector<std::vector<double>> &BinEdges,
+                        unsigned int PointsPerBin) {
+  checkBinEdges(BinEdges);
+  if (PointsPerBin < 2)
+    throw ComPWA::BadParameter("PyComPWA::Tools::integrateFunctionInBins(): "
+                               "at least two points per bin are required!");
+
+  std::size_t Dimensions = BinEdges.size();
+  std::size_t NumberOfBins = numberOfBins(BinEdges);
+
+  // The same quasi-random points of the unit hypercube are used in each bin.
+  // The first point of the Halton sequence (the origin) is skipped.
+  std::vector<std::vector<double>> UnitPoints(
+      Dimensions, std::vector<double>(PointsPerBin));
+  for (std::size_t Dim = 0; Dim < Dimensions; ++Dim) {
+    for (unsigned int i = 0; i < PointsPerBin; ++i)
+      UnitPoints[Dim][i] = radicalInverse(i + 1, nthPrime(Dim));
+  }
+
+  std::vector<std::vector<double>> Points(
+      Dimensions, std::vector<double>(NumberOfBins * PointsPerBin));
+  std::vector<double> BinVolumes(NumberOfBins);
+#pragma omp parallel for schedule(static)
+  for (long Bin = 0; Bin < static_cast<long>(NumberOfBins); ++Bin) {
+    double Volume(1.0);
+    std::size_t Remainder = Bin;
+    for (std::size_t Dim = Dimensions; Dim-- > 0;) {
+      auto const &Edges = BinEdges[Dim];
+      std::size_t Index = Remainder % (Edges.size() - 1);
+      Remainder /= Edges.size() - 1;
+      double Low = Edges[Index];
+      double Width = Edges[Index + 1] - Low;
+      Volume *= Width;
+      for (unsigned int i = 0; i < PointsPerBin; ++i)
+        Points[Dim][Bin * PointsPerBin + i] = Low + Width * UnitPoints[Dim][i];
+    }
+    BinVolumes[Bin] = Volume;
+  }
+
+  auto FunctionValues = Function(Points);
+  if (FunctionValues.size() != NumberOfBins * PointsPerBin)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::integrateFunctionInBins(): function returned " +
+        std::to_string(FunctionValues.size()) + " values but " +
+        std::to_string(NumberOfBins * PointsPerBin) + " were expected!");
+
+  BinnedExpectation Result;
+  Result.Values.resize(NumberOfBins);
+  Result.Errors.resize(NumberOfBins);
+#pragma omp parallel for schedule(static)
+  for (long Bin = 0; Bin < static_cast<long>(NumberOfBins); ++Bin) {
+    auto First = FunctionValues.begin() + Bin * PointsPerBin;
+    auto Last = First + PointsPerBin;
+    double Mean = std::accumulate(First, Last, 0.0) / PointsPerBin;
+    double Variance(0.0);
+    for (auto it = First; it != Last; ++it)
+      Variance += (*it - Mean) * (*it - Mean);
+    Variance /= (PointsPerBin - 1);
+    Result.Values[Bin] = BinVolumes[Bin] * Mean;
+    // the plain Monte Carlo error is a conservative estimate for
+    // quasi-random points
+    Result.Errors[Bin] = BinVolumes[Bin] * std::sqrt(Variance / PointsPerBin);
+  }
+  return Result;
+}
+
+BinnedExpectation
+integrateIntensityInBins(ComPWA::Intensity &Intensity,
+                         const ComPWA::Data::DataSet &PhspSample,
+                         const std::vector<std::string> &VariableNames,
+                         const std::vector<std::vector<double>> &BinEdges) {
+  if (VariableNames.size() != BinEdges.size())
+    throw ComPWA::BadParameter("PyComPWA::Tools::integrateIntensityInBins(): "
+                               "number of variables and bin edges mismatch!");
+
+  std::vector<const std::vector<double> *> Columns;
+  for (auto const &Name : VariableNames) {
+    auto it = std::find(PhspSample.VariableNames.begin(),
+                        PhspSample.VariableNames.end(), Name);
+    if (it == PhspSample.VariableNames.end())
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::integrateIntensityInBins(): variable " + Name +
+          " not found in phase space sample!");
+    Columns.push_back(
+        &PhspSample.Data[std::distance(PhspSample.VariableNames.begin(), it)]);
+  }
+
+  auto Weights = Intensity.evaluate(PhspSample.Data);
+  double SumOfWeights(0.0);
+  if (PhspSample.Weights.empty()) {
+    SumOfWeights = Weights.size();
+  } else {
+    for (std::size_t i = 0; i < Weights.size(); ++i) {
+      Weights[i] *= PhspSample.Weights[i];
+      SumOfWeights += PhspSample.Weights[i];
+    }
+  }
+  if (SumOfWeights <= 0.0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::integrateIntensityInBins(): "
+                               "phase space sample is empty!");
+
+  auto Result = fillHistogram(Columns, Weights, BinEdges);
+  for (std::size_t Bin = 0; Bin < Result.Values.size(); ++Bin) {
+    Result.Values[Bin] /= SumOfWeights;
+    Result.Errors[Bin] /= SumOfWeights;
+  }
+  LOG(DEBUG) << "PyComPWA::Tools::integrateIntensityInBins(): integrated "
+             << Weights.size() << " phase space events into "
+             << Result.Values.size() << " bins";
+  return Result;
+}
+
+BinnedExpectation
+histogramEvents(const std::vector<std::vector<double>> &Columns,
+                const std::vector<double> &Weights,
+                const std::vector<std::vector<double>> &BinEdges) {
+  std::vector<const std::vector<double> *> ColumnPointers;
+  for (auto const &Column : Columns)
+    ColumnPointers.push_back(&Column);
+  if (Weights.empty() && !Columns.empty())
+    return fillHistogram(ColumnPointers,
+                         std::vector<double>(Columns.front().size(), 1.0),
+                         BinEdges);
+  return fillHistogram(ColumnPointers, Weights, BinEdges);
+}
+
+ChiSquareResult chiSquare(const std::vector<double> &Observed,
+                          const std::vector<double> &ObservedErrors,
+                          const BinnedExpectation &Expected, bool Normalize) {
+  if (Observed.size() != Expected.Values.size() ||
+      Observed.size() != ObservedErrors.size())
+    throw ComPWA::BadParameter("PyComPWA::Tools::chiSquare(): number of "
+                               "observed and expected bins mismatch!");
+  bool HasExpectedErrors = Expected.Errors.size() == Expected.Values.size();
+
+  double Scale(1.0);
+  if (Normalize) {
+    double SumObserved = std::accumulate(Observed.begin(), Observed.end(), 0.0);
+    double SumExpected =
+        std::accumulate(Expected.Values.begin(), Expected.Values.end(), 0.0);
+    if (SumExpected == 0.0)
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::chiSquare(): expectation vanishes in all bins!");
+    Scale = SumObserved / SumExpected;
+  }
+
+  ChiSquareResult Result{0.0, 0, Scale};
+  for (std::size_t Bin = 0; Bin < Observed.size(); ++Bin) {
+    double Variance = ObservedErrors[Bin] * ObservedErrors[Bin];
+    if (HasExpectedErrors)
+      Variance += std::pow(Scale * Expected.Errors[Bin], 2);
+    if (Variance <= 0.0)
+      continue;
+    Result.ChiSquare +=
+        std::pow(Observed[Bin] - Scale * Expected.Values[Bin], 2) / Variance;
+    ++Result.DegreesOfFreedom;
+  }
+  if (Normalize && Result.DegreesOfFreedom > 0)
+    --Result.DegreesOfFreedom;
+  return Result;
+}
+
+} // namespace Tools
+} // namespace PyComPWA
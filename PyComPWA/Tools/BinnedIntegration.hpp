@@ -0,0 +1,75 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_BINNEDINTEGRATION_HPP_
+#define PYCOMPWA_TOOLS_BINNEDINTEGRATION_HPP_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Core/Intensity.hpp"
+#include "Data/DataSet.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+/// Expectation values and their uncertainties for all bins of a histogram.
+/// The bins are stored in row-major order with respect to the bin edges, so
+/// that the result can be reshaped directly into a numpy array.
+struct BinnedExpectation {
+  std::vector<double> Values;
+  std::vector<double> Errors;
+};
+
+struct ChiSquareResult {
+  double ChiSquare;
+  unsigned int DegreesOfFreedom;
+  /// Factor that was applied to the expectation to match the observation.
+  double Scale;
+};
+
+/// A vectorized function of the binned variables. It receives one column
+/// per dimension and returns the function values for all points.
+using BinnedFunction = std::function<std::vector<double>(
+    const std::vector<std::vector<double>> &)>;
+
+/// Integrate \p Function over all bins at once. Every bin is sampled with the
+/// same \p PointsPerBin quasi-random points of a Halton sequence, which are
+/// mapped into the bins in parallel. \p Function is called exactly once with
+/// the points of all bins.
+BinnedExpectation
+integrateFunctionInBins(const BinnedFunction &Function,
+                        const std::vector<std::vector<double>> &BinEdges,
+                        unsigned int PointsPerBin = 64);
+
+/// Integrate \p Intensity over all bins at once, using the phase space sample
+/// as Monte Carlo points. The intensity is evaluated once on the full sample
+/// and the weighted events are histogrammed in parallel. The result is
+/// normalized to the sum of weights of the phase space sample.
+BinnedExpectation
+integrateIntensityInBins(ComPWA::Intensity &Intensity,
+                         const ComPWA::Data::DataSet &PhspSample,
+                         const std::vector<std::string> &VariableNames,
+                         const std::vector<std::vector<double>> &BinEdges);
+
+/// Histogram weighted events. Events outside of the bin edges are ignored.
+BinnedExpectation
+histogramEvents(const std::vector<std::vector<double>> &Columns,
+                const std::vector<double> &Weights,
+                const std::vector<std::vector<double>> &BinEdges);
+
+/// Chi square between an observed histogram and an expectation. Both
+/// uncertainties enter the bin variance, bins with zero variance are skipped.
+/// If \p Normalize is set, the expectation is scaled to the sum of the
+/// observed bin contents and one degree of freedom is subtracted.
+ChiSquareResult chiSquare(const std::vector<double> &Observed,
+                          const std::vector<double> &ObservedErrors,
+                          const BinnedExpectation &Expected,
+                          bool Normalize = true);
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
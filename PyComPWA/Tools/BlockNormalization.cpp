@@ -0,0 +1,224 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "Physics/BuilderXML.hpp"
+
+#include "PyComPWA/Tools/BlockNormalization.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+std::string intensityClass(const boost::property_tree::ptree &Intensity) {
+  return Intensity.get<std::string>("<xmlattr>.Class", "");
+}
+
+void collectBlocks(const boost::property_tree::ptree &Intensity,
+                   std::vector<IntensityBlock> &Blocks) {
+  if (intensityClass(Intensity) == "IncoherentIntensity") {
+    for (auto const &Child : Intensity) {
+      if (Child.first == "Intensity")
+        collectBlocks(Child.second, Blocks);
+    }
+    return;
+  }
+  std::string Name = Intensity.get<std::string>(
+      "<xmlattr>.Name", "block_" + std::to_string(Blocks.size()));
+  Blocks.push_back({Name, Intensity});
+}
+
+} // namespace
+
+std::vector<IntensityBlock>
+findIncoherentBlocks(const boost::property_tree::ptree &Intensity) {
+  const boost::property_tree::ptree *Current = &Intensity;
+  while (intensityClass(*Current) == "StrengthIntensity" ||
+         intensityClass(*Current) == "NormalizedIntensity") {
+    auto Child = Current->find("Intensity");
+    if (Child == Current->not_found())
+      break;
+    Current = &Child->second;
+  }
+  std::vector<IntensityBlock> Blocks;
+  collectBlocks(*Current, Blocks);
+  return Blocks;
+}
+
+BlockNormalization::BlockNormalization(
+    const boost::property_tree::ptree &Model, ComPWA::ParticleList PartL,
+    ComPWA::Kinematics &Kin, const std::vector<ComPWA::Event> &PhspSample) {
+  auto it = Model.find("Intensity");
+  if (it == Model.not_found())
+    throw ComPWA::BadConfig("PyComPWA::Tools::BlockNormalization::"
+                            "BlockNormalization(): Intensity tag not found!");
+  if (PhspSample.empty())
+    throw ComPWA::BadParameter("PyComPWA::Tools::BlockNormalization::"
+                               "BlockNormalization(): empty phase space "
+                               "sample!");
+  auto IntensityBlocks = findIncoherentBlocks(it->second);
+  if (IntensityBlocks.empty())
+    throw ComPWA::BadConfig("PyComPWA::Tools::BlockNormalization::"
+                            "BlockNormalization(): the intensity has no "
+                            "blocks, e.g. an empty incoherent sum!");
+  // The builders register the kinematic variables in the order in which the
+  // amplitudes need them. Building the whole intensity first registers them
+  // in the order of create_intensity(), so the data columns of the blocks
+  // are those of the intensity and of its data sets, independent of the
+  // order of the blocks.
+  ComPWA::Physics::IntensityBuilderXML(PartL, Kin, it->second, PhspSample)
+      .createIntensity();
+  for (auto const &x : IntensityBlocks) {
+    Block NewBlock;
+    NewBlock.Name = x.Name;
+    ComPWA::Physics::IntensityBuilderXML Builder(PartL, Kin, x.Intensity,
+                                                 PhspSample);
+    NewBlock.Intensity =
+        std::make_shared<ComPWA::FunctionTree::FunctionTreeIntensity>(
+            Builder.createIntensity());
+    for (auto const &Parameter : NewBlock.Intensity->getParameters()) {
+      NewBlock.ParameterNames.push_back(Parameter.Name);
+      NewBlock.Values.push_back(Parameter.Value);
+      ParameterNames.insert(Parameter.Name);
+    }
+    Blocks.push_back(std::move(NewBlock));
+  }
+  LOG(INFO) << "BlockNormalization::BlockNormalization(): found "
+            << Blocks.size() << " non-interfering blocks";
+
+  // converted after all blocks are built, so that it has all their variables
+  PhspData = ComPWA::Data::convertEventsToDataSet(PhspSample, Kin);
+  SumOfWeights = PhspData.Weights.empty()
+                     ? PhspSample.size()
+                     : std::accumulate(PhspData.Weights.begin(),
+                                       PhspData.Weights.end(), 0.0);
+}
+
+std::vector<std::string> BlockNormalization::blockNames() const {
+  std::vector<std::string> Names;
+  for (auto const &x : Blocks)
+    Names.push_back(x.Name);
+  return Names;
+}
+
+double BlockNormalization::integral(
+    const std::map<std::string, double> &ParameterValues) {
+  for (auto const &x : ParameterValues) {
+    if (!ParameterNames.count(x.first))
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::BlockNormalization::integral(): parameter " +
+          x.first + " is not part of any block!");
+  }
+
+  for (auto &x : Blocks) {
+    auto Values = x.Values;
+    for (std::size_t j = 0; j < Values.size(); ++j) {
+      auto Value = ParameterValues.find(x.ParameterNames[j]);
+      if (Value != ParameterValues.end())
+        Values[j] = Value->second;
+    }
+    if (x.Evaluated && Values == x.Values)
+      continue;
+    x.Intensity->updateParametersFrom(Values);
+    auto Intensities = x.Intensity->evaluate(PhspData.Data);
+    double Sum(0.0);
+    for (std::size_t j = 0; j < Intensities.size(); ++j)
+      Sum += PhspData.Weights.empty() ? Intensities[j]
+                                      : PhspData.Weights[j] * Intensities[j];
+    x.Integral = Sum / SumOfWeights;
+    x.Values = std::move(Values);
+    x.Evaluated = true;
+    ++NumberOfBlockEvaluations;
+  }
+
+  double Integral(0.0);
+  for (auto const &x : Blocks)
+    Integral += x.Integral;
+  return Integral;
+}
+
+std::vector<double> BlockNormalization::blockIntegrals() const {
+  std::vector<double> Integrals;
+  for (auto const &x : Blocks)
+    Integrals.push_back(x.Integral);
+  return Integrals;
+}
+
+BlockNormalizedLogLikelihood::BlockNormalizedLogLikelihood(
+    std::shared_ptr<BlockNormalization> Normalization_,
+    ComPWA::Data::DataSet DataSample_,
+    const ComPWA::FitParameterList &FitParameters)
+    : Normalization(std::move(Normalization_)),
+      DataSample(std::move(DataSample_)) {
+  if (!Normalization)
+    throw ComPWA::BadParameter("PyComPWA::Tools::BlockNormalizedLogLikelihood"
+                               "::BlockNormalizedLogLikelihood(): no "
+                               "normalization!");
+  if (DataSample.Data.empty() || DataSample.Data.front().empty())
+    throw ComPWA::BadParameter("PyComPWA::Tools::BlockNormalizedLogLikelihood"
+                               "::BlockNormalizedLogLikelihood(): empty data "
+                               "sample!");
+  if (DataSample.VariableNames != Normalization->PhspData.VariableNames)
+    throw ComPWA::BadParameter("PyComPWA::Tools::BlockNormalizedLogLikelihood"
+                               "::BlockNormalizedLogLikelihood(): the data "
+                               "sample has other variables than the phase "
+                               "space sample!");
+  SumOfWeights = DataSample.Weights.empty()
+                     ? DataSample.Data.front().size()
+                     : std::accumulate(DataSample.Weights.begin(),
+                                       DataSample.Weights.end(), 0.0);
+  for (auto const &x : FitParameters)
+    Parameters.push_back({x.Name, x.Value});
+  BlockIntensities.resize(Normalization->Blocks.size());
+  BlockValues.resize(Normalization->Blocks.size());
+}
+
+double BlockNormalizedLogLikelihood::evaluate() noexcept {
+  std::map<std::string, double> Values;
+  for (auto const &x : Parameters) {
+    if (Normalization->hasParameter(x.Name))
+      Values[x.Name] = x.Value;
+  }
+  double Integral = Normalization->integral(Values);
+
+  // the block intensities have the new parameter values now
+  auto &Blocks = Normalization->Blocks;
+  for (std::size_t i = 0; i < Blocks.size(); ++i) {
+    if (!BlockIntensities[i].empty() && BlockValues[i] == Blocks[i].Values)
+      continue;
+    BlockIntensities[i] = Blocks[i].Intensity->evaluate(DataSample.Data);
+    BlockValues[i] = Blocks[i].Values;
+  }
+
+  double LogLikelihood(0.0);
+  for (std::size_t j = 0; j < DataSample.Data.front().size(); ++j) {
+    double Intensity(0.0);
+    for (auto const &x : BlockIntensities)
+      Intensity += x[j];
+    LogLikelihood -= DataSample.Weights.empty()
+                         ? std::log(Intensity)
+                         : DataSample.Weights[j] * std::log(Intensity);
+  }
+  return LogLikelihood + SumOfWeights * std::log(Integral);
+}
+
+void BlockNormalizedLogLikelihood::updateParametersFrom(
+    const std::vector<double> &Values) {
+  if (Values.size() != Parameters.size())
+    throw ComPWA::BadParameter("PyComPWA::Tools::BlockNormalizedLogLikelihood"
+                               "::updateParametersFrom(): expected " +
+                               std::to_string(Parameters.size()) +
+                               " parameter values!");
+  for (std::size_t i = 0; i < Values.size(); ++i)
+    Parameters[i].Value = Values[i];
+}
+
+} // namespace Tools
+} // namespace PyComPWA
@@ -0,0 +1,160 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_BLOCKNORMALIZATION_HPP_
+#define PYCOMPWA_TOOLS_BLOCKNORMALIZATION_HPP_
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include "Core/Event.hpp"
+#include "Core/FitParameter.hpp"
+#include "Core/FunctionTree/FunctionTreeIntensity.hpp"
+#include "Core/Kinematics.hpp"
+#include "Core/Particle.hpp"
+#include "Data/DataSet.hpp"
+#include "Estimator/Estimator.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+struct IntensityBlock {
+  std::string Name;
+  /// Content of the Intensity element of the block.
+  boost::property_tree::ptree Intensity;
+};
+
+/// Splits the Intensity element \p Intensity of a model into the intensities
+/// which do not interfere with each other. These are the terms of the
+/// incoherent sums, e.g. the coherent intensities of the different external
+/// helicities, below StrengthIntensity and NormalizedIntensity wrappers.
+/// Nested incoherent sums are flattened. An intensity without an incoherent
+/// sum is a single block.
+std::vector<IntensityBlock>
+findIncoherentBlocks(const boost::property_tree::ptree &Intensity);
+
+///
+/// \class BlockNormalization
+/// Normalization integral of an intensity over a phase space sample, computed
+/// as the sum of the integrals of its non-interfering blocks, see
+/// findIncoherentBlocks(). The interference terms between blocks vanish, so
+/// each block is built and evaluated on its own. A block is evaluated again
+/// only if one of its parameters changed, e.g. if a fit varies the couplings
+/// of one helicity configuration, the integrals of all others are reused.
+///
+/// Parameters of the wrappers and of the incoherent sums themselves, e.g. a
+/// strength, are not part of the integral. Throws ComPWA::BadConfig if the
+/// intensity has no blocks.
+///
+/// The blocks are evaluated one after another. The branches of the
+/// incoherent sums in the tree of the model are not scheduled as parallel
+/// tasks, as the FunctionTree of ComPWA evaluates its nodes sequentially.
+///
+class BlockNormalization {
+public:
+  BlockNormalization(const boost::property_tree::ptree &Model,
+                     ComPWA::ParticleList PartL, ComPWA::Kinematics &Kin,
+                     const std::vector<ComPWA::Event> &PhspSample);
+
+  std::size_t numberOfBlocks() const { return Blocks.size(); }
+  std::vector<std::string> blockNames() const;
+
+  bool hasParameter(const std::string &Name) const {
+    return ParameterNames.count(Name);
+  }
+
+  /// Integral with the parameter values \p ParameterValues, all other
+  /// parameters keep their values. Throws if a parameter is not part of any
+  /// block.
+  double integral(const std::map<std::string, double> &ParameterValues =
+                      std::map<std::string, double>());
+
+  /// Integrals of the blocks of the last call of integral().
+  std::vector<double> blockIntegrals() const;
+
+  /// Number of block integrals computed so far.
+  std::size_t numberOfBlockEvaluations() const {
+    return NumberOfBlockEvaluations;
+  }
+
+private:
+  friend class BlockNormalizedLogLikelihood;
+
+  struct Block {
+    std::string Name;
+    std::shared_ptr<ComPWA::FunctionTree::FunctionTreeIntensity> Intensity;
+    std::vector<std::string> ParameterNames;
+    /// Parameter values of the last evaluation, initially those of the
+    /// model.
+    std::vector<double> Values;
+    double Integral = 0.0;
+    bool Evaluated = false;
+  };
+
+  std::vector<Block> Blocks;
+  /// Parameters of all blocks.
+  std::set<std::string> ParameterNames;
+  ComPWA::Data::DataSet PhspData;
+  double SumOfWeights;
+  std::size_t NumberOfBlockEvaluations = 0;
+};
+
+///
+/// \class BlockNormalizedLogLikelihood
+/// Unbinned negative log likelihood of a data sample, which is normalized
+/// with a BlockNormalization:
+/// \f[
+///   -\log L = -\sum_i w_i \log I(x_i) + \sum_i w_i \log \int I,
+/// \f]
+/// where the intensity \f$I\f$ is the sum of the blocks. It can be minimized
+/// instead of the FunctionTree estimator of the same model, e.g. with
+/// ComPWA::Optimizer::Minuit2::MinuitIF. Like the integrals, the block
+/// intensities of the data sample are only evaluated again if one of the
+/// parameters of the block changed.
+///
+/// The parameters are those of \p Parameters in the same order, e.g. the
+/// FitParameterList of the FunctionTree estimator. Parameters which are not
+/// part of any block, e.g. a strength, cancel in the likelihood.
+///
+/// The estimator is opt-in. The standard fit minimizes the FunctionTree
+/// estimator of createMinLogLHFunctionTreeEstimator(), which is unchanged.
+/// \p DataSample has to be converted with the kinematics of the
+/// BlockNormalization after the normalization was created.
+///
+class BlockNormalizedLogLikelihood
+    : public ComPWA::Estimator::Estimator<double> {
+public:
+  BlockNormalizedLogLikelihood(
+      std::shared_ptr<BlockNormalization> Normalization,
+      ComPWA::Data::DataSet DataSample,
+      const ComPWA::FitParameterList &Parameters);
+
+  double evaluate() noexcept final;
+
+  void updateParametersFrom(const std::vector<double> &Values) final;
+  std::vector<ComPWA::Parameter> getParameters() const final {
+    return Parameters;
+  }
+
+private:
+  std::shared_ptr<BlockNormalization> Normalization;
+  ComPWA::Data::DataSet DataSample;
+  double SumOfWeights;
+  std::vector<ComPWA::Parameter> Parameters;
+  /// Intensities of each block for the data sample and the parameter values
+  /// they were evaluated with.
+  std::vector<std::vector<double>> BlockIntensities;
+  std::vector<std::vector<double>> BlockValues;
+};
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
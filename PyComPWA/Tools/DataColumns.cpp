@@ -0,0 +1,48 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+
+#include "Core/Exceptions.hpp"
+
+#include "PyComPWA/Tools/DataColumns.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+std::vector<ColumnView>
+selectColumns(const ComPWA::Data::DataSet &Sample,
+              const std::vector<std::string> &VariableNames) {
+  std::vector<ColumnView> Columns;
+  for (auto const &Name : VariableNames) {
+    auto it = std::find(Sample.VariableNames.begin(),
+                        Sample.VariableNames.end(), Name);
+    if (it == Sample.VariableNames.end())
+      throw ComPWA::BadParameter("PyComPWA::Tools::selectColumns(): variable " +
+                                 Name + " is not part of the data set!");
+    Columns.push_back(makeColumnView(
+        Sample.Data[std::distance(Sample.VariableNames.begin(), it)]));
+  }
+  return Columns;
+}
+
+std::size_t checkColumnSizes(const std::vector<ColumnView> &Columns,
+                             const ColumnView &Weights) {
+  if (Columns.empty())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::checkColumnSizes(): no columns given!");
+  std::size_t Size = Columns.front().Size;
+  for (auto const &Column : Columns) {
+    if (Column.Size != Size)
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::checkColumnSizes(): columns differ in length!");
+  }
+  if (Weights.Size != 0 && Weights.Size != Size)
+    throw ComPWA::BadParameter("PyComPWA::Tools::checkColumnSizes(): "
+                               "weights and columns differ in length!");
+  return Size;
+}
+
+} // namespace Tools
+} // namespace PyComPWA
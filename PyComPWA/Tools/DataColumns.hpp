@@ -0,0 +1,45 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_DATACOLUMNS_HPP_
+#define PYCOMPWA_TOOLS_DATACOLUMNS_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Data/DataSet.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+/// Non-owning view of a column of doubles. It allows the native tools to
+/// work on DataSet columns and numpy arrays alike, without copying.
+struct ColumnView {
+  const double *Data;
+  std::size_t Size;
+
+  double operator[](std::size_t i) const { return Data[i]; }
+  std::size_t size() const { return Size; }
+};
+
+inline ColumnView makeColumnView(const std::vector<double> &Column) {
+  return ColumnView{Column.data(), Column.size()};
+}
+
+/// Views of the columns \p VariableNames of \p Sample. Throws if a variable is
+/// not part of the sample.
+std::vector<ColumnView>
+selectColumns(const ComPWA::Data::DataSet &Sample,
+              const std::vector<std::string> &VariableNames);
+
+/// Checks that all columns and the weights have the same length and returns
+/// it. A weight view of size zero stands for unit weights.
+std::size_t checkColumnSizes(const std::vector<ColumnView> &Columns,
+                             const ColumnView &Weights);
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
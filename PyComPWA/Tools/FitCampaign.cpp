@@ -0,0 +1,152 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "Data/DataSet.hpp"
+#include "Estimator/MinLogLH/MinLogLH.hpp"
+#include "Physics/BuilderXML.hpp"
+
+#include "PyComPWA/Tools/FitCampaign.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+FitCampaign::FitCampaign(ComPWA::ParticleList PartL,
+                         std::vector<ComPWA::Event> DataSample,
+                         std::vector<ComPWA::Event> PhspSample)
+    : PartL(std::move(PartL)), DataSample(std::move(DataSample)),
+      PhspSample(std::move(PhspSample)) {
+  if (this->DataSample.empty())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::FitCampaign::FitCampaign(): empty data sample!");
+}
+
+void FitCampaign::addHypothesis(const std::string &Name,
+                                const boost::property_tree::ptree &Model) {
+  auto KinematicsSection = Model.find("HelicityKinematics");
+  if (KinematicsSection == Model.not_found())
+    throw ComPWA::BadConfig("PyComPWA::Tools::FitCampaign::addHypothesis(): "
+                            "HelicityKinematics tag not found in hypothesis " +
+                            Name + "!");
+  auto IntensitySection = Model.find("Intensity");
+  if (IntensitySection == Model.not_found())
+    throw ComPWA::BadConfig("PyComPWA::Tools::FitCampaign::addHypothesis(): "
+                            "Intensity tag not found in hypothesis " +
+                            Name + "!");
+  // the builder registers the subsystems of the intensity at the kinematics,
+  // which is therefore not shared with other hypotheses
+  auto Kinematics = std::make_shared<
+      ComPWA::Physics::HelicityFormalism::HelicityKinematics>(
+      ComPWA::Physics::createHelicityKinematics(PartL,
+                                                KinematicsSection->second));
+  ComPWA::Physics::IntensityBuilderXML Builder(
+      PartL, *Kinematics, IntensitySection->second, PhspSample);
+  Hypotheses.push_back(
+      {Name, Kinematics,
+       std::make_shared<ComPWA::FunctionTree::FunctionTreeIntensity>(
+           Builder.createIntensity())});
+  Results.clear();
+}
+
+HypothesisFitResult FitCampaign::fit(const Hypothesis &Hypothesis) const {
+  auto DataPoints =
+      ComPWA::Data::convertEventsToDataSet(DataSample, *Hypothesis.Kinematics);
+  auto Estimator = ComPWA::Estimator::createMinLogLHFunctionTreeEstimator(
+      *Hypothesis.Intensity, DataPoints);
+  ComPWA::Optimizer::Minuit2::MinuitIF Optimizer;
+  HypothesisFitResult Result;
+  Result.Name = Hypothesis.Name;
+  Result.Result = Optimizer.optimize(Estimator.first, Estimator.second);
+  Result.NumberOfFreeParameters = std::count_if(
+      Estimator.second.begin(), Estimator.second.end(),
+      [](const ComPWA::FitParameter<double> &x) { return !x.IsFixed; });
+  Result.NegativeLogLikelihood = Result.Result.FinalEstimatorValue;
+  double LogNumberOfEvents = std::log(double(DataSample.size()));
+  Result.AIC = 2.0 * Result.NumberOfFreeParameters +
+               2.0 * Result.NegativeLogLikelihood;
+  Result.BIC = Result.NumberOfFreeParameters * LogNumberOfEvents +
+               2.0 * Result.NegativeLogLikelihood;
+  return Result;
+}
+
+const std::vector<HypothesisFitResult> &FitCampaign::run(int NumberOfThreads) {
+  if (Hypotheses.empty())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::FitCampaign::run(): no hypotheses given!");
+#ifdef _OPENMP
+  if (NumberOfThreads <= 0)
+    NumberOfThreads = omp_get_max_threads();
+#else
+  NumberOfThreads = 1;
+#endif
+  LOG(INFO) << "FitCampaign::run(): fitting " << Hypotheses.size()
+            << " hypotheses with " << NumberOfThreads << " threads";
+
+  std::vector<HypothesisFitResult> NewResults(Hypotheses.size());
+  std::vector<std::exception_ptr> Errors(Hypotheses.size());
+  long NumberOfHypotheses = Hypotheses.size();
+#pragma omp parallel for schedule(dynamic, 1) num_threads(NumberOfThreads)
+  for (long i = 0; i < NumberOfHypotheses; ++i) {
+    // exceptions must not leave the parallel region
+    try {
+      NewResults[i] = fit(Hypotheses[i]);
+    } catch (...) {
+      Errors[i] = std::current_exception();
+    }
+  }
+  for (auto const &Error : Errors) {
+    if (Error)
+      std::rethrow_exception(Error);
+  }
+  Results = std::move(NewResults);
+  return Results;
+}
+
+std::string FitCampaign::table() const {
+  if (Results.empty())
+    return "";
+  std::vector<const HypothesisFitResult *> Sorted;
+  for (auto const &x : Results)
+    Sorted.push_back(&x);
+  std::stable_sort(
+      Sorted.begin(), Sorted.end(),
+      [](const HypothesisFitResult *a, const HypothesisFitResult *b) {
+        return a->AIC < b->AIC;
+      });
+  double BestBIC = Sorted.front()->BIC;
+  for (auto x : Sorted)
+    BestBIC = std::min(BestBIC, x->BIC);
+
+  std::size_t NameWidth = 10;
+  for (auto x : Sorted)
+    NameWidth = std::max(NameWidth, x->Name.size());
+  std::ostringstream Table;
+  Table << std::left << std::setw(NameWidth) << "hypothesis" << std::right
+        << std::setw(6) << "k" << std::setw(16) << "-log L" << std::setw(14)
+        << "AIC" << std::setw(12) << "dAIC" << std::setw(14) << "BIC"
+        << std::setw(12) << "dBIC" << "\n";
+  Table << std::fixed << std::setprecision(3);
+  for (auto x : Sorted) {
+    Table << std::left << std::setw(NameWidth) << x->Name << std::right
+          << std::setw(6) << x->NumberOfFreeParameters << std::setw(16)
+          << x->NegativeLogLikelihood << std::setw(14) << x->AIC
+          << std::setw(12) << x->AIC - Sorted.front()->AIC << std::setw(14)
+          << x->BIC << std::setw(12) << x->BIC - BestBIC << "\n";
+  }
+  return Table.str();
+}
+
+} // namespace Tools
+} // namespace PyComPWA
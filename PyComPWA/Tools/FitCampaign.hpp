@@ -0,0 +1,93 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_FITCAMPAIGN_HPP_
+#define PYCOMPWA_TOOLS_FITCAMPAIGN_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include "Core/Event.hpp"
+#include "Core/FunctionTree/FunctionTreeIntensity.hpp"
+#include "Core/Particle.hpp"
+#include "Optimizer/Minuit2/MinuitIF.hpp"
+#include "Physics/HelicityFormalism/HelicityKinematics.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+struct HypothesisFitResult {
+  std::string Name;
+  std::size_t NumberOfFreeParameters;
+  double NegativeLogLikelihood;
+  /// Akaike information criterion \f$2k - 2\ln L\f$.
+  double AIC;
+  /// Bayesian information criterion \f$k\ln n - 2\ln L\f$ with the number of
+  /// data events n.
+  double BIC;
+  ComPWA::Optimizer::Minuit2::MinuitResult Result;
+};
+
+///
+/// \class FitCampaign
+/// Fits several hypotheses, i.e. models which differ in their intensity, to
+/// the same data sample for model selection. Each hypothesis gets its own
+/// helicity kinematics from the HelicityKinematics section of its model, so
+/// the intensities, the converted data samples, the estimators and the
+/// Minuit2 instances of different hypotheses share no state. The fits are
+/// therefore run in parallel, one hypothesis per thread.
+///
+/// The function trees of the hypotheses are independent, so amplitudes
+/// which several hypotheses have in common are evaluated by each of them;
+/// there is no pool of shared amplitudes.
+///
+class FitCampaign {
+public:
+  FitCampaign(ComPWA::ParticleList PartL,
+              std::vector<ComPWA::Event> DataSample,
+              std::vector<ComPWA::Event> PhspSample);
+
+  /// Builds the kinematics and the intensity of the HelicityKinematics and
+  /// Intensity sections of \p Model.
+  void addHypothesis(const std::string &Name,
+                     const boost::property_tree::ptree &Model);
+
+  std::size_t numberOfHypotheses() const { return Hypotheses.size(); }
+
+  /// Fits all hypotheses with Minuit2, using all threads if \p
+  /// NumberOfThreads is not positive. The results are in the order of the
+  /// hypotheses.
+  const std::vector<HypothesisFitResult> &run(int NumberOfThreads = 0);
+
+  const std::vector<HypothesisFitResult> &results() const { return Results; }
+
+  /// Table of the results sorted by AIC, with the differences of AIC and BIC
+  /// to the best hypothesis.
+  std::string table() const;
+
+private:
+  struct Hypothesis {
+    std::string Name;
+    std::shared_ptr<ComPWA::Physics::HelicityFormalism::HelicityKinematics>
+        Kinematics;
+    std::shared_ptr<ComPWA::FunctionTree::FunctionTreeIntensity> Intensity;
+  };
+
+  HypothesisFitResult fit(const Hypothesis &Hypothesis) const;
+
+  ComPWA::ParticleList PartL;
+  std::vector<ComPWA::Event> DataSample;
+  std::vector<ComPWA::Event> PhspSample;
+  std::vector<Hypothesis> Hypotheses;
+  std::vector<HypothesisFitResult> Results;
+};
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
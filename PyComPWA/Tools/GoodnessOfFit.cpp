@@ -0,0 +1,312 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/Tools/GoodnessOfFit.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+/// Pairs further apart than this number of sigmas are neglected by the point
+/// to point dissimilarity test.
+const double GaussianCutoff = 5.0;
+
+double weightAt(const ColumnView &Weights, std::size_t i) {
+  return Weights.size() ? Weights[i] : 1.0;
+}
+
+/// The labels followed by \p NumberOfPermutations random permutations.
+std::vector<std::vector<char>> permuteLabels(const std::vector<char> &Labels,
+                                             unsigned int NumberOfPermutations,
+                                             unsigned int Seed) {
+  std::mt19937 Generator(Seed);
+  std::vector<std::vector<char>> Permutations{Labels};
+  for (unsigned int p = 0; p < NumberOfPermutations; ++p) {
+    Permutations.push_back(Labels);
+    std::shuffle(Permutations.back().begin(), Permutations.back().end(),
+                 Generator);
+  }
+  return Permutations;
+}
+
+/// The observed statistic is stored first, followed by the statistics of the
+/// permutations.
+GoodnessOfFitResult makeResult(const std::vector<double> &Statistics) {
+  std::size_t Larger = std::count_if(
+      Statistics.begin() + 1, Statistics.end(),
+      [&Statistics](double x) { return x >= Statistics.front(); });
+  return GoodnessOfFitResult{
+      Statistics.front(), (1.0 + Larger) / Statistics.size(),
+      static_cast<unsigned int>(Statistics.size() - 1)};
+}
+
+} // namespace
+
+UnbinnedGoodnessOfFit::UnbinnedGoodnessOfFit(
+    const std::vector<ColumnView> &DataColumns, const ColumnView &DataWeights,
+    const std::vector<ColumnView> &ModelColumns,
+    const ColumnView &ModelWeights, bool Standardize) {
+  init(DataColumns, DataWeights, ModelColumns, ModelWeights, Standardize);
+}
+
+UnbinnedGoodnessOfFit::UnbinnedGoodnessOfFit(
+    const ComPWA::Data::DataSet &DataSample,
+    const ComPWA::Data::DataSet &ModelSample,
+    std::vector<std::string> VariableNames, bool Standardize) {
+  if (VariableNames.empty())
+    VariableNames = DataSample.VariableNames;
+  init(selectColumns(DataSample, VariableNames),
+       makeColumnView(DataSample.Weights),
+       selectColumns(ModelSample, VariableNames),
+       makeColumnView(ModelSample.Weights), Standardize);
+}
+
+void UnbinnedGoodnessOfFit::init(const std::vector<ColumnView> &DataColumns,
+                                 const ColumnView &DataWeights,
+                                 const std::vector<ColumnView> &ModelColumns,
+                                 const ColumnView &ModelWeights,
+                                 bool Standardize) {
+  if (DataColumns.size() != ModelColumns.size())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::UnbinnedGoodnessOfFit: data and model samples have "
+        "a different number of variables!");
+  NumberOfDataEvents = checkColumnSizes(DataColumns, DataWeights);
+  std::size_t NumberOfModelEvents =
+      checkColumnSizes(ModelColumns, ModelWeights);
+  if (NumberOfDataEvents < 2 || NumberOfModelEvents < 2)
+    throw ComPWA::BadParameter("PyComPWA::Tools::UnbinnedGoodnessOfFit: data "
+                               "and model samples need at least two events!");
+  std::size_t Dimension = DataColumns.size();
+  std::size_t NumberOfEvents = NumberOfDataEvents + NumberOfModelEvents;
+
+  std::vector<double> Scales(Dimension, 1.0);
+  if (Standardize) {
+    for (std::size_t d = 0; d < Dimension; ++d) {
+      double SumOfWeights(0.0), Mean(0.0), Variance(0.0);
+      for (std::size_t i = 0; i < NumberOfDataEvents; ++i) {
+        double w = weightAt(DataWeights, i);
+        SumOfWeights += w;
+        Mean += w * DataColumns[d][i];
+      }
+      Mean /= SumOfWeights;
+      for (std::size_t i = 0; i < NumberOfDataEvents; ++i)
+        Variance += weightAt(DataWeights, i) *
+                    (DataColumns[d][i] - Mean) * (DataColumns[d][i] - Mean);
+      Variance /= SumOfWeights;
+      if (Variance > 0.0)
+        Scales[d] = 1.0 / std::sqrt(Variance);
+    }
+  }
+
+  std::vector<double> Points(NumberOfEvents * Dimension);
+  Weights.resize(NumberOfEvents);
+  Labels.resize(NumberOfEvents);
+  for (std::size_t i = 0; i < NumberOfEvents; ++i) {
+    bool IsData = i < NumberOfDataEvents;
+    std::size_t j = IsData ? i : i - NumberOfDataEvents;
+    auto const &Columns = IsData ? DataColumns : ModelColumns;
+    for (std::size_t d = 0; d < Dimension; ++d)
+      Points[i * Dimension + d] = Columns[d][j] * Scales[d];
+    Weights[i] = weightAt(IsData ? DataWeights : ModelWeights, j);
+    Labels[i] = IsData;
+  }
+  Tree = std::make_unique<KDTree>(std::move(Points), Dimension);
+}
+
+std::vector<double>
+UnbinnedGoodnessOfFit::signedWeights(const std::vector<char> &IsData) const {
+  double DataWeight(0.0), ModelWeight(0.0);
+  for (std::size_t i = 0; i < Weights.size(); ++i)
+    (IsData[i] ? DataWeight : ModelWeight) += Weights[i];
+  if (DataWeight == 0.0 || ModelWeight == 0.0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::UnbinnedGoodnessOfFit: the "
+                               "total weight of a sample is zero!");
+  std::vector<double> Result(Weights.size());
+  for (std::size_t i = 0; i < Weights.size(); ++i)
+    Result[i] = IsData[i] ? Weights[i] / DataWeight : -Weights[i] / ModelWeight;
+  return Result;
+}
+
+namespace {
+
+/// Computes \f$\sum_{i<j} s_i s_j \psi_{ij}\f$ for the observed and all
+/// permuted labels at once, so that the distance function is evaluated only
+/// once per pair. \p SignedWeights holds the weights of all label sets for
+/// event i at [i * NumberOfSets, (i + 1) * NumberOfSets).
+/// \p ForEachPartner(i, Function) calls Function(j, Psi) for all relevant
+/// partners j > i of event i.
+template <typename PartnerLoop>
+std::vector<double> pairSums(const std::vector<double> &SignedWeights,
+                             std::size_t NumberOfSets,
+                             std::size_t NumberOfEvents,
+                             PartnerLoop ForEachPartner) {
+  std::vector<double> Sums(NumberOfSets, 0.0);
+#pragma omp parallel
+  {
+    std::vector<double> LocalSums(NumberOfSets, 0.0);
+    std::vector<double> PartnerSums(NumberOfSets);
+#pragma omp for schedule(dynamic, 64)
+    for (long i = 0; i < static_cast<long>(NumberOfEvents); ++i) {
+      std::fill(PartnerSums.begin(), PartnerSums.end(), 0.0);
+      double *Partner = PartnerSums.data();
+      ForEachPartner(i, [&](std::size_t j, double Psi) {
+        const double *s = &SignedWeights[j * NumberOfSets];
+        for (std::size_t k = 0; k < NumberOfSets; ++k)
+          Partner[k] += s[k] * Psi;
+      });
+      const double *s = &SignedWeights[i * NumberOfSets];
+      for (std::size_t k = 0; k < NumberOfSets; ++k)
+        LocalSums[k] += s[k] * PartnerSums[k];
+    }
+#pragma omp critical
+    for (std::size_t k = 0; k < NumberOfSets; ++k)
+      Sums[k] += LocalSums[k];
+  }
+  return Sums;
+}
+
+std::vector<double>
+interleave(const std::vector<std::vector<double>> &SignedWeights) {
+  std::size_t NumberOfSets = SignedWeights.size();
+  std::size_t NumberOfEvents = SignedWeights.front().size();
+  std::vector<double> Result(NumberOfSets * NumberOfEvents);
+  for (std::size_t k = 0; k < NumberOfSets; ++k)
+    for (std::size_t i = 0; i < NumberOfEvents; ++i)
+      Result[i * NumberOfSets + k] = SignedWeights[k][i];
+  return Result;
+}
+
+} // namespace
+
+GoodnessOfFitResult
+UnbinnedGoodnessOfFit::energyTest(unsigned int NumberOfPermutations,
+                                  unsigned int Seed, double Epsilon) const {
+  LOG(INFO) << "UnbinnedGoodnessOfFit::energyTest(): summing over "
+            << Weights.size() * (Weights.size() - 1) / 2 << " pairs";
+  std::vector<std::vector<double>> SignedWeights;
+  for (auto const &x : permuteLabels(Labels, NumberOfPermutations, Seed))
+    SignedWeights.push_back(signedWeights(x));
+
+  const KDTree &Points = *Tree;
+  std::size_t Dimension = Points.dimension();
+  std::size_t NumberOfEvents = Points.size();
+  auto Statistics = pairSums(
+      interleave(SignedWeights), SignedWeights.size(), NumberOfEvents,
+      [&](std::size_t i, auto &&f) {
+        const double *a = Points.point(i);
+        for (std::size_t j = i + 1; j < NumberOfEvents; ++j) {
+          const double *b = Points.point(j);
+          double DistanceSquared(0.0);
+          for (std::size_t d = 0; d < Dimension; ++d)
+            DistanceSquared += (a[d] - b[d]) * (a[d] - b[d]);
+          f(j, -std::log(std::sqrt(DistanceSquared) + Epsilon));
+        }
+      });
+  return makeResult(Statistics);
+}
+
+GoodnessOfFitResult UnbinnedGoodnessOfFit::pointToPointDissimilarity(
+    double Sigma, unsigned int NumberOfPermutations, unsigned int Seed) const {
+  if (Sigma <= 0.0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::UnbinnedGoodnessOfFit::"
+                               "pointToPointDissimilarity(): sigma has to be "
+                               "positive!");
+  std::vector<std::vector<double>> SignedWeights;
+  for (auto const &x : permuteLabels(Labels, NumberOfPermutations, Seed))
+    SignedWeights.push_back(signedWeights(x));
+
+  const KDTree &Points = *Tree;
+  auto Statistics = pairSums(
+      interleave(SignedWeights), SignedWeights.size(), Points.size(),
+      [&](std::size_t i, auto &&f) {
+        std::vector<std::pair<std::size_t, double>> Neighbours;
+        Points.pointsInRadius(Points.point(i), GaussianCutoff * Sigma,
+                              Neighbours);
+        for (auto const &x : Neighbours) {
+          if (x.first > i)
+            f(x.first, std::exp(-0.5 * x.second / (Sigma * Sigma)));
+        }
+      });
+  return makeResult(Statistics);
+}
+
+GoodnessOfFitResult UnbinnedGoodnessOfFit::mixedSampleNearestNeighbours(
+    unsigned int K, unsigned int NumberOfPermutations,
+    unsigned int Seed) const {
+  if (K == 0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::UnbinnedGoodnessOfFit::"
+                               "mixedSampleNearestNeighbours(): K has to be "
+                               "positive!");
+  // The test compares two samples of unweighted events. Weighted events are
+  // therefore accepted with a probability proportional to their weight.
+  double MaximalWeights[2] = {0.0, 0.0};
+  for (std::size_t i = 0; i < Weights.size(); ++i) {
+    if (Weights[i] < 0.0)
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::UnbinnedGoodnessOfFit::"
+          "mixedSampleNearestNeighbours(): negative weights are not "
+          "supported!");
+    MaximalWeights[Labels[i] != 0] =
+        std::max(MaximalWeights[Labels[i] != 0], Weights[i]);
+  }
+  std::mt19937 Generator(Seed);
+  std::uniform_real_distribution<double> Uniform(0.0, 1.0);
+  std::size_t Dimension = Tree->dimension();
+  std::vector<double> Coordinates;
+  std::vector<char> SelectedLabels;
+  for (std::size_t i = 0; i < Weights.size(); ++i) {
+    if (Weights[i] < Uniform(Generator) * MaximalWeights[Labels[i] != 0])
+      continue;
+    Coordinates.insert(Coordinates.end(), Tree->point(i),
+                       Tree->point(i) + Dimension);
+    SelectedLabels.push_back(Labels[i]);
+  }
+  std::size_t NumberOfEvents = SelectedLabels.size();
+  std::size_t NumberOfSelectedDataEvents =
+      std::count(SelectedLabels.begin(), SelectedLabels.end(), 1);
+  if (NumberOfSelectedDataEvents < 2 ||
+      NumberOfEvents - NumberOfSelectedDataEvents < 2)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::UnbinnedGoodnessOfFit::"
+        "mixedSampleNearestNeighbours(): too few events after unweighting!");
+  LOG(INFO) << "UnbinnedGoodnessOfFit::mixedSampleNearestNeighbours(): using "
+            << NumberOfSelectedDataEvents << " data and "
+            << NumberOfEvents - NumberOfSelectedDataEvents
+            << " unweighted model events";
+
+  KDTree Points(std::move(Coordinates), Dimension);
+  K = std::min<std::size_t>(K, NumberOfEvents - 1);
+  std::vector<std::size_t> Neighbours(NumberOfEvents * K);
+#pragma omp parallel for schedule(dynamic, 256)
+  for (long i = 0; i < static_cast<long>(NumberOfEvents); ++i) {
+    auto x = Points.nearestNeighbours(i, K);
+    std::copy(x.begin(), x.end(), Neighbours.begin() + i * K);
+  }
+
+  auto Permutations =
+      permuteLabels(SelectedLabels, NumberOfPermutations, Generator());
+  std::vector<double> Statistics(Permutations.size());
+#pragma omp parallel for schedule(static)
+  for (long p = 0; p < static_cast<long>(Permutations.size()); ++p) {
+    auto const &IsData = Permutations[p];
+    std::size_t SameSample(0);
+    for (std::size_t i = 0; i < NumberOfEvents; ++i) {
+      for (std::size_t k = 0; k < K; ++k)
+        SameSample += IsData[Neighbours[i * K + k]] == IsData[i];
+    }
+    Statistics[p] = static_cast<double>(SameSample) / (K * NumberOfEvents);
+  }
+  return makeResult(Statistics);
+}
+
+} // namespace Tools
+} // namespace PyComPWA
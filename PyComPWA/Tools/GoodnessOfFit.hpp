@@ -0,0 +1,98 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_GOODNESSOFFIT_HPP_
+#define PYCOMPWA_TOOLS_GOODNESSOFFIT_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Data/DataSet.hpp"
+#include "PyComPWA/Tools/DataColumns.hpp"
+#include "PyComPWA/Tools/KDTree.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+struct GoodnessOfFitResult {
+  double Statistic;
+  /// Fraction of label permutations with a statistic at least as large as the
+  /// observed one. Large statistics indicate a bad fit for all tests.
+  double PValue;
+  unsigned int NumberOfPermutations;
+};
+
+///
+/// \class UnbinnedGoodnessOfFit
+/// Unbinned two-sample tests of a data sample against a weighted model sample,
+/// typically the phase space sample weighted with the fitted intensity.
+/// Both samples are pooled and the p-values are estimated by randomly
+/// permuting the sample labels of the pooled events. The weights move with
+/// their events, so for weighted model samples the p-values are approximate.
+///
+/// If \p Standardize is set, each variable is divided by its standard
+/// deviation in the data sample, so that the distances do not depend on the
+/// units of the variables.
+///
+class UnbinnedGoodnessOfFit {
+public:
+  UnbinnedGoodnessOfFit(const std::vector<ColumnView> &DataColumns,
+                        const ColumnView &DataWeights,
+                        const std::vector<ColumnView> &ModelColumns,
+                        const ColumnView &ModelWeights,
+                        bool Standardize = true);
+
+  /// Uses the columns \p VariableNames of both samples, or all variables of
+  /// the data sample if none are given.
+  UnbinnedGoodnessOfFit(const ComPWA::Data::DataSet &DataSample,
+                        const ComPWA::Data::DataSet &ModelSample,
+                        std::vector<std::string> VariableNames = {},
+                        bool Standardize = true);
+
+  /// Energy test of Aslan and Zech with the distance function
+  /// \f$\psi(r) = -\ln(r + \epsilon)\f$. All pairs of events contribute, so
+  /// the run time of the test and of each permutation is quadratic in the
+  /// size of the pooled sample.
+  GoodnessOfFitResult energyTest(unsigned int NumberOfPermutations = 100,
+                                 unsigned int Seed = 1234,
+                                 double Epsilon = 1e-4) const;
+
+  /// Point-to-point dissimilarity test with the Gaussian distance function
+  /// \f$\psi(r) = \exp(-r^2 / 2\sigma^2)\f$. Pairs further apart than
+  /// 5 \p Sigma are neglected, which the k-d tree exploits.
+  GoodnessOfFitResult
+  pointToPointDissimilarity(double Sigma = 0.1,
+                            unsigned int NumberOfPermutations = 100,
+                            unsigned int Seed = 1234) const;
+
+  /// Mixed sample test of Schilling and Henze: the fraction of the \p K
+  /// nearest neighbours of all events which belong to the same sample. The
+  /// test needs unweighted events, so weighted samples are unweighted with
+  /// the hit and miss method first.
+  GoodnessOfFitResult
+  mixedSampleNearestNeighbours(unsigned int K = 10,
+                               unsigned int NumberOfPermutations = 100,
+                               unsigned int Seed = 1234) const;
+
+private:
+  void init(const std::vector<ColumnView> &DataColumns,
+            const ColumnView &DataWeights,
+            const std::vector<ColumnView> &ModelColumns,
+            const ColumnView &ModelWeights, bool Standardize);
+
+  /// Weights of the events normalized to the total weight of their sample,
+  /// with a negative sign for the model sample.
+  std::vector<double> signedWeights(const std::vector<char> &IsData) const;
+
+  std::size_t NumberOfDataEvents;
+  std::vector<double> Weights;
+  std::vector<char> Labels;
+  std::unique_ptr<KDTree> Tree;
+};
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,171 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <map>
+#include <set>
+#include <sstream>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "Physics/BuilderXML.hpp"
+
+#include "PyComPWA/Tools/IntensityCache.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+/// Moves the values of all named parameters of \p Tree to \p Values.
+void extractParameterValues(boost::property_tree::ptree &Tree,
+                            std::map<std::string, double> &Values) {
+  for (auto &Child : Tree) {
+    if (Child.first == "Parameter") {
+      auto Name = Child.second.get_optional<std::string>("<xmlattr>.Name");
+      auto Value = Child.second.get_optional<double>("Value");
+      if (Name && Value) {
+        Values[*Name] = *Value;
+        Child.second.erase("Value");
+      }
+    }
+    extractParameterValues(Child.second, Values);
+  }
+}
+
+void collectComponentNames(const boost::property_tree::ptree &Tree,
+                           std::set<std::string> &Names) {
+  for (auto const &Child : Tree) {
+    if (Child.first == "Amplitude" || Child.first == "Intensity") {
+      auto Name = Child.second.get_optional<std::string>("<xmlattr>.Name");
+      if (Name)
+        Names.insert(*Name);
+    }
+    collectComponentNames(Child.second, Names);
+  }
+}
+
+/// FNV-1a hash of the momenta, pids and weights of the events.
+std::uint64_t hashEvents(const std::vector<ComPWA::Event> &Events) {
+  std::uint64_t Hash(0xcbf29ce484222325);
+  auto add = [&Hash](const void *Data, std::size_t Size) {
+    auto Bytes = static_cast<const unsigned char *>(Data);
+    for (std::size_t i = 0; i < Size; ++i) {
+      Hash ^= Bytes[i];
+      Hash *= 0x100000001b3;
+    }
+  };
+  auto NumberOfEvents = Events.size();
+  add(&NumberOfEvents, sizeof(NumberOfEvents));
+  for (auto const &Event : Events) {
+    add(&Event.Weight, sizeof(Event.Weight));
+    auto NumberOfParticles = Event.ParticleList.size();
+    add(&NumberOfParticles, sizeof(NumberOfParticles));
+    for (auto const &Particle : Event.ParticleList) {
+      auto Pid = Particle.pid();
+      auto Momentum = Particle.fourMomentum()();
+      add(&Pid, sizeof(Pid));
+      add(Momentum.data(), Momentum.size() * sizeof(double));
+    }
+  }
+  return Hash;
+}
+
+std::string difference(const std::set<std::string> &A,
+                       const std::set<std::string> &B) {
+  std::string Names;
+  for (auto const &Name : A) {
+    if (B.count(Name))
+      continue;
+    Names += (Names.empty() ? "" : ", ") + Name;
+  }
+  return Names.empty() ? "none" : Names;
+}
+
+} // namespace
+
+IntensityCache::IntensityCache(std::size_t MaximumNumberOfIntensities_)
+    : MaximumNumberOfIntensities(MaximumNumberOfIntensities_) {
+  if (MaximumNumberOfIntensities == 0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::IntensityCache::"
+                               "IntensityCache(): at least one intensity has "
+                               "to be kept!");
+}
+
+std::shared_ptr<ComPWA::FunctionTree::FunctionTreeIntensity>
+IntensityCache::createIntensity(const boost::property_tree::ptree &Model,
+                                ComPWA::ParticleList PartL,
+                                ComPWA::Kinematics &Kin,
+                                const std::vector<ComPWA::Event> &Phsp) {
+  auto it = Model.find("Intensity");
+  if (it == Model.not_found())
+    throw ComPWA::BadConfig("PyComPWA::Tools::IntensityCache::"
+                            "createIntensity(): Intensity tag not found!");
+
+  // the Intensity element itself, so that its attributes are compared too
+  boost::property_tree::ptree NewStructure;
+  NewStructure.push_back(*it);
+  std::map<std::string, double> NewValues;
+  extractParameterValues(NewStructure, NewValues);
+  std::ostringstream ParticleListStream;
+  ParticleListStream << PartL;
+  auto PhspSampleHash = hashEvents(Phsp);
+
+  bool InUse(false);
+  for (auto Built = Intensities.begin(); Built != Intensities.end(); ++Built) {
+    if (Built->Structure != NewStructure ||
+        Built->ParticleListDescription != ParticleListStream.str() ||
+        Built->Kinematics != &Kin || Built->PhspSampleHash != PhspSampleHash)
+      continue;
+    // an earlier result is still in use and must keep its parameters
+    if (Built->Intensity.use_count() > 1) {
+      InUse = true;
+      continue;
+    }
+    Intensities.splice(Intensities.begin(), Intensities, Built);
+    auto &Intensity = Intensities.front().Intensity;
+    // the intensity may have been fitted in the meantime, so the values are
+    // set even if the model values did not change
+    auto Parameters = Intensity->getParameters();
+    std::vector<double> Values;
+    Values.reserve(Parameters.size());
+    for (auto const &Parameter : Parameters) {
+      auto Value = NewValues.find(Parameter.Name);
+      Values.push_back(Value != NewValues.end() ? Value->second
+                                                : Parameter.Value);
+    }
+    Intensity->updateParametersFrom(Values);
+    LOG(DEBUG) << "IntensityCache::createIntensity(): reusing a cached "
+                  "intensity";
+    return Intensity;
+  }
+
+  if (InUse) {
+    LOG(INFO) << "IntensityCache::createIntensity(): building the intensity "
+                 "again, the cached one is still in use";
+  } else if (!Intensities.empty()) {
+    std::set<std::string> OldNames, NewNames;
+    collectComponentNames(Intensities.front().Structure, OldNames);
+    collectComponentNames(NewStructure, NewNames);
+    LOG(INFO) << "IntensityCache::createIntensity(): "
+                 "building the intensity again, added components: "
+              << difference(NewNames, OldNames)
+              << "; removed components: " << difference(OldNames, NewNames);
+  }
+
+  ComPWA::Physics::IntensityBuilderXML Builder(PartL, Kin, it->second, Phsp);
+  Intensities.push_front(BuiltIntensity{
+      std::make_shared<ComPWA::FunctionTree::FunctionTreeIntensity>(
+          Builder.createIntensity()),
+      std::move(NewStructure), ParticleListStream.str(), &Kin,
+      PhspSampleHash});
+  if (Intensities.size() > MaximumNumberOfIntensities)
+    Intensities.pop_back();
+  ++NumberOfBuilds;
+  return Intensities.front().Intensity;
+}
+
+void IntensityCache::reset() { Intensities.clear(); }
+
+} // namespace Tools
+} // namespace PyComPWA
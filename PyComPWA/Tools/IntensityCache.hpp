@@ -0,0 +1,88 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_INTENSITYCACHE_HPP_
+#define PYCOMPWA_TOOLS_INTENSITYCACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include "Core/Event.hpp"
+#include "Core/FunctionTree/FunctionTreeIntensity.hpp"
+#include "Core/Kinematics.hpp"
+#include "Core/Particle.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+///
+/// \class IntensityCache
+/// Cache of intensities for models which are edited between the calls, e.g.
+/// while adding or removing resonances and switching back. The Intensity
+/// section of each model is split into its structure and the parameter
+/// values:
+///  - If the structure, the particle list, the kinematics and the content of
+///    the phase space sample match one of the cached intensities, and no
+///    earlier result still holds that intensity, it is returned with the
+///    parameter values of the model. Its function tree only recalculates the
+///    nodes depending on changed parameters.
+///  - Otherwise the intensity is built again and added to the cache. The
+///    added and removed amplitudes are logged.
+///
+/// A cached intensity is only handed out again after all earlier results
+/// of it were released, so the parameters of an intensity held by a caller
+/// are never changed behind its back.
+///
+/// The phase space sample is compared by a hash of its momenta, pids and
+/// weights, so an edited or refilled sample is never mistaken for the old
+/// one. The kinematics is compared by identity and has to outlive the
+/// cache.
+///
+/// Any change of the structure builds the whole function tree again:
+/// ComPWA::Physics::IntensityBuilderXML builds the tree as a whole, so the
+/// subtrees of unchanged amplitudes are not reused.
+///
+class IntensityCache {
+public:
+  /// Keeps the last \p MaximumNumberOfIntensities built intensities. Each
+  /// one holds the amplitude values on the phase space sample.
+  IntensityCache(std::size_t MaximumNumberOfIntensities = 4);
+
+  std::shared_ptr<ComPWA::FunctionTree::FunctionTreeIntensity>
+  createIntensity(const boost::property_tree::ptree &Model,
+                  ComPWA::ParticleList PartL, ComPWA::Kinematics &Kin,
+                  const std::vector<ComPWA::Event> &PhspSample);
+
+  /// Number of calls which built the intensity from scratch.
+  std::size_t numberOfBuilds() const { return NumberOfBuilds; }
+
+  /// Forgets the built intensities, so that the next call builds again.
+  void reset();
+
+private:
+  struct BuiltIntensity {
+    std::shared_ptr<ComPWA::FunctionTree::FunctionTreeIntensity> Intensity;
+    /// Intensity section without the parameter values.
+    boost::property_tree::ptree Structure;
+    std::string ParticleListDescription;
+    const ComPWA::Kinematics *Kinematics;
+    std::uint64_t PhspSampleHash;
+  };
+
+  /// Most recently used first.
+  std::list<BuiltIntensity> Intensities;
+  std::size_t MaximumNumberOfIntensities;
+  std::size_t NumberOfBuilds = 0;
+};
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,171 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+#include "Core/Exceptions.hpp"
+
+#include "PyComPWA/Tools/KDTree.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+KDTree::KDTree(std::vector<double> Points_, std::size_t Dimension_,
+               std::size_t LeafSize_)
+    : Dimension(Dimension_), LeafSize(std::max<std::size_t>(LeafSize_, 1)),
+      Points(std::move(Points_)) {
+  if (Dimension == 0 || Points.size() % Dimension != 0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::KDTree::KDTree(): number of "
+                               "coordinates does not match the dimension!");
+  std::size_t NumberOfPoints = Points.size() / Dimension;
+  Indices.resize(NumberOfPoints);
+  std::iota(Indices.begin(), Indices.end(), 0);
+  if (NumberOfPoints)
+    build(0, NumberOfPoints);
+
+  // store the points in tree order, so that the leaves are contiguous
+  std::vector<double> Sorted(Points.size());
+  Positions.resize(NumberOfPoints);
+  for (std::size_t i = 0; i < NumberOfPoints; ++i) {
+    std::copy(&Points[Indices[i] * Dimension],
+              &Points[Indices[i] * Dimension] + Dimension,
+              &Sorted[i * Dimension]);
+    Positions[Indices[i]] = i;
+  }
+  Points.swap(Sorted);
+}
+
+std::size_t KDTree::build(std::size_t Begin, std::size_t End) {
+  std::size_t NodeIndex = Nodes.size();
+  Nodes.push_back(Node{Begin, End, 0, 0, 0, 0.0});
+  if (End - Begin <= LeafSize)
+    return NodeIndex;
+
+  std::size_t SplitDimension(0);
+  double MaximalWidth(-1.0);
+  for (std::size_t d = 0; d < Dimension; ++d) {
+    double Min = std::numeric_limits<double>::max();
+    double Max = std::numeric_limits<double>::lowest();
+    for (std::size_t i = Begin; i < End; ++i) {
+      double x = Points[Indices[i] * Dimension + d];
+      Min = std::min(Min, x);
+      Max = std::max(Max, x);
+    }
+    if (Max - Min > MaximalWidth) {
+      MaximalWidth = Max - Min;
+      SplitDimension = d;
+    }
+  }
+  std::size_t Middle = Begin + (End - Begin) / 2;
+  std::nth_element(Indices.begin() + Begin, Indices.begin() + Middle,
+                   Indices.begin() + End,
+                   [this, SplitDimension](std::size_t a, std::size_t b) {
+                     return Points[a * Dimension + SplitDimension] <
+                            Points[b * Dimension + SplitDimension];
+                   });
+  double SplitValue = Points[Indices[Middle] * Dimension + SplitDimension];
+
+  std::size_t Left = build(Begin, Middle);
+  std::size_t Right = build(Middle, End);
+  Nodes[NodeIndex].Left = Left;
+  Nodes[NodeIndex].Right = Right;
+  Nodes[NodeIndex].SplitDimension = SplitDimension;
+  Nodes[NodeIndex].SplitValue = SplitValue;
+  return NodeIndex;
+}
+
+double KDTree::distanceSquared(const double *a, const double *b) const {
+  double Sum(0.0);
+  for (std::size_t d = 0; d < Dimension; ++d)
+    Sum += (a[d] - b[d]) * (a[d] - b[d]);
+  return Sum;
+}
+
+std::vector<std::size_t> KDTree::nearestNeighbours(std::size_t Index,
+                                                   std::size_t K) const {
+  if (Index >= size())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::KDTree::nearestNeighbours(): index out of range!");
+  K = std::min(K, size() - 1);
+  std::vector<std::size_t> Result;
+  if (K == 0)
+    return Result;
+
+  const double *Query = point(Index);
+  std::size_t Self = Positions[Index];
+  // max heap of the K closest points found so far
+  std::priority_queue<std::pair<double, std::size_t>> Closest;
+  // nodes to visit, with a lower bound of their squared distance
+  std::vector<std::pair<std::size_t, double>> Stack{{0, 0.0}};
+  while (!Stack.empty()) {
+    auto Current = Stack.back();
+    Stack.pop_back();
+    if (Closest.size() == K && Current.second >= Closest.top().first)
+      continue;
+    const Node &n = Nodes[Current.first];
+    if (n.Left == 0) {
+      for (std::size_t i = n.Begin; i < n.End; ++i) {
+        if (i == Self)
+          continue;
+        double Distance = distanceSquared(Query, &Points[i * Dimension]);
+        if (Closest.size() < K) {
+          Closest.emplace(Distance, i);
+        } else if (Distance < Closest.top().first) {
+          Closest.pop();
+          Closest.emplace(Distance, i);
+        }
+      }
+      continue;
+    }
+    double Difference = Query[n.SplitDimension] - n.SplitValue;
+    double FarBound = std::max(Current.second, Difference * Difference);
+    // the closer child is pushed last, so that it is visited first
+    if (Difference < 0.0) {
+      Stack.emplace_back(n.Right, FarBound);
+      Stack.emplace_back(n.Left, Current.second);
+    } else {
+      Stack.emplace_back(n.Left, FarBound);
+      Stack.emplace_back(n.Right, Current.second);
+    }
+  }
+
+  Result.resize(Closest.size());
+  for (std::size_t i = Result.size(); i-- > 0;) {
+    Result[i] = Indices[Closest.top().second];
+    Closest.pop();
+  }
+  return Result;
+}
+
+void KDTree::pointsInRadius(
+    const double *Point, double Radius,
+    std::vector<std::pair<std::size_t, double>> &Result) const {
+  if (Nodes.empty())
+    return;
+  double RadiusSquared = Radius * Radius;
+  std::vector<std::size_t> Stack{0};
+  while (!Stack.empty()) {
+    const Node &n = Nodes[Stack.back()];
+    Stack.pop_back();
+    if (n.Left == 0) {
+      for (std::size_t i = n.Begin; i < n.End; ++i) {
+        double Distance = distanceSquared(Point, &Points[i * Dimension]);
+        if (Distance <= RadiusSquared)
+          Result.emplace_back(Indices[i], Distance);
+      }
+      continue;
+    }
+    double Difference = Point[n.SplitDimension] - n.SplitValue;
+    if (Difference <= Radius)
+      Stack.push_back(n.Left);
+    if (-Difference <= Radius)
+      Stack.push_back(n.Right);
+  }
+}
+
+} // namespace Tools
+} // namespace PyComPWA
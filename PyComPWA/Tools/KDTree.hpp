@@ -0,0 +1,76 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_KDTREE_HPP_
+#define PYCOMPWA_TOOLS_KDTREE_HPP_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace PyComPWA {
+namespace Tools {
+
+///
+/// \class KDTree
+/// Static k-d tree for nearest neighbour and fixed radius searches in a few
+/// dimensions. The nodes are split at the median of their widest dimension.
+/// All queries are const and can be run from several threads at once.
+///
+class KDTree {
+public:
+  /// \p Points holds the coordinates of all points in row-major order, i.e.
+  /// the coordinates of point i are Points[i * Dimension + d].
+  KDTree(std::vector<double> Points, std::size_t Dimension,
+         std::size_t LeafSize = 16);
+
+  std::size_t size() const { return Indices.size(); }
+  std::size_t dimension() const { return Dimension; }
+
+  /// Coordinates of point \p Index (in the order of the input points).
+  const double *point(std::size_t Index) const {
+    return &Points[Positions[Index] * Dimension];
+  }
+
+  /// The \p K nearest neighbours of point \p Index, excluding the point itself,
+  /// ordered by increasing distance.
+  std::vector<std::size_t> nearestNeighbours(std::size_t Index,
+                                             std::size_t K) const;
+
+  /// Appends all points within \p Radius of \p Point to \p Result, as pairs of
+  /// the point index and the squared distance.
+  void
+  pointsInRadius(const double *Point, double Radius,
+                 std::vector<std::pair<std::size_t, double>> &Result) const;
+
+private:
+  struct Node {
+    std::size_t Begin;
+    std::size_t End;
+    /// Children of inner nodes. Leaves have no children (zero).
+    std::size_t Left;
+    std::size_t Right;
+    std::size_t SplitDimension;
+    double SplitValue;
+  };
+
+  std::size_t build(std::size_t Begin, std::size_t End);
+
+  double distanceSquared(const double *a, const double *b) const;
+
+  std::size_t Dimension;
+  std::size_t LeafSize;
+  /// The points sorted into the tree order.
+  std::vector<double> Points;
+  /// Input index of the point at each tree position.
+  std::vector<std::size_t> Indices;
+  /// Tree position of each input point.
+  std::vector<std::size_t> Positions;
+  std::vector<Node> Nodes;
+};
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
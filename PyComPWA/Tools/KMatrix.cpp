@@ -0,0 +1,346 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "Core/Exceptions.hpp"
+
+#include "PyComPWA/Tools/KMatrix.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+/// Number of events which are solved together. The matrices of a batch stay
+/// in the L1 cache and each loop over the batch can be vectorized.
+const std::size_t BatchWidth = 8;
+
+template <std::size_t N>
+void solveBatches(std::size_t Size, const double *ARe, const double *AIm,
+                  const double *BRe, const double *BIm, double *XRe,
+                  double *XIm) {
+  const std::size_t W = BatchWidth;
+  // no threads are started here, the batches are solved one after another
+  // in the calling thread
+  std::size_t NumberOfBatches = (Size + W - 1) / W;
+  for (std::size_t Batch = 0; Batch < NumberOfBatches; ++Batch) {
+    std::size_t Begin = Batch * W;
+    std::size_t Width = std::min(W, Size - Begin);
+    double ar[N][N][W], ai[N][N][W], br[N][W], bi[N][W];
+
+    // unused lanes of the last batch solve the identity
+    for (std::size_t i = 0; i < N; ++i) {
+      for (std::size_t j = 0; j < N; ++j) {
+        for (std::size_t w = 0; w < W; ++w) {
+          bool Used = w < Width;
+          std::size_t Index = (i * N + j) * Size + Begin + w;
+          ar[i][j][w] = Used ? ARe[Index] : double(i == j);
+          ai[i][j][w] = Used ? AIm[Index] : 0.0;
+        }
+      }
+      for (std::size_t w = 0; w < W; ++w) {
+        bool Used = w < Width;
+        br[i][w] = Used ? BRe[i * Size + Begin + w] : 0.0;
+        bi[i][w] = Used ? BIm[i * Size + Begin + w] : 0.0;
+      }
+    }
+
+    for (std::size_t k = 0; k < N; ++k) {
+      // partial pivoting with conditional swaps instead of branches
+      for (std::size_t r = k + 1; r < N; ++r) {
+#pragma omp simd
+        for (std::size_t w = 0; w < W; ++w) {
+          double NormR = ar[r][k][w] * ar[r][k][w] + ai[r][k][w] * ai[r][k][w];
+          double NormK = ar[k][k][w] * ar[k][k][w] + ai[k][k][w] * ai[k][k][w];
+          bool Swap = NormR > NormK;
+          for (std::size_t j = k; j < N; ++j) {
+            double Re = ar[k][j][w], Im = ai[k][j][w];
+            ar[k][j][w] = Swap ? ar[r][j][w] : Re;
+            ai[k][j][w] = Swap ? ai[r][j][w] : Im;
+            ar[r][j][w] = Swap ? Re : ar[r][j][w];
+            ai[r][j][w] = Swap ? Im : ai[r][j][w];
+          }
+          double Re = br[k][w], Im = bi[k][w];
+          br[k][w] = Swap ? br[r][w] : Re;
+          bi[k][w] = Swap ? bi[r][w] : Im;
+          br[r][w] = Swap ? Re : br[r][w];
+          bi[r][w] = Swap ? Im : bi[r][w];
+        }
+      }
+      for (std::size_t r = k + 1; r < N; ++r) {
+#pragma omp simd
+        for (std::size_t w = 0; w < W; ++w) {
+          double Norm = ar[k][k][w] * ar[k][k][w] + ai[k][k][w] * ai[k][k][w];
+          // factor a_rk / a_kk
+          double FRe = (ar[r][k][w] * ar[k][k][w] + ai[r][k][w] * ai[k][k][w]) /
+                       Norm;
+          double FIm = (ai[r][k][w] * ar[k][k][w] - ar[r][k][w] * ai[k][k][w]) /
+                       Norm;
+          for (std::size_t j = k; j < N; ++j) {
+            ar[r][j][w] -= FRe * ar[k][j][w] - FIm * ai[k][j][w];
+            ai[r][j][w] -= FRe * ai[k][j][w] + FIm * ar[k][j][w];
+          }
+          br[r][w] -= FRe * br[k][w] - FIm * bi[k][w];
+          bi[r][w] -= FRe * bi[k][w] + FIm * br[k][w];
+        }
+      }
+    }
+
+    // back substitution, the solution replaces b
+    for (std::size_t k = N; k-- > 0;) {
+#pragma omp simd
+      for (std::size_t w = 0; w < W; ++w) {
+        double Re = br[k][w], Im = bi[k][w];
+        for (std::size_t j = k + 1; j < N; ++j) {
+          Re -= ar[k][j][w] * br[j][w] - ai[k][j][w] * bi[j][w];
+          Im -= ar[k][j][w] * bi[j][w] + ai[k][j][w] * br[j][w];
+        }
+        double Norm = ar[k][k][w] * ar[k][k][w] + ai[k][k][w] * ai[k][k][w];
+        br[k][w] = (Re * ar[k][k][w] + Im * ai[k][k][w]) / Norm;
+        bi[k][w] = (Im * ar[k][k][w] - Re * ai[k][k][w]) / Norm;
+      }
+    }
+
+    for (std::size_t i = 0; i < N; ++i) {
+      for (std::size_t w = 0; w < Width; ++w) {
+        XRe[i * Size + Begin + w] = br[i][w];
+        XIm[i * Size + Begin + w] = bi[i][w];
+      }
+    }
+  }
+}
+
+} // namespace
+
+void solveComplexLinearSystems(std::size_t Dimension, std::size_t Size,
+                               const double *ARe, const double *AIm,
+                               const double *BRe, const double *BIm,
+                               double *XRe, double *XIm) {
+  switch (Dimension) {
+  case 1:
+    return solveBatches<1>(Size, ARe, AIm, BRe, BIm, XRe, XIm);
+  case 2:
+    return solveBatches<2>(Size, ARe, AIm, BRe, BIm, XRe, XIm);
+  case 3:
+    return solveBatches<3>(Size, ARe, AIm, BRe, BIm, XRe, XIm);
+  case 4:
+    return solveBatches<4>(Size, ARe, AIm, BRe, BIm, XRe, XIm);
+  case 5:
+    return solveBatches<5>(Size, ARe, AIm, BRe, BIm, XRe, XIm);
+  default:
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::solveComplexLinearSystems(): dimension " +
+        std::to_string(Dimension) + " is not supported!");
+  }
+}
+
+KMatrix::KMatrix(std::vector<std::pair<double, double>> ChannelMasses)
+    : ChannelMasses(std::move(ChannelMasses)) {
+  if (this->ChannelMasses.empty() ||
+      this->ChannelMasses.size() > MaximumKMatrixDimension)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::KMatrix::KMatrix(): the number of channels has to "
+        "be between 1 and " +
+        std::to_string(MaximumKMatrixDimension) + "!");
+}
+
+void KMatrix::amplitudes(const KMatrixParameters &Parameters, const double *S,
+                         std::size_t Size, std::size_t Channel, double *Re,
+                         double *Im) const {
+  std::size_t N = ChannelMasses.size();
+  std::size_t NumberOfPoles = Parameters.PoleMasses.size();
+  if (Channel >= N || Parameters.Couplings.size() != NumberOfPoles ||
+      Parameters.ProductionCouplings.size() != NumberOfPoles ||
+      std::any_of(Parameters.Couplings.begin(), Parameters.Couplings.end(),
+                  [N](const std::vector<double> &x) { return x.size() != N; }))
+    throw ComPWA::BadParameter("PyComPWA::Tools::KMatrix::amplitudes(): "
+                               "parameters do not match the channels!");
+  auto Background = [&](std::size_t i, std::size_t j) {
+    return Parameters.Background.empty() ? 0.0 : Parameters.Background[i][j];
+  };
+
+  // A = 1 - i K rho and b = P in structure of arrays layout
+  std::vector<double> ARe(N * N * Size), AIm(N * N * Size);
+  std::vector<double> BRe(N * Size), BIm(N * Size);
+  std::vector<double> RhoRe(N), RhoIm(N);
+  for (std::size_t e = 0; e < Size; ++e) {
+    double s = S[e];
+    for (std::size_t i = 0; i < N; ++i) {
+      double Sum = ChannelMasses[i].first + ChannelMasses[i].second;
+      double Difference = ChannelMasses[i].first - ChannelMasses[i].second;
+      double Rho2 = (1.0 - Sum * Sum / s) * (1.0 - Difference * Difference / s);
+      RhoRe[i] = Rho2 >= 0.0 ? std::sqrt(Rho2) : 0.0;
+      RhoIm[i] = Rho2 >= 0.0 ? 0.0 : std::sqrt(-Rho2);
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+      std::complex<double> P(0.0);
+      for (std::size_t j = 0; j < N; ++j) {
+        double K = Background(i, j);
+        for (std::size_t a = 0; a < NumberOfPoles; ++a)
+          K += Parameters.Couplings[a][i] * Parameters.Couplings[a][j] /
+               (Parameters.PoleMasses[a] * Parameters.PoleMasses[a] - s);
+        // -i K rho_j
+        ARe[(i * N + j) * Size + e] = double(i == j) + K * RhoIm[j];
+        AIm[(i * N + j) * Size + e] = -K * RhoRe[j];
+      }
+      for (std::size_t a = 0; a < NumberOfPoles; ++a)
+        P += Parameters.ProductionCouplings[a] * Parameters.Couplings[a][i] /
+             (Parameters.PoleMasses[a] * Parameters.PoleMasses[a] - s);
+      BRe[i * Size + e] = P.real();
+      BIm[i * Size + e] = P.imag();
+    }
+  }
+
+  std::vector<double> XRe(N * Size), XIm(N * Size);
+  solveComplexLinearSystems(N, Size, ARe.data(), AIm.data(), BRe.data(),
+                            BIm.data(), XRe.data(), XIm.data());
+  std::copy_n(XRe.begin() + Channel * Size, Size, Re);
+  std::copy_n(XIm.begin() + Channel * Size, Size, Im);
+}
+
+std::vector<ComPWA::Parameter>
+KMatrix::flatParameters(const std::string &Name,
+                        const KMatrixParameters &Parameters) const {
+  std::size_t N = ChannelMasses.size();
+  std::vector<ComPWA::Parameter> Flat;
+  for (std::size_t a = 0; a < Parameters.PoleMasses.size(); ++a)
+    Flat.push_back(
+        {Name + "_mass_" + std::to_string(a), Parameters.PoleMasses[a]});
+  for (std::size_t a = 0; a < Parameters.Couplings.size(); ++a) {
+    for (std::size_t i = 0; i < N; ++i)
+      Flat.push_back({Name + "_g_" + std::to_string(a) + "_" +
+                          std::to_string(i),
+                      Parameters.Couplings[a].at(i)});
+  }
+  for (std::size_t a = 0; a < Parameters.ProductionCouplings.size(); ++a) {
+    Flat.push_back({Name + "_beta_re_" + std::to_string(a),
+                    Parameters.ProductionCouplings[a].real()});
+    Flat.push_back({Name + "_beta_im_" + std::to_string(a),
+                    Parameters.ProductionCouplings[a].imag()});
+  }
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = i; j < N; ++j)
+      Flat.push_back(
+          {Name + "_c_" + std::to_string(i) + "_" + std::to_string(j),
+           Parameters.Background.empty() ? 0.0
+                                         : Parameters.Background[i].at(j)});
+  }
+  return Flat;
+}
+
+std::size_t KMatrix::numberOfFlatParameters(std::size_t NumberOfPoles) const {
+  std::size_t N = ChannelMasses.size();
+  return NumberOfPoles * (N + 3) + N * (N + 1) / 2;
+}
+
+KMatrixParameters
+KMatrix::unflattenParameters(const std::vector<double> &Values,
+                             std::size_t NumberOfPoles) const {
+  std::size_t N = ChannelMasses.size();
+  if (Values.size() != numberOfFlatParameters(NumberOfPoles))
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::KMatrix::unflattenParameters(): wrong number of "
+        "parameters!");
+  KMatrixParameters Parameters;
+  auto Value = Values.begin();
+  Parameters.PoleMasses.assign(Value, Value + NumberOfPoles);
+  Value += NumberOfPoles;
+  for (std::size_t a = 0; a < NumberOfPoles; ++a) {
+    Parameters.Couplings.emplace_back(Value, Value + N);
+    Value += N;
+  }
+  for (std::size_t a = 0; a < NumberOfPoles; ++a) {
+    Parameters.ProductionCouplings.emplace_back(*Value, *(Value + 1));
+    Value += 2;
+  }
+  Parameters.Background.assign(N, std::vector<double>(N));
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = i; j < N; ++j) {
+      Parameters.Background[i][j] = *Value;
+      Parameters.Background[j][i] = *Value;
+      ++Value;
+    }
+  }
+  return Parameters;
+}
+
+namespace {
+
+using AmplitudeFunction = std::function<void(
+    const std::vector<const double *> &Columns, std::size_t NumberOfEvents,
+    const std::vector<double> &Parameters, std::complex<double> *Results)>;
+
+/// Amplitudes \f$F_k\f$ of \p Channel k at the data column \p VariableIndex
+/// for the flat parameters.
+AmplitudeFunction
+kMatrixAmplitudes(std::shared_ptr<const KMatrix> Matrix,
+                  std::size_t NumberOfPoles, std::size_t Channel,
+                  std::size_t VariableIndex) {
+  return [Matrix, NumberOfPoles, Channel,
+          VariableIndex](const std::vector<const double *> &Columns,
+                         std::size_t NumberOfEvents,
+                         const std::vector<double> &Values,
+                         std::complex<double> *Results) {
+    if (VariableIndex >= Columns.size())
+      throw ComPWA::BadParameter("K-matrix: the data has only " +
+                                 std::to_string(Columns.size()) +
+                                 " variables!");
+    auto Parameters = Matrix->unflattenParameters(Values, NumberOfPoles);
+    std::vector<double> Re(NumberOfEvents), Im(NumberOfEvents);
+    Matrix->amplitudes(Parameters, Columns[VariableIndex], NumberOfEvents,
+                       Channel, Re.data(), Im.data());
+    for (std::size_t i = 0; i < NumberOfEvents; ++i)
+      Results[i] = {Re[i], Im[i]};
+  };
+}
+
+} // namespace
+
+std::shared_ptr<VectorizedIntensity> createKMatrixIntensity(
+    const std::string &Name,
+    std::vector<std::pair<double, double>> ChannelMasses,
+    const KMatrixParameters &Parameters, std::size_t Channel,
+    std::size_t VariableIndex, std::size_t BlockSize) {
+  auto Matrix = std::make_shared<KMatrix>(std::move(ChannelMasses));
+  if (Channel >= Matrix->numberOfChannels())
+    throw ComPWA::BadParameter("PyComPWA::Tools::createKMatrixIntensity(): "
+                               "channel " +
+                               std::to_string(Channel) + " does not exist!");
+  std::size_t N = Matrix->numberOfChannels();
+  std::size_t NumberOfPoles = Parameters.PoleMasses.size();
+  auto WrongSize = [N](const std::vector<double> &x) { return x.size() != N; };
+  if (Parameters.Couplings.size() != NumberOfPoles ||
+      Parameters.ProductionCouplings.size() != NumberOfPoles ||
+      std::any_of(Parameters.Couplings.begin(), Parameters.Couplings.end(),
+                  WrongSize) ||
+      (!Parameters.Background.empty() &&
+       (Parameters.Background.size() != N ||
+        std::any_of(Parameters.Background.begin(),
+                    Parameters.Background.end(), WrongSize))))
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::createKMatrixIntensity(): expected couplings and "
+        "production couplings for each of the " +
+        std::to_string(NumberOfPoles) + " poles and a " + std::to_string(N) +
+        "x" + std::to_string(N) + " background!");
+  auto FlatParameters = Matrix->flatParameters(Name, Parameters);
+
+  auto Amplitudes =
+      kMatrixAmplitudes(Matrix, NumberOfPoles, Channel, VariableIndex);
+  return std::make_shared<VectorizedIntensity>(
+      [Amplitudes](const std::vector<const double *> &Columns,
+                   std::size_t NumberOfEvents,
+                   const std::vector<double> &Values, double *Results) {
+        std::vector<std::complex<double>> F(NumberOfEvents);
+        Amplitudes(Columns, NumberOfEvents, Values, F.data());
+        for (std::size_t i = 0; i < NumberOfEvents; ++i)
+          Results[i] = std::norm(F[i]);
+      },
+      FlatParameters, BlockSize);
+}
+
+} // namespace Tools
+} // namespace PyComPWA
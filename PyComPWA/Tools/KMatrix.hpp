@@ -0,0 +1,102 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_KMATRIX_HPP_
+#define PYCOMPWA_TOOLS_KMATRIX_HPP_
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PyComPWA/Tools/VectorizedIntensity.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+/// Largest matrix dimension of solveComplexLinearSystems().
+const std::size_t MaximumKMatrixDimension = 5;
+
+/// Solves the complex linear systems \f$A x = b\f$ of \p Size events, using
+/// Gaussian elimination with partial pivoting. The arrays are in structure
+/// of arrays layout: the real and imaginary parts of the matrix element
+/// (i, j) of event e are at `[(i * Dimension + j) * Size + e]`, the vector
+/// elements i at `[i * Size + e]`. There is a kernel for each dimension up to
+/// MaximumKMatrixDimension, which works on several events at once, so that
+/// the pivoting is branch free and the compiler can vectorize across events.
+void solveComplexLinearSystems(std::size_t Dimension, std::size_t Size,
+                               const double *ARe, const double *AIm,
+                               const double *BRe, const double *BIm,
+                               double *XRe, double *XIm);
+
+///
+/// \struct KMatrixParameters
+/// K-matrix with poles and a constant background, and the production
+/// couplings of the P-vector:
+/// \f[
+///   K_{ij}(s) = \sum_\alpha \frac{g_{\alpha i} g_{\alpha j}}{m_\alpha^2 - s}
+///     + c_{ij}, \quad
+///   P_i(s) = \sum_\alpha \frac{\beta_\alpha g_{\alpha i}}{m_\alpha^2 - s}
+/// \f]
+///
+struct KMatrixParameters {
+  std::vector<double> PoleMasses;
+  /// Couplings \f$g_{\alpha i}\f$ of each pole to each channel.
+  std::vector<std::vector<double>> Couplings;
+  /// Symmetric background \f$c_{ij}\f$, may be empty.
+  std::vector<std::vector<double>> Background;
+  std::vector<std::complex<double>> ProductionCouplings;
+};
+
+///
+/// \class KMatrix
+/// Production amplitudes \f$F = (1 - i K \rho)^{-1} P\f$ of a K-matrix in the
+/// P-vector approach. The phase space factors \f$\rho_i(s)\f$ of the two body
+/// channels are continued analytically below their thresholds.
+///
+class KMatrix {
+public:
+  /// \p ChannelMasses are the masses of the two particles of each channel.
+  explicit KMatrix(std::vector<std::pair<double, double>> ChannelMasses);
+
+  std::size_t numberOfChannels() const { return ChannelMasses.size(); }
+
+  /// Amplitudes of \p Channel at the invariant masses squared \p S.
+  void amplitudes(const KMatrixParameters &Parameters, const double *S,
+                  std::size_t Size, std::size_t Channel, double *Re,
+                  double *Im) const;
+
+  /// Flat parameter list of \p Parameters, as used by the intensity: pole
+  /// masses, couplings, production couplings (real and imaginary part) and
+  /// background (upper triangle), named `<Name>_mass_<pole>`,
+  /// `<Name>_g_<pole>_<channel>`, `<Name>_beta_re_<pole>`,
+  /// `<Name>_beta_im_<pole>` and `<Name>_c_<channel>_<channel>`.
+  std::vector<ComPWA::Parameter>
+  flatParameters(const std::string &Name,
+                 const KMatrixParameters &Parameters) const;
+  KMatrixParameters
+  unflattenParameters(const std::vector<double> &Values,
+                      std::size_t NumberOfPoles) const;
+  std::size_t numberOfFlatParameters(std::size_t NumberOfPoles) const;
+
+private:
+  std::vector<std::pair<double, double>> ChannelMasses;
+};
+
+/// Intensity \f$|F_k|^2\f$ of \p Channel k at the data column
+/// \p VariableIndex, which has to be the invariant mass squared. All
+/// K-matrix parameters, see KMatrix::flatParameters(), are parameters of the
+/// intensity.
+std::shared_ptr<VectorizedIntensity> createKMatrixIntensity(
+    const std::string &Name,
+    std::vector<std::pair<double, double>> ChannelMasses,
+    const KMatrixParameters &Parameters, std::size_t Channel,
+    std::size_t VariableIndex, std::size_t BlockSize = 65536);
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,435 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/Tools/KernelDensityEstimation.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+using Complex = std::complex<double>;
+
+/// Kernels are truncated at this number of bandwidths.
+const double KernelCutoff = 4.0;
+/// Limits of the local bandwidth factors of the adaptive estimate.
+const double MinimalLocalFactor = 1.0 / 3.0;
+const double MaximalLocalFactor = 3.0;
+/// Above this size (in cells) the events are binned with atomic operations
+/// instead of thread local grids.
+const std::size_t MaximalThreadLocalGridSize = 1 << 22;
+
+std::size_t nextPowerOfTwo(std::size_t n) {
+  std::size_t Power(1);
+  while (Power < n)
+    Power <<= 1;
+  return Power;
+}
+
+/// In-place radix-2 FFT of \p N (a power of two) values. The inverse
+/// transform is not normalized.
+void fft(Complex *Data, std::size_t N, bool Inverse) {
+  for (std::size_t i = 1, j = 0; i < N; ++i) {
+    std::size_t Bit = N >> 1;
+    for (; j & Bit; Bit >>= 1)
+      j ^= Bit;
+    j ^= Bit;
+    if (i < j)
+      std::swap(Data[i], Data[j]);
+  }
+  for (std::size_t Length = 2; Length <= N; Length <<= 1) {
+    double Angle = 2 * M_PI / Length * (Inverse ? 1 : -1);
+    Complex Root(std::cos(Angle), std::sin(Angle));
+    for (std::size_t i = 0; i < N; i += Length) {
+      Complex Twiddle(1.0);
+      for (std::size_t j = 0; j < Length / 2; ++j) {
+        Complex u = Data[i + j];
+        Complex v = Data[i + j + Length / 2] * Twiddle;
+        Data[i + j] = u + v;
+        Data[i + j + Length / 2] = u - v;
+        Twiddle *= Root;
+      }
+    }
+  }
+}
+
+/// FFT of a row-major array with the extents \p Shape along all axes.
+void fftND(std::vector<Complex> &Data, const std::vector<std::size_t> &Shape,
+           bool Inverse) {
+  std::size_t Stride(1);
+  for (std::size_t Axis = Shape.size(); Axis-- > 0;) {
+    std::size_t N = Shape[Axis];
+    long NumberOfLines = Data.size() / N;
+#pragma omp parallel
+    {
+      std::vector<Complex> Line(N);
+#pragma omp for schedule(static)
+      for (long l = 0; l < NumberOfLines; ++l) {
+        std::size_t Offset = (l / Stride) * N * Stride + l % Stride;
+        for (std::size_t i = 0; i < N; ++i)
+          Line[i] = Data[Offset + i * Stride];
+        fft(Line.data(), N, Inverse);
+        for (std::size_t i = 0; i < N; ++i)
+          Data[Offset + i * Stride] = Line[i];
+      }
+    }
+    Stride *= N;
+  }
+  if (Inverse) {
+    double Norm = 1.0 / Data.size();
+    for (auto &x : Data)
+      x *= Norm;
+  }
+}
+
+struct Grid {
+  std::vector<double> Low;
+  std::vector<double> High;
+  std::vector<double> CellWidth;
+  std::vector<std::size_t> Cells;
+
+  std::size_t size() const {
+    std::size_t Size(1);
+    for (auto x : Cells)
+      Size *= x;
+    return Size;
+  }
+  std::size_t stride(std::size_t Dim) const {
+    std::size_t Stride(1);
+    for (std::size_t d = Dim + 1; d < Cells.size(); ++d)
+      Stride *= Cells[d];
+    return Stride;
+  }
+};
+
+double weightOf(const ColumnView &Weights, std::size_t i) {
+  return Weights.Size ? Weights[i] : 1.0;
+}
+
+bool isInside(const std::vector<ColumnView> &Columns, std::size_t i,
+              const Grid &TheGrid) {
+  for (std::size_t d = 0; d < Columns.size(); ++d) {
+    if (!(Columns[d][i] >= TheGrid.Low[d] && Columns[d][i] <= TheGrid.High[d]))
+      return false;
+  }
+  return true;
+}
+
+/// Linear binning of the events into one grid per class. \p EventClass maps
+/// an event index to its class.
+template <typename ClassFunction>
+std::vector<double> binEvents(const std::vector<ColumnView> &Columns,
+                              const ColumnView &Weights, std::size_t Events,
+                              const Grid &TheGrid, std::size_t Classes,
+                              ClassFunction EventClass) {
+  std::size_t Dimensions = Columns.size();
+  std::size_t GridSize = TheGrid.size();
+  std::vector<std::size_t> Strides;
+  for (std::size_t d = 0; d < Dimensions; ++d)
+    Strides.push_back(TheGrid.stride(d));
+
+  std::vector<double> Result(Classes * GridSize, 0.0);
+  bool UseThreadLocalGrids = Result.size() <= MaximalThreadLocalGridSize;
+
+#pragma omp parallel
+  {
+    std::vector<double> LocalResult(UseThreadLocalGrids ? Result.size() : 0);
+    double *Target = UseThreadLocalGrids ? LocalResult.data() : Result.data();
+    std::vector<std::size_t> Lower(Dimensions);
+    std::vector<double> Fraction(Dimensions);
+#pragma omp for schedule(static)
+    for (long i = 0; i < static_cast<long>(Events); ++i) {
+      if (!isInside(Columns, i, TheGrid))
+        continue;
+      std::size_t Class = EventClass(i);
+      for (std::size_t d = 0; d < Dimensions; ++d) {
+        // position relative to the cell centers
+        double u =
+            (Columns[d][i] - TheGrid.Low[d]) / TheGrid.CellWidth[d] - 0.5;
+        double Floor = std::floor(u);
+        if (Floor < 0) {
+          Lower[d] = 0;
+          Fraction[d] = 0.0;
+        } else if (Floor >= TheGrid.Cells[d] - 1) {
+          Lower[d] = TheGrid.Cells[d] - 1;
+          Fraction[d] = 0.0;
+        } else {
+          Lower[d] = static_cast<std::size_t>(Floor);
+          Fraction[d] = u - Floor;
+        }
+      }
+      double Weight = weightOf(Weights, i);
+      for (std::size_t Corner = 0; Corner < (1u << Dimensions); ++Corner) {
+        double CornerWeight(Weight);
+        std::size_t Index(Class * GridSize);
+        for (std::size_t d = 0; d < Dimensions; ++d) {
+          bool Upper = Corner & (1u << d);
+          CornerWeight *= Upper ? Fraction[d] : 1.0 - Fraction[d];
+          Index += (Lower[d] + Upper) * Strides[d];
+        }
+        if (CornerWeight == 0.0)
+          continue;
+        if (UseThreadLocalGrids) {
+          Target[Index] += CornerWeight;
+        } else {
+#pragma omp atomic
+          Target[Index] += CornerWeight;
+        }
+      }
+    }
+    if (UseThreadLocalGrids) {
+#pragma omp critical
+      for (std::size_t j = 0; j < Result.size(); ++j)
+        Result[j] += LocalResult[j];
+    }
+  }
+  return Result;
+}
+
+/// Convolve each class grid with a Gaussian kernel of the class bandwidths
+/// (in units of grid cells) and sum up the results.
+std::vector<double>
+convolve(const std::vector<double> &ClassGrids, const Grid &TheGrid,
+         const std::vector<std::vector<double>> &ClassBandwidths) {
+  std::size_t Dimensions = TheGrid.Cells.size();
+  std::size_t GridSize = TheGrid.size();
+
+  std::vector<std::size_t> HalfWidths(Dimensions, 1);
+  for (auto const &Bandwidths : ClassBandwidths) {
+    for (std::size_t d = 0; d < Dimensions; ++d) {
+      std::size_t HalfWidth =
+          static_cast<std::size_t>(std::ceil(KernelCutoff * Bandwidths[d]));
+      HalfWidths[d] = std::max(
+          HalfWidths[d], std::min(HalfWidth, TheGrid.Cells[d] - 1));
+    }
+  }
+  // zero padding avoids the wrap around of the cyclic convolution
+  std::vector<std::size_t> PaddedShape;
+  std::size_t PaddedSize(1);
+  for (std::size_t d = 0; d < Dimensions; ++d) {
+    PaddedShape.push_back(nextPowerOfTwo(TheGrid.Cells[d] + HalfWidths[d]));
+    PaddedSize *= PaddedShape.back();
+  }
+  // row-major index in the padded array of each grid cell
+  std::vector<std::size_t> PaddedIndices(GridSize);
+  for (std::size_t i = 0; i < GridSize; ++i) {
+    std::size_t Remainder(i), PaddedIndex(0), Stride(1);
+    for (std::size_t d = Dimensions; d-- > 0;) {
+      PaddedIndex += (Remainder % TheGrid.Cells[d]) * Stride;
+      Remainder /= TheGrid.Cells[d];
+      Stride *= PaddedShape[d];
+    }
+    PaddedIndices[i] = PaddedIndex;
+  }
+
+  std::vector<Complex> Sum(PaddedSize, 0.0);
+  std::vector<Complex> Padded(PaddedSize);
+  for (std::size_t Class = 0; Class < ClassBandwidths.size(); ++Class) {
+    auto const &Bandwidths = ClassBandwidths[Class];
+    auto First = ClassGrids.begin() + Class * GridSize;
+    if (std::all_of(First, First + GridSize, [](double x) { return x == 0; }))
+      continue;
+
+    std::fill(Padded.begin(), Padded.end(), 0.0);
+    for (std::size_t i = 0; i < GridSize; ++i)
+      Padded[PaddedIndices[i]] = *(First + i);
+    fftND(Padded, PaddedShape, false);
+
+    // The Gaussian kernel is separable, hence its transform is the product
+    // of the one dimensional transforms. The kernels are centered at the
+    // origin and wrap around.
+    std::vector<std::vector<Complex>> KernelTransforms;
+    for (std::size_t d = 0; d < Dimensions; ++d) {
+      std::vector<Complex> Kernel(PaddedShape[d], 0.0);
+      double KernelSum(0.0);
+      for (long k = -static_cast<long>(HalfWidths[d]);
+           k <= static_cast<long>(HalfWidths[d]); ++k) {
+        double Value(k == 0 ? 1.0 : 0.0);
+        if (Bandwidths[d] > 0.0)
+          Value = std::exp(-0.5 * std::pow(k / Bandwidths[d], 2));
+        Kernel[k < 0 ? k + PaddedShape[d] : k] = Value;
+        KernelSum += Value;
+      }
+      for (auto &x : Kernel)
+        x /= KernelSum;
+      fft(Kernel.data(), Kernel.size(), false);
+      KernelTransforms.push_back(Kernel);
+    }
+#pragma omp parallel for schedule(static)
+    for (long i = 0; i < static_cast<long>(PaddedSize); ++i) {
+      std::size_t Remainder(i);
+      Complex Transform(1.0);
+      for (std::size_t d = Dimensions; d-- > 0;) {
+        Transform *= KernelTransforms[d][Remainder % PaddedShape[d]];
+        Remainder /= PaddedShape[d];
+      }
+      Sum[i] += Padded[i] * Transform;
+    }
+  }
+  fftND(Sum, PaddedShape, true);
+
+  std::vector<double> Result(GridSize);
+  for (std::size_t i = 0; i < GridSize; ++i) {
+    // remove negative values from rounding errors of the FFT
+    Result[i] = std::max(0.0, Sum[PaddedIndices[i]].real());
+  }
+  return Result;
+}
+
+} // namespace
+
+DensityGrid estimateDensity(const std::vector<ColumnView> &Columns,
+                            const ColumnView &Weights,
+                            const KernelDensitySettings &Settings) {
+  std::size_t Dimensions = Columns.size();
+  if (Dimensions < 1 || Dimensions > 3)
+    throw ComPWA::BadParameter("PyComPWA::Tools::estimateDensity(): only one "
+                               "to three dimensions are supported!");
+  std::size_t Events = checkColumnSizes(Columns, Weights);
+  if (Settings.NumberOfBins.size() != Dimensions)
+    throw ComPWA::BadParameter("PyComPWA::Tools::estimateDensity(): number "
+                               "of bins has to be given for each dimension!");
+  if (!Settings.Ranges.empty() && Settings.Ranges.size() != Dimensions)
+    throw ComPWA::BadParameter("PyComPWA::Tools::estimateDensity(): ranges "
+                               "have to be given for each dimension!");
+
+  // weighted moments for the bandwidth and the range of the sample
+  std::vector<double> Minimum(Dimensions, std::numeric_limits<double>::max());
+  std::vector<double> Maximum(Dimensions,
+                              std::numeric_limits<double>::lowest());
+  std::vector<double> Sum(Dimensions, 0.0), SquaredSum(Dimensions, 0.0);
+  double SumOfWeights(0.0), SumOfSquaredWeights(0.0);
+  for (std::size_t d = 0; d < Dimensions; ++d) {
+    double Min(Minimum[d]), Max(Maximum[d]), S(0.0), SS(0.0);
+    double SW(0.0), SSW(0.0);
+#pragma omp parallel for reduction(min : Min) reduction(max : Max) \
+    reduction(+ : S, SS, SW, SSW)
+    for (long i = 0; i < static_cast<long>(Events); ++i) {
+      double x = Columns[d][i];
+      double w = weightOf(Weights, i);
+      Min = std::min(Min, x);
+      Max = std::max(Max, x);
+      S += w * x;
+      SS += w * x * x;
+      SW += w;
+      SSW += w * w;
+    }
+    Minimum[d] = Min;
+    Maximum[d] = Max;
+    Sum[d] = S;
+    SquaredSum[d] = SS;
+    SumOfWeights = SW;
+    SumOfSquaredWeights = SSW;
+  }
+  if (Events == 0 || SumOfWeights <= 0.0)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::estimateDensity(): sample is empty!");
+
+  Grid TheGrid;
+  DensityGrid Result;
+  for (std::size_t d = 0; d < Dimensions; ++d) {
+    if (Settings.NumberOfBins[d] < 2)
+      throw ComPWA::BadParameter("PyComPWA::Tools::estimateDensity(): at "
+                                 "least two bins per dimension are required!");
+    double Low = Settings.Ranges.empty() ? Minimum[d] : Settings.Ranges[d].first;
+    double High =
+        Settings.Ranges.empty() ? Maximum[d] : Settings.Ranges[d].second;
+    if (!(High > Low))
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::estimateDensity(): empty range!");
+    TheGrid.Low.push_back(Low);
+    TheGrid.High.push_back(High);
+    TheGrid.Cells.push_back(Settings.NumberOfBins[d]);
+    TheGrid.CellWidth.push_back((High - Low) / Settings.NumberOfBins[d]);
+    std::vector<double> Edges;
+    for (std::size_t j = 0; j <= Settings.NumberOfBins[d]; ++j)
+      Edges.push_back(Low + j * TheGrid.CellWidth[d]);
+    Result.BinEdges.push_back(Edges);
+  }
+
+  // Scott's rule with the effective number of events of a weighted sample
+  double EffectiveEvents = SumOfWeights * SumOfWeights / SumOfSquaredWeights;
+  std::vector<double> Bandwidths;
+  for (std::size_t d = 0; d < Dimensions; ++d) {
+    double Mean = Sum[d] / SumOfWeights;
+    double Variance = std::max(0.0, SquaredSum[d] / SumOfWeights - Mean * Mean);
+    double Bandwidth = Settings.BandwidthScale * std::sqrt(Variance) *
+                       std::pow(EffectiveEvents, -1.0 / (Dimensions + 4));
+    Result.Bandwidths.push_back(Bandwidth);
+    Bandwidths.push_back(Bandwidth / TheGrid.CellWidth[d]);
+  }
+
+  auto Binned = binEvents(Columns, Weights, Events, TheGrid, 1,
+                          [](std::size_t) { return 0; });
+  Result.Values = convolve(Binned, TheGrid, {Bandwidths});
+  if (!Settings.Adaptive || Settings.NumberOfBandwidthClasses < 2)
+    return Result;
+
+  // Abramson's square root law: lambda = (pilot / g)^(-1/2), where g is the
+  // geometric mean of the pilot estimate at the events. The local factor only
+  // depends on the grid cell, so the bandwidth class is determined per cell.
+  // The linearly binned sample approximates the event positions for g.
+  auto const &Pilot = Result.Values;
+  double LogSum(0.0), LogWeights(0.0);
+  for (std::size_t Cell = 0; Cell < Pilot.size(); ++Cell) {
+    if (Pilot[Cell] <= 0.0 || Binned[Cell] <= 0.0)
+      continue;
+    LogSum += Binned[Cell] * std::log(Pilot[Cell]);
+    LogWeights += Binned[Cell];
+  }
+  if (LogWeights <= 0.0)
+    return Result;
+  double LogGeometricMean = LogSum / LogWeights;
+
+  // bandwidth classes are equidistant in the logarithm of the local factor
+  std::size_t Classes = Settings.NumberOfBandwidthClasses;
+  double LogMin = std::log(MinimalLocalFactor);
+  double LogStep = (std::log(MaximalLocalFactor) - LogMin) / Classes;
+  std::vector<std::size_t> CellClasses(Pilot.size(), Classes - 1);
+  for (std::size_t Cell = 0; Cell < Pilot.size(); ++Cell) {
+    if (Pilot[Cell] <= 0.0)
+      continue;
+    double LogFactor = -0.5 * (std::log(Pilot[Cell]) - LogGeometricMean);
+    double Class = std::floor((LogFactor - LogMin) / LogStep);
+    CellClasses[Cell] = static_cast<std::size_t>(
+        std::max(0.0, std::min(Class, static_cast<double>(Classes - 1))));
+  }
+  auto cellOf = [&](std::size_t i) {
+    std::size_t Index(0);
+    for (std::size_t d = 0; d < Dimensions; ++d) {
+      long Cell = static_cast<long>(
+          std::floor((Columns[d][i] - TheGrid.Low[d]) / TheGrid.CellWidth[d]));
+      Cell = std::max(0l, std::min(Cell, static_cast<long>(TheGrid.Cells[d]) -
+                                             1));
+      Index = Index * TheGrid.Cells[d] + Cell;
+    }
+    return Index;
+  };
+  auto ClassGrids =
+      binEvents(Columns, Weights, Events, TheGrid, Classes,
+                [&](std::size_t i) { return CellClasses[cellOf(i)]; });
+  std::vector<std::vector<double>> ClassBandwidths;
+  for (std::size_t Class = 0; Class < Classes; ++Class) {
+    double Factor = std::exp(LogMin + (Class + 0.5) * LogStep);
+    std::vector<double> ClassBandwidth;
+    for (auto x : Bandwidths)
+      ClassBandwidth.push_back(Factor * x);
+    ClassBandwidths.push_back(ClassBandwidth);
+  }
+  Result.Values = convolve(ClassGrids, TheGrid, ClassBandwidths);
+  LOG(DEBUG) << "PyComPWA::Tools::estimateDensity(): adaptive estimate of "
+             << Events << " events on " << TheGrid.size() << " grid cells";
+  return Result;
+}
+
+} // namespace Tools
+} // namespace PyComPWA
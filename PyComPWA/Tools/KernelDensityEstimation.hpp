@@ -0,0 +1,51 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_KERNELDENSITYESTIMATION_HPP_
+#define PYCOMPWA_TOOLS_KERNELDENSITYESTIMATION_HPP_
+
+#include <utility>
+#include <vector>
+
+#include "PyComPWA/Tools/DataColumns.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+struct KernelDensitySettings {
+  /// Number of grid cells in each dimension.
+  std::vector<unsigned int> NumberOfBins;
+  /// Grid range in each dimension. The range of the sample is used if empty.
+  std::vector<std::pair<double, double>> Ranges;
+  /// Scale factor for the bandwidth of Scott's rule.
+  double BandwidthScale = 1.0;
+  /// Use local bandwidths following Abramson's square root law.
+  bool Adaptive = true;
+  /// Number of discrete local bandwidths of the adaptive estimate.
+  unsigned int NumberOfBandwidthClasses = 8;
+};
+
+struct DensityGrid {
+  std::vector<std::vector<double>> BinEdges;
+  /// Estimated sum of weights in each grid cell, in row-major order. The
+  /// values can be compared directly to a histogram with the same bins.
+  std::vector<double> Values;
+  /// Global bandwidth in each dimension.
+  std::vector<double> Bandwidths;
+};
+
+/// Gaussian kernel density estimate of a weighted sample in one to three
+/// dimensions. The sample is linearly binned onto the grid and convolved with
+/// the kernel via FFT, so the run time scales linearly with the sample size.
+/// In adaptive mode, a fixed bandwidth pilot estimate determines a local
+/// bandwidth for each event. The events are grouped into a few bandwidth
+/// classes, which are convolved separately.
+DensityGrid estimateDensity(const std::vector<ColumnView> &Columns,
+                            const ColumnView &Weights,
+                            const KernelDensitySettings &Settings);
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,202 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/Tools/NumpyPlotData.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+bool isLittleEndian() {
+  const std::uint16_t Probe(1);
+  return *reinterpret_cast<const unsigned char *>(&Probe) == 1;
+}
+
+std::string escape(const std::string &Name, char Quote) {
+  std::string Escaped;
+  for (auto c : Name) {
+    if (c == Quote || c == '\\')
+      Escaped += '\\';
+    Escaped += c;
+  }
+  return Escaped;
+}
+
+/// Samples without weights are written with unit weights.
+std::vector<double> weightsOf(const ComPWA::Data::DataSet &Sample) {
+  if (!Sample.Weights.empty() || Sample.Data.empty())
+    return Sample.Weights;
+  return std::vector<double>(Sample.Data.front().size(), 1.0);
+}
+
+void createDirectory(const std::string &DirectoryName) {
+  if (::mkdir(DirectoryName.c_str(), 0755) != 0 && errno != EEXIST)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::NumpyPlotData: could not create directory " +
+        DirectoryName + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+void writeNpyRecordArray(
+    const std::string &FileName, const std::vector<std::string> &ColumnNames,
+    const std::vector<const std::vector<double> *> &Columns) {
+  if (ColumnNames.size() != Columns.size() || Columns.empty())
+    throw ComPWA::BadParameter("PyComPWA::Tools::writeNpyRecordArray(): "
+                               "column names and columns mismatch!");
+  std::size_t NumberOfRows = Columns.front()->size();
+  for (auto Column : Columns) {
+    if (Column->size() != NumberOfRows)
+      throw ComPWA::BadParameter("PyComPWA::Tools::writeNpyRecordArray(): "
+                                 "columns differ in length!");
+  }
+  // numpy refuses to load a record array with duplicate field names, e.g. a
+  // component called "intensity"
+  std::set<std::string> UniqueNames;
+  for (auto const &Name : ColumnNames) {
+    if (Name.empty() || !UniqueNames.insert(Name).second)
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::writeNpyRecordArray(): column name \"" + Name +
+          "\" is empty or not unique!");
+  }
+
+  std::string TypeString(isLittleEndian() ? "<f8" : ">f8");
+  std::stringstream Header;
+  Header << "{'descr': [";
+  for (auto const &Name : ColumnNames)
+    Header << "('" << escape(Name, '\'') << "', '" << TypeString << "'), ";
+  Header << "], 'fortran_order': False, 'shape': (" << NumberOfRows
+         << ",), }";
+  std::string HeaderString = Header.str();
+  // magic string (6), version (2) and header length (2) precede the header,
+  // which is padded with spaces and terminated by a newline so that the data
+  // is aligned to 64 bytes
+  std::size_t Padding = 64 - (10 + HeaderString.size() + 1) % 64;
+  HeaderString += std::string(Padding % 64, ' ') + "\n";
+  if (HeaderString.size() > 65535)
+    throw ComPWA::BadParameter("PyComPWA::Tools::writeNpyRecordArray(): too "
+                               "many columns for a version 1.0 header!");
+
+  std::ofstream File(FileName, std::ios::binary);
+  if (!File)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::writeNpyRecordArray(): cannot open " + FileName);
+  File.write("\x93NUMPY\x01\x00", 8);
+  unsigned char HeaderLength[2] = {
+      static_cast<unsigned char>(HeaderString.size() & 0xff),
+      static_cast<unsigned char>(HeaderString.size() >> 8)};
+  File.write(reinterpret_cast<const char *>(HeaderLength), 2);
+  File.write(HeaderString.data(), HeaderString.size());
+
+  // write the rows in chunks to keep the memory footprint small
+  const std::size_t ChunkSize(16384);
+  std::vector<double> Buffer;
+  Buffer.reserve(ChunkSize * Columns.size());
+  for (std::size_t Begin = 0; Begin < NumberOfRows; Begin += ChunkSize) {
+    std::size_t End = std::min(Begin + ChunkSize, NumberOfRows);
+    Buffer.clear();
+    for (std::size_t Row = Begin; Row < End; ++Row) {
+      for (auto Column : Columns)
+        Buffer.push_back((*Column)[Row]);
+    }
+    File.write(reinterpret_cast<const char *>(Buffer.data()),
+               Buffer.size() * sizeof(double));
+  }
+  if (!File)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::writeNpyRecordArray(): failed writing " + FileName);
+}
+
+NumpyPlotData::NumpyPlotData(
+    const ComPWA::Physics::ParticleStateTransitionKinematicsInfo &KinInfo,
+    const std::string &DirectoryName_)
+    : DirectoryName(DirectoryName_) {
+  createDirectory(DirectoryName);
+
+  std::ofstream MappingFile(DirectoryName +
+                            "/final_state_id_to_name_mapping.json");
+  MappingFile << "{";
+  bool First(true);
+  for (auto const &x : KinInfo.getFinalStateIDToNameMapping()) {
+    if (!First)
+      MappingFile << ", ";
+    MappingFile << "\"" << x.first << "\": \"" << escape(x.second, '"')
+                << "\"";
+    First = false;
+  }
+  MappingFile << "}\n";
+}
+
+void NumpyPlotData::writeData(const ComPWA::Data::DataSet &DataSample,
+                              const std::string &Name) {
+  if (DataSample.Data.empty())
+    return;
+  LOG(INFO) << "NumpyPlotData::writeData(): writing data sample to "
+            << DirectoryName << "/" << Name << ".npy";
+  auto ColumnNames = DataSample.VariableNames;
+  ColumnNames.push_back("weight");
+  std::vector<const std::vector<double> *> Columns;
+  for (auto const &x : DataSample.Data)
+    Columns.push_back(&x);
+  auto Weights = weightsOf(DataSample);
+  Columns.push_back(&Weights);
+  writeNpyRecordArray(DirectoryName + "/" + Name + ".npy", ColumnNames,
+                      Columns);
+}
+
+void NumpyPlotData::writeIntensityWeightedPhspSample(
+    const ComPWA::Data::DataSet &PhspSample, ComPWA::Intensity &Intensity,
+    const std::string &Name,
+    std::map<std::string, std::shared_ptr<ComPWA::Intensity>>
+        IntensityComponents) {
+  if (PhspSample.Data.empty())
+    return;
+  LOG(INFO) << "NumpyPlotData::writeIntensityWeightedPhspSample(): writing "
+               "intensity weighted phase space sample to "
+            << DirectoryName << "/" << Name << ".npy";
+
+  auto ColumnNames = PhspSample.VariableNames;
+  std::vector<const std::vector<double> *> Columns;
+  for (auto const &x : PhspSample.Data)
+    Columns.push_back(&x);
+  auto Weights = weightsOf(PhspSample);
+  ColumnNames.push_back("weight");
+  Columns.push_back(&Weights);
+
+  // the component intensities are stored next to the total intensity
+  std::vector<std::vector<double>> Intensities;
+  Intensities.reserve(IntensityComponents.size() + 1);
+  Intensities.push_back(Intensity.evaluate(PhspSample.Data));
+  ColumnNames.push_back("intensity");
+  for (auto const &x : IntensityComponents) {
+    Intensities.push_back(x.second->evaluate(PhspSample.Data));
+    ColumnNames.push_back(x.first);
+  }
+  for (auto const &x : Intensities)
+    Columns.push_back(&x);
+
+  writeNpyRecordArray(DirectoryName + "/" + Name + ".npy", ColumnNames,
+                      Columns);
+}
+
+void NumpyPlotData::writeHitMissSample(
+    const ComPWA::Data::DataSet &HitMissSample, const std::string &Name) {
+  writeData(HitMissSample, Name);
+}
+
+} // namespace Tools
+} // namespace PyComPWA
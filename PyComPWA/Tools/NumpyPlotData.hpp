@@ -0,0 +1,65 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_NUMPYPLOTDATA_HPP_
+#define PYCOMPWA_TOOLS_NUMPYPLOTDATA_HPP_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/Intensity.hpp"
+#include "Data/DataSet.hpp"
+#include "Physics/ParticleStateTransitionKinematicsInfo.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+/// Write a table of columns as a structured numpy array (.npy format version
+/// 1.0). Each row holds one event and each column is a double precision
+/// field, so that the file can be memory mapped with
+/// `numpy.load(file, mmap_mode='r')`. Throws if the column names are not
+/// unique.
+void writeNpyRecordArray(const std::string &FileName,
+                         const std::vector<std::string> &ColumnNames,
+                         const std::vector<const std::vector<double> *> &Columns);
+
+///
+/// \class NumpyPlotData
+/// ROOT-free counterpart of ComPWA::Tools::Plotting::RootPlotData. All samples
+/// are written as memory mappable .npy files into a directory:
+///  - `data.npy`: kinematic variables and the event weight
+///  - `<name>.npy`: kinematic variables, weight, intensity and the intensity
+///    of each component of an intensity weighted phase space sample. The
+///    component names must not clash with the other columns.
+///  - `hit_and_miss_data.npy`: kinematic variables and the event weight
+///  - `final_state_id_to_name_mapping.json`: the final state particle names
+///
+class NumpyPlotData {
+public:
+  NumpyPlotData(
+      const ComPWA::Physics::ParticleStateTransitionKinematicsInfo &KinInfo,
+      const std::string &DirectoryName);
+
+  void writeData(const ComPWA::Data::DataSet &DataSample,
+                 const std::string &Name = "data");
+
+  void writeIntensityWeightedPhspSample(
+      const ComPWA::Data::DataSet &PhspSample, ComPWA::Intensity &Intensity,
+      const std::string &Name = "intensity_weighted_phspdata",
+      std::map<std::string, std::shared_ptr<ComPWA::Intensity>>
+          IntensityComponents = {});
+
+  void writeHitMissSample(const ComPWA::Data::DataSet &HitMissSample,
+                          const std::string &Name = "hit_and_miss_data");
+
+private:
+  std::string DirectoryName;
+};
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
@@ -0,0 +1,637 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits.h>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/property_tree/xml_parser.hpp>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/Tools/ParticleDatabase.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+// Layout of the database file, in the byte order of the machine:
+//  - Header
+//  - Particle records, in the order of the xml file
+//  - Element records of the xml trees of the particles
+//  - hash index of the particles by name, linear probing
+//  - hash index of the particles by pid, linear probing
+//  - null terminated strings of the tags, texts and names
+// All records consist of 4 and 8 byte fields, so that they are aligned.
+struct ParticleDatabase::Header {
+  char Magic[8];
+  std::uint32_t FormatVersion;
+  std::uint32_t ByteOrderMark;
+  std::int64_t SourceModificationTime;
+  std::uint64_t SourceSize;
+  std::uint32_t NumberOfParticles;
+  std::uint32_t NumberOfElements;
+  std::uint32_t NameIndexSize;
+  std::uint32_t PidIndexSize;
+  std::uint64_t StringsSize;
+};
+
+struct ParticleDatabase::Particle {
+  std::uint32_t Element;
+  std::uint32_t Name;
+  std::int32_t Pid;
+  std::uint32_t HasPid;
+};
+
+namespace {
+
+const char Magic[8] = {'P', 'C', 'P', 'W', 'A', 'P', 'D', 'B'};
+const std::uint32_t FormatVersion = 1;
+const std::uint32_t ByteOrderMark = 0x01020304;
+/// Nesting limit of the xml elements, which bounds the recursion when the
+/// trees are converted.
+const std::uint32_t MaximumDepth = 1000;
+
+struct SourceStamp {
+  std::int64_t ModificationTime;
+  std::uint64_t Size;
+};
+
+SourceStamp sourceStamp(const std::string &XmlFile) {
+  struct stat Status;
+  if (::stat(XmlFile.c_str(), &Status) != 0)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::ParticleDatabase: cannot access " + XmlFile + ": " +
+        std::strerror(errno));
+#if defined(__APPLE__)
+  auto const &Time = Status.st_mtimespec;
+#else
+  auto const &Time = Status.st_mtim;
+#endif
+  return SourceStamp{static_cast<std::int64_t>(Time.tv_sec) * 1000000000 +
+                         Time.tv_nsec,
+                     static_cast<std::uint64_t>(Status.st_size)};
+}
+
+std::uint64_t hashName(const char *Name) {
+  std::uint64_t Hash(0xcbf29ce484222325);
+  for (; *Name; ++Name) {
+    Hash ^= static_cast<unsigned char>(*Name);
+    Hash *= 0x100000001b3;
+  }
+  return Hash;
+}
+
+std::uint64_t hashPid(int Pid) {
+  // splitmix64 finalizer
+  auto Hash = static_cast<std::uint64_t>(static_cast<std::int64_t>(Pid));
+  Hash = (Hash ^ (Hash >> 30)) * 0xbf58476d1ce4e5b9;
+  Hash = (Hash ^ (Hash >> 27)) * 0x94d049bb133111eb;
+  return Hash ^ (Hash >> 31);
+}
+
+std::string absolutePath(const std::string &FileName) {
+  char AbsolutePath[PATH_MAX];
+  return ::realpath(FileName.c_str(), AbsolutePath) ? AbsolutePath : FileName;
+}
+
+std::string trim(const std::string &Text) {
+  auto Begin = Text.find_first_not_of(" \t\n\r");
+  if (Begin == std::string::npos)
+    return "";
+  auto End = Text.find_last_not_of(" \t\n\r");
+  return Text.substr(Begin, End - Begin + 1);
+}
+
+void createDirectory(const std::string &DirectoryName) {
+  if (::mkdir(DirectoryName.c_str(), 0755) != 0 && errno != EEXIST)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::ParticleDatabase: could not create directory " +
+        DirectoryName + ": " + std::strerror(errno));
+}
+
+std::string cacheDirectory() {
+  std::string Directory;
+  if (const char *CacheHome = std::getenv("XDG_CACHE_HOME")) {
+    Directory = CacheHome;
+  } else if (const char *Home = std::getenv("HOME")) {
+    Directory = std::string(Home) + "/.cache";
+  }
+  if (!Directory.empty()) {
+    try {
+      createDirectory(Directory);
+      createDirectory(Directory + "/pycompwa");
+      return Directory + "/pycompwa";
+    } catch (const ComPWA::BadParameter &Error) {
+      LOG(DEBUG) << Error.what();
+    }
+  }
+  const char *TemporaryDirectory = std::getenv("TMPDIR");
+  return TemporaryDirectory ? TemporaryDirectory : "/tmp";
+}
+
+/// Smallest power of two which is at least twice the number of entries, so
+/// that the probing sequences stay short.
+std::uint32_t indexSize(std::size_t NumberOfEntries) {
+  std::uint32_t Size(2);
+  while (Size < 2 * NumberOfEntries)
+    Size *= 2;
+  return Size;
+}
+
+/// Flattens the xml trees of the particles into the records of the
+/// database.
+class DatabaseBuilder {
+public:
+  void addParticle(const boost::property_tree::ptree &Tree) {
+    std::string Name = Tree.get("<xmlattr>.Name", "");
+    Particle Record{addElement("Particle", Tree, false, 0), addString(Name), 0,
+                    0};
+    if (auto Pid = Tree.get_optional<std::string>("Pid")) {
+      try {
+        Record.Pid = std::stoi(trim(*Pid));
+        Record.HasPid = 1;
+      } catch (const std::exception &) {
+        LOG(DEBUG) << "ParticleDatabase: invalid pid of " << Name;
+      }
+    }
+    Particles.push_back(Record);
+    Names.push_back(Name);
+  }
+
+  /// Contents of the database file.
+  std::vector<char> serialize(const SourceStamp &Source) const {
+    auto NameIndex = createIndex(
+        [this](std::size_t i) { return hashName(Names[i].c_str()); },
+        [this](std::size_t i, std::size_t j) { return Names[i] == Names[j]; },
+        [](std::size_t) { return true; });
+    auto PidIndex = createIndex(
+        [this](std::size_t i) { return hashPid(Particles[i].Pid); },
+        [this](std::size_t i, std::size_t j) {
+          return Particles[i].Pid == Particles[j].Pid;
+        },
+        [this](std::size_t i) { return Particles[i].HasPid != 0; });
+
+    Header FileHeader;
+    std::memcpy(FileHeader.Magic, Magic, sizeof(Magic));
+    FileHeader.FormatVersion = FormatVersion;
+    FileHeader.ByteOrderMark = ByteOrderMark;
+    FileHeader.SourceModificationTime = Source.ModificationTime;
+    FileHeader.SourceSize = Source.Size;
+    FileHeader.NumberOfParticles = Particles.size();
+    FileHeader.NumberOfElements = Elements.size();
+    FileHeader.NameIndexSize = NameIndex.size();
+    FileHeader.PidIndexSize = PidIndex.size();
+    FileHeader.StringsSize = Strings.size();
+
+    std::vector<char> Buffer;
+    appendArray(Buffer, &FileHeader, 1);
+    appendArray(Buffer, Particles.data(), Particles.size());
+    appendArray(Buffer, Elements.data(), Elements.size());
+    appendArray(Buffer, NameIndex.data(), NameIndex.size());
+    appendArray(Buffer, PidIndex.data(), PidIndex.size());
+    appendArray(Buffer, Strings.data(), Strings.size());
+    return Buffer;
+  }
+
+private:
+  using Header = ParticleDatabase::Header;
+  using Particle = ParticleDatabase::Particle;
+  using Element = ParticleDatabase::Element;
+
+  template <typename T>
+  static void appendArray(std::vector<char> &Buffer, const T *Data,
+                          std::size_t Size) {
+    auto Begin = reinterpret_cast<const char *>(Data);
+    Buffer.insert(Buffer.end(), Begin, Begin + Size * sizeof(T));
+  }
+
+  std::uint32_t addString(const std::string &String) {
+    auto Found = StringOffsets.find(String);
+    if (Found != StringOffsets.end())
+      return Found->second;
+    std::uint32_t Offset = Strings.size();
+    Strings.insert(Strings.end(), String.begin(), String.end());
+    Strings.push_back('\0');
+    StringOffsets.emplace(String, Offset);
+    return Offset;
+  }
+
+  std::uint32_t addElement(const std::string &Tag, const std::string &Text,
+                           bool IsAttribute) {
+    std::uint32_t Index = Elements.size();
+    Elements.push_back(Element{addString(Tag),
+                               Text.empty() ? ParticleDatabase::None
+                                            : addString(Text),
+                               ParticleDatabase::None, ParticleDatabase::None,
+                               IsAttribute ? 1u : 0u});
+    return Index;
+  }
+
+  std::uint32_t addElement(const std::string &Tag,
+                           const boost::property_tree::ptree &Tree,
+                           bool IsAttribute, std::uint32_t Depth) {
+    if (Depth >= MaximumDepth)
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::ParticleDatabase::compile(): elements are nested "
+          "too deeply!");
+    std::uint32_t Index = addElement(Tag, trim(Tree.data()), IsAttribute);
+    std::uint32_t Previous = ParticleDatabase::None;
+    auto link = [&](std::uint32_t Child) {
+      if (Previous == ParticleDatabase::None)
+        Elements[Index].FirstChild = Child;
+      else
+        Elements[Previous].NextSibling = Child;
+      Previous = Child;
+    };
+    for (auto const &Child : Tree) {
+      if (Child.first == "<xmlattr>") {
+        for (auto const &Attribute : Child.second)
+          link(addElement(Attribute.first, Attribute.second.data(), true));
+      } else if (Child.first != "<xmlcomment>") {
+        link(addElement(Child.first, Child.second, false, Depth + 1));
+      }
+    }
+    return Index;
+  }
+
+  template <typename HashFunction, typename EqualFunction,
+            typename FilterFunction>
+  std::vector<std::uint32_t> createIndex(HashFunction Hash, EqualFunction Equal,
+                                         FilterFunction Filter) const {
+    std::vector<std::uint32_t> Index(indexSize(Particles.size()),
+                                     ParticleDatabase::None);
+    std::size_t Mask = Index.size() - 1;
+    for (std::size_t i = 0; i < Particles.size(); ++i) {
+      if (!Filter(i))
+        continue;
+      std::size_t Bucket = Hash(i) & Mask;
+      while (Index[Bucket] != ParticleDatabase::None &&
+             !Equal(Index[Bucket], i))
+        Bucket = (Bucket + 1) & Mask;
+      Index[Bucket] = i;
+    }
+    return Index;
+  }
+
+  std::vector<Particle> Particles;
+  std::vector<std::string> Names;
+  std::vector<Element> Elements;
+  std::vector<char> Strings;
+  std::unordered_map<std::string, std::uint32_t> StringOffsets;
+};
+
+std::vector<char> compileParticles(const std::string &XmlFile,
+                                   const SourceStamp &Source) {
+  boost::property_tree::ptree Tree;
+  boost::property_tree::xml_parser::read_xml(XmlFile, Tree);
+
+  DatabaseBuilder Builder;
+  for (auto const &ParticleList : Tree) {
+    if (ParticleList.first != "ParticleList")
+      continue;
+    for (auto const &Particle : ParticleList.second) {
+      if (Particle.first == "Particle")
+        Builder.addParticle(Particle.second);
+    }
+  }
+  return Builder.serialize(Source);
+}
+
+void writeFile(const std::string &FileName, const std::vector<char> &Data) {
+  std::ofstream File(FileName, std::ios::binary);
+  if (!File)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::ParticleDatabase::compile(): cannot open " +
+        FileName);
+  File.write(Data.data(), Data.size());
+  File.close();
+  if (!File)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::ParticleDatabase::compile(): failed writing " +
+        FileName);
+}
+
+} // namespace
+
+const std::uint32_t ParticleDatabase::None;
+
+std::shared_ptr<ParticleDatabase>
+ParticleDatabase::open(const std::string &XmlFile, bool UseCacheFile) {
+  static std::mutex Mutex;
+  static std::map<std::pair<std::string, bool>,
+                  std::shared_ptr<ParticleDatabase>>
+      Opened;
+
+  auto Source = sourceStamp(XmlFile);
+  auto Key = std::make_pair(absolutePath(XmlFile), UseCacheFile);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto Found = Opened.find(Key);
+  if (Found != Opened.end() &&
+      Found->second->header().SourceModificationTime ==
+          Source.ModificationTime &&
+      Found->second->header().SourceSize == Source.Size)
+    return Found->second;
+
+  std::shared_ptr<ParticleDatabase> Database;
+  if (!UseCacheFile) {
+    Database.reset(new ParticleDatabase(compileParticles(XmlFile, Source)));
+    auto CompiledSource = sourceStamp(XmlFile);
+    if (CompiledSource.ModificationTime != Source.ModificationTime ||
+        CompiledSource.Size != Source.Size)
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::ParticleDatabase::open(): " + XmlFile +
+          " changed while compiling the database!");
+    Opened[Key] = Database;
+    return Database;
+  }
+
+  auto DatabaseFile = databaseFile(XmlFile);
+  Database = map(DatabaseFile, Source.ModificationTime, Source.Size);
+  if (!Database) {
+    LOG(INFO) << "ParticleDatabase::open(): compiling " << XmlFile << " to "
+              << DatabaseFile;
+    compile(XmlFile, DatabaseFile);
+    Database = map(DatabaseFile, Source.ModificationTime, Source.Size);
+    if (!Database)
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::ParticleDatabase::open(): " + XmlFile +
+          " changed while compiling the database!");
+  }
+  Opened[Key] = Database;
+  return Database;
+}
+
+void ParticleDatabase::compile(const std::string &XmlFile,
+                               const std::string &DatabaseFile) {
+  auto Data = compileParticles(XmlFile, sourceStamp(XmlFile));
+
+  // other processes only ever see complete databases
+  std::string TemporaryFile =
+      DatabaseFile + "." + std::to_string(::getpid()) + ".tmp";
+  try {
+    writeFile(TemporaryFile, Data);
+  } catch (...) {
+    std::remove(TemporaryFile.c_str());
+    throw;
+  }
+  if (std::rename(TemporaryFile.c_str(), DatabaseFile.c_str()) != 0) {
+    std::remove(TemporaryFile.c_str());
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::ParticleDatabase::compile(): cannot write " +
+        DatabaseFile + ": " + std::strerror(errno));
+  }
+}
+
+std::string ParticleDatabase::databaseFile(const std::string &XmlFile) {
+  std::string Path(absolutePath(XmlFile));
+  auto Slash = Path.rfind('/');
+  std::string BaseName(Slash == std::string::npos ? Path
+                                                  : Path.substr(Slash + 1));
+  std::stringstream FileName;
+  FileName << cacheDirectory() << "/" << BaseName << "-" << std::hex
+           << hashName(Path.c_str()) << ".particledb";
+  return FileName.str();
+}
+
+std::shared_ptr<ParticleDatabase>
+ParticleDatabase::map(const std::string &DatabaseFile,
+                      std::int64_t SourceModificationTime,
+                      std::uint64_t SourceSize) {
+  int FileDescriptor = ::open(DatabaseFile.c_str(), O_RDONLY);
+  if (FileDescriptor < 0)
+    return nullptr;
+  struct stat Status;
+  if (::fstat(FileDescriptor, &Status) != 0 ||
+      static_cast<std::size_t>(Status.st_size) < sizeof(Header)) {
+    ::close(FileDescriptor);
+    return nullptr;
+  }
+  std::size_t Size = Status.st_size;
+  void *Data = ::mmap(nullptr, Size, PROT_READ, MAP_SHARED, FileDescriptor, 0);
+  ::close(FileDescriptor);
+  if (Data == MAP_FAILED)
+    return nullptr;
+  std::shared_ptr<ParticleDatabase> Database(
+      new ParticleDatabase(DatabaseFile, Data, Size));
+
+  auto const &FileHeader = Database->header();
+  if (std::memcmp(FileHeader.Magic, Magic, sizeof(Magic)) != 0 ||
+      FileHeader.FormatVersion != FormatVersion ||
+      FileHeader.ByteOrderMark != ByteOrderMark ||
+      FileHeader.SourceModificationTime != SourceModificationTime ||
+      FileHeader.SourceSize != SourceSize)
+    return nullptr;
+  std::uint64_t ExpectedSize =
+      sizeof(Header) +
+      std::uint64_t(FileHeader.NumberOfParticles) * sizeof(Particle) +
+      std::uint64_t(FileHeader.NumberOfElements) * sizeof(Element) +
+      (std::uint64_t(FileHeader.NameIndexSize) + FileHeader.PidIndexSize) *
+          sizeof(std::uint32_t) +
+      FileHeader.StringsSize;
+  if (ExpectedSize != Size || FileHeader.NameIndexSize == 0 ||
+      FileHeader.PidIndexSize == 0 ||
+      (FileHeader.NameIndexSize & (FileHeader.NameIndexSize - 1)) != 0 ||
+      (FileHeader.PidIndexSize & (FileHeader.PidIndexSize - 1)) != 0 ||
+      (FileHeader.StringsSize > 0 &&
+       Database->Strings[FileHeader.StringsSize - 1] != '\0'))
+    return nullptr;
+
+  // corrupt files must not lead to reads outside of the mapping
+  auto validElement = [&](std::uint32_t x) {
+    return x == None || x < FileHeader.NumberOfElements;
+  };
+  auto validString = [&](std::uint32_t x) {
+    return x == None || x < FileHeader.StringsSize;
+  };
+  // The elements form a forest, in which the children and next siblings
+  // follow their element, as written by the DatabaseBuilder. So the walks
+  // through the trees end and their depth is limited.
+  std::vector<std::uint32_t> Depths(FileHeader.NumberOfElements, 0);
+  std::vector<bool> Linked(FileHeader.NumberOfElements, false);
+  auto link = [&](std::uint32_t Element, std::uint32_t Target,
+                  std::uint32_t Depth) {
+    if (Target == None)
+      return true;
+    if (Target <= Element || Linked[Target] || Depth >= MaximumDepth)
+      return false;
+    Linked[Target] = true;
+    Depths[Target] = Depth;
+    return true;
+  };
+  for (std::uint32_t i = 0; i < FileHeader.NumberOfElements; ++i) {
+    auto const &x = Database->Elements[i];
+    if (x.Tag == None || !validString(x.Tag) || !validString(x.Text) ||
+        !validElement(x.FirstChild) || !validElement(x.NextSibling) ||
+        !link(i, x.FirstChild, Depths[i] + 1) ||
+        !link(i, x.NextSibling, Depths[i]))
+      return nullptr;
+  }
+  for (std::size_t i = 0; i < FileHeader.NumberOfParticles; ++i) {
+    auto const &x = Database->Particles[i];
+    if (x.Element >= FileHeader.NumberOfElements || Linked[x.Element] ||
+        x.Name == None || !validString(x.Name))
+      return nullptr;
+  }
+  // the probing of a full index would not end
+  auto validIndex = [&](const std::uint32_t *Index, std::size_t Size) {
+    bool HasFreeBucket(false);
+    for (std::size_t i = 0; i < Size; ++i) {
+      if (Index[i] == None)
+        HasFreeBucket = true;
+      else if (Index[i] >= FileHeader.NumberOfParticles)
+        return false;
+    }
+    return HasFreeBucket;
+  };
+  if (!validIndex(Database->NameIndex, FileHeader.NameIndexSize) ||
+      !validIndex(Database->PidIndex, FileHeader.PidIndexSize))
+    return nullptr;
+  return Database;
+}
+
+ParticleDatabase::ParticleDatabase(std::string FileName_, const void *Data_,
+                                   std::size_t Size_)
+    : FileName(std::move(FileName_)), Data(static_cast<const char *>(Data_)),
+      Size(Size_) {
+  setPointers();
+}
+
+ParticleDatabase::ParticleDatabase(std::vector<char> Buffer_)
+    : Buffer(std::move(Buffer_)), Data(Buffer.data()), Size(Buffer.size()) {
+  setPointers();
+}
+
+void ParticleDatabase::setPointers() {
+  auto const &FileHeader = header();
+  Particles = reinterpret_cast<const Particle *>(Data + sizeof(Header));
+  Elements = reinterpret_cast<const Element *>(
+      Particles + FileHeader.NumberOfParticles);
+  NameIndex = reinterpret_cast<const std::uint32_t *>(
+      Elements + FileHeader.NumberOfElements);
+  PidIndex = NameIndex + FileHeader.NameIndexSize;
+  Strings = reinterpret_cast<const char *>(PidIndex + FileHeader.PidIndexSize);
+}
+
+ParticleDatabase::~ParticleDatabase() {
+  if (Buffer.empty())
+    ::munmap(const_cast<char *>(Data), Size);
+}
+
+const ParticleDatabase::Header &ParticleDatabase::header() const {
+  return *reinterpret_cast<const Header *>(Data);
+}
+
+const ParticleDatabase::Particle &
+ParticleDatabase::particle(std::size_t Index) const {
+  if (Index >= size())
+    throw ComPWA::BadParameter("PyComPWA::Tools::ParticleDatabase: particle "
+                               "index out of range!");
+  return Particles[Index];
+}
+
+std::size_t ParticleDatabase::size() const {
+  return header().NumberOfParticles;
+}
+
+const char *ParticleDatabase::name(std::size_t Particle) const {
+  return string(particle(Particle).Name);
+}
+
+bool ParticleDatabase::hasPid(std::size_t Particle) const {
+  return particle(Particle).HasPid != 0;
+}
+
+int ParticleDatabase::pid(std::size_t Particle) const {
+  return particle(Particle).Pid;
+}
+
+std::uint32_t ParticleDatabase::element(std::size_t Particle) const {
+  return particle(Particle).Element;
+}
+
+std::uint32_t ParticleDatabase::findByName(const std::string &Name) const {
+  std::size_t Mask = header().NameIndexSize - 1;
+  for (std::size_t Bucket = hashName(Name.c_str()) & Mask;
+       NameIndex[Bucket] != None; Bucket = (Bucket + 1) & Mask) {
+    if (Name == string(Particles[NameIndex[Bucket]].Name))
+      return NameIndex[Bucket];
+  }
+  return None;
+}
+
+std::uint32_t ParticleDatabase::findByPid(int Pid) const {
+  std::size_t Mask = header().PidIndexSize - 1;
+  for (std::size_t Bucket = hashPid(Pid) & Mask; PidIndex[Bucket] != None;
+       Bucket = (Bucket + 1) & Mask) {
+    if (Particles[PidIndex[Bucket]].Pid == Pid)
+      return PidIndex[Bucket];
+  }
+  return None;
+}
+
+const ParticleDatabase::Element &
+ParticleDatabase::elementAt(std::uint32_t Index) const {
+  if (Index >= header().NumberOfElements)
+    throw ComPWA::BadParameter("PyComPWA::Tools::ParticleDatabase: element "
+                               "index out of range!");
+  return Elements[Index];
+}
+
+const char *ParticleDatabase::string(std::uint32_t Offset) const {
+  return Offset == None ? "" : Strings + Offset;
+}
+
+namespace {
+
+boost::property_tree::ptree
+createPropertyTree(const ParticleDatabase &Database, std::uint32_t Index) {
+  auto const &Parent = Database.elementAt(Index);
+  boost::property_tree::ptree Tree(Database.string(Parent.Text));
+  for (auto Child = Parent.FirstChild; Child != ParticleDatabase::None;
+       Child = Database.elementAt(Child).NextSibling) {
+    auto const &x = Database.elementAt(Child);
+    if (x.IsAttribute)
+      Tree.put(boost::property_tree::ptree::path_type(
+                   std::string("<xmlattr>/") + Database.string(x.Tag), '/'),
+               Database.string(x.Text));
+    else
+      Tree.push_back(
+          std::make_pair(Database.string(x.Tag),
+                         createPropertyTree(Database, Child)));
+  }
+  return Tree;
+}
+
+} // namespace
+
+boost::property_tree::ptree
+ParticleDatabase::propertyTree(std::size_t Particle) const {
+  return createPropertyTree(*this, element(Particle));
+}
+
+boost::property_tree::ptree ParticleDatabase::particleList() const {
+  boost::property_tree::ptree List;
+  for (std::size_t i = 0; i < size(); ++i)
+    List.push_back(std::make_pair("Particle", propertyTree(i)));
+  boost::property_tree::ptree Tree;
+  Tree.add_child("ParticleList", List);
+  return Tree;
+}
+
+} // namespace Tools
+} // namespace PyComPWA
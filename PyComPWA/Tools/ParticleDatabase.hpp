@@ -0,0 +1,129 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_PARTICLEDATABASE_HPP_
+#define PYCOMPWA_TOOLS_PARTICLEDATABASE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace PyComPWA {
+namespace Tools {
+
+///
+/// \class ParticleDatabase
+/// Compiled form of the particles of a xml particle list. The xml elements
+/// of each particle are stored as a flat tree, together with hash indices of
+/// the particles by name and pid. The database is compiled again if the
+/// modification time or size of the xml file change. See
+/// ParticleDatabase.cpp for the file layout.
+///
+/// All users of the same xml file in a process, e.g. the ComPWA particle
+/// list and the python expert system, share one database. By default it is
+/// compiled in memory. Optionally it is written once per xml file to the
+/// cache directory, so that processes share the pages of the file and only
+/// the first process parses the xml file.
+///
+class ParticleDatabase {
+public:
+  /// Element of the xml tree. Attributes are stored as the first children of
+  /// their element.
+  struct Element {
+    std::uint32_t Tag;
+    std::uint32_t Text;
+    std::uint32_t FirstChild;
+    std::uint32_t NextSibling;
+    std::uint32_t IsAttribute;
+  };
+
+  /// Records of the database file, see ParticleDatabase.cpp.
+  struct Header;
+  struct Particle;
+
+  /// Marks missing texts, children and index entries.
+  static const std::uint32_t None = 0xffffffff;
+
+  /// Opens the database of \p XmlFile. With \p UseCacheFile, the database
+  /// file in the cache directory is mapped, which is compiled first if it
+  /// does not exist or is outdated.
+  static std::shared_ptr<ParticleDatabase> open(const std::string &XmlFile,
+                                                bool UseCacheFile = false);
+
+  /// Compiles the particles of the ParticleList of \p XmlFile. Later
+  /// particles with the same name or pid replace earlier ones in the indices,
+  /// as in ComPWA::insertParticles().
+  static void compile(const std::string &XmlFile,
+                      const std::string &DatabaseFile);
+
+  /// Path of the database of \p XmlFile in the cache directory, which is
+  /// `$XDG_CACHE_HOME/pycompwa`, `~/.cache/pycompwa` or the temporary
+  /// directory.
+  static std::string databaseFile(const std::string &XmlFile);
+
+  ~ParticleDatabase();
+  ParticleDatabase(const ParticleDatabase &) = delete;
+  ParticleDatabase &operator=(const ParticleDatabase &) = delete;
+
+  /// Database file, empty if the database is held in memory.
+  const std::string &fileName() const { return FileName; }
+
+  std::size_t size() const;
+
+  const char *name(std::size_t Particle) const;
+  bool hasPid(std::size_t Particle) const;
+  int pid(std::size_t Particle) const;
+  /// Index of the Particle element of the particle.
+  std::uint32_t element(std::size_t Particle) const;
+
+  /// Index of the particle or None.
+  std::uint32_t findByName(const std::string &Name) const;
+  std::uint32_t findByPid(int Pid) const;
+
+  const Element &elementAt(std::uint32_t Index) const;
+  const char *string(std::uint32_t Offset) const;
+
+  /// Property tree of the particle, as read from the xml file.
+  boost::property_tree::ptree propertyTree(std::size_t Particle) const;
+
+  /// Property tree with a ParticleList of all particles, which can be passed
+  /// to ComPWA::insertParticles().
+  boost::property_tree::ptree particleList() const;
+
+private:
+  ParticleDatabase(std::string FileName, const void *Data, std::size_t Size);
+  ParticleDatabase(std::vector<char> Buffer);
+
+  void setPointers();
+
+  /// Maps the database. Returns a null pointer if it is missing, invalid or
+  /// does not belong to the given version of the xml file. The element
+  /// trees are checked for cycles and their depth is limited.
+  static std::shared_ptr<ParticleDatabase>
+  map(const std::string &DatabaseFile, std::int64_t SourceModificationTime,
+      std::uint64_t SourceSize);
+
+  const Header &header() const;
+  const Particle &particle(std::size_t Index) const;
+
+  std::string FileName;
+  /// Data of a database in memory.
+  std::vector<char> Buffer;
+  const char *Data;
+  std::size_t Size;
+  const Particle *Particles;
+  const Element *Elements;
+  const std::uint32_t *NameIndex;
+  const std::uint32_t *PidIndex;
+  const char *Strings;
+};
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
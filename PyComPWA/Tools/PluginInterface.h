@@ -0,0 +1,59 @@
+/* Copyright (c) 2019 The ComPWA Team.
+ * This file is part of the ComPWA framework, check
+ * https://github.com/ComPWA/ComPWA/license.txt for details.
+ */
+
+/*
+ * C interface of plugins with compiled intensity functions, which
+ * pycompwa.ui.load_plugin() loads at runtime. A plugin is a shared library
+ * which exports
+ *
+ *   const struct pycompwa_plugin *pycompwa_plugin_entry(void);
+ *
+ * The returned description and all strings and arrays it points to have to
+ * stay valid while the library is loaded. Only C types are used, so plugins
+ * can be compiled with any compiler and standard library. The interface
+ * changes only together with PYCOMPWA_PLUGIN_ABI_VERSION.
+ */
+
+#ifndef PYCOMPWA_TOOLS_PLUGININTERFACE_H_
+#define PYCOMPWA_TOOLS_PLUGININTERFACE_H_
+
+#include <stddef.h>
+
+#define PYCOMPWA_PLUGIN_ABI_VERSION 1
+#define PYCOMPWA_PLUGIN_ENTRY "pycompwa_plugin_entry"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct pycompwa_intensity_function {
+  /* Unique name, e.g. "MyPlugin.KMatrix". */
+  const char *name;
+  size_t number_of_parameters;
+  const char *const *parameter_names;
+  const double *default_parameter_values;
+  /* Computes the intensities of a block of events from the data columns,
+   * i.e. the kinematic variables, and the parameter values. Returns zero on
+   * success. May be called from several threads at once. */
+  int (*evaluate)(const double *const *columns, size_t number_of_columns,
+                  size_t number_of_events, const double *parameters,
+                  double *results);
+};
+
+struct pycompwa_plugin {
+  /* Has to be PYCOMPWA_PLUGIN_ABI_VERSION. */
+  unsigned int abi_version;
+  const char *name;
+  size_t number_of_functions;
+  const struct pycompwa_intensity_function *functions;
+};
+
+typedef const struct pycompwa_plugin *(*pycompwa_plugin_entry_function)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
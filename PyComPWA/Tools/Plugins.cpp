@@ -0,0 +1,174 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <climits>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+
+#include <dlfcn.h>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/Tools/PluginInterface.h"
+#include "PyComPWA/Tools/Plugins.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+namespace {
+
+struct PluginRegistry {
+  std::mutex Mutex;
+  /// Canonical paths of the loaded libraries.
+  std::set<std::string> Libraries;
+  std::map<std::string, const pycompwa_intensity_function *> Functions;
+};
+
+PluginRegistry &registry() {
+  static PluginRegistry Registry;
+  return Registry;
+}
+
+std::string canonicalPath(const std::string &FileName) {
+  char Path[PATH_MAX];
+  if (!realpath(FileName.c_str(), Path))
+    throw ComPWA::BadParameter("PyComPWA::Tools::loadPlugin(): " + FileName +
+                               " does not exist!");
+  return Path;
+}
+
+/// Closes a library unless it is released after all checks passed.
+struct LibraryCloser {
+  void operator()(void *Library) const { dlclose(Library); }
+};
+
+const pycompwa_intensity_function *findFunction(const std::string &Name,
+                                                const char *Caller) {
+  auto &Registry = registry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  auto it = Registry.Functions.find(Name);
+  if (it == Registry.Functions.end())
+    throw ComPWA::BadParameter("PyComPWA::Tools::" + std::string(Caller) +
+                               "(): no plugin function " + Name + "!");
+  return it->second;
+}
+
+/// Throws if the plugin function fails.
+void checkError(const pycompwa_intensity_function *Function, int Error) {
+  if (Error)
+    throw ComPWA::BadParameter(std::string("plugin function ") +
+                               Function->name + " failed with error code " +
+                               std::to_string(Error));
+}
+
+} // namespace
+
+std::vector<std::string> loadPlugin(const std::string &FileName) {
+  auto Path = canonicalPath(FileName);
+  auto &Registry = registry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+
+  std::unique_ptr<void, LibraryCloser> Library(
+      dlopen(Path.c_str(), RTLD_NOW | RTLD_LOCAL));
+  if (!Library)
+    throw ComPWA::BadParameter("PyComPWA::Tools::loadPlugin(): " +
+                               std::string(dlerror()));
+  auto Entry = reinterpret_cast<pycompwa_plugin_entry_function>(
+      dlsym(Library.get(), PYCOMPWA_PLUGIN_ENTRY));
+  const pycompwa_plugin *Plugin = Entry ? Entry() : nullptr;
+  if (!Plugin)
+    throw ComPWA::BadParameter("PyComPWA::Tools::loadPlugin(): " + Path +
+                               " is not a pycompwa plugin!");
+  if (Plugin->abi_version != PYCOMPWA_PLUGIN_ABI_VERSION)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::loadPlugin(): " + Path + " has ABI version " +
+        std::to_string(Plugin->abi_version) + " instead of " +
+        std::to_string(PYCOMPWA_PLUGIN_ABI_VERSION) + "!");
+
+  std::vector<std::string> Names;
+  std::set<std::string> UniqueNames;
+  for (std::size_t i = 0; i < Plugin->number_of_functions; ++i) {
+    auto const &Function = Plugin->functions[i];
+    if (!Function.name || !Function.evaluate ||
+        (Function.number_of_parameters &&
+         (!Function.parameter_names || !Function.default_parameter_values)))
+      throw ComPWA::BadParameter("PyComPWA::Tools::loadPlugin(): function " +
+                                 std::to_string(i) + " of " + Path +
+                                 " is incomplete!");
+    if (!UniqueNames.insert(Function.name).second)
+      throw ComPWA::BadParameter("PyComPWA::Tools::loadPlugin(): function " +
+                                 std::string(Function.name) +
+                                 " is defined twice in " + Path + "!");
+    Names.push_back(Function.name);
+  }
+  // dlopen() returns the same handle for a library which is already loaded,
+  // closing it again only decrements the reference count
+  if (Registry.Libraries.count(Path))
+    return Names;
+  for (auto const &Name : Names) {
+    if (Registry.Functions.count(Name))
+      throw ComPWA::BadParameter("PyComPWA::Tools::loadPlugin(): function " +
+                                 Name + " of " + Path +
+                                 " is already defined by another plugin!");
+  }
+
+  // all checks passed, the library stays loaded
+  Library.release();
+  for (std::size_t i = 0; i < Names.size(); ++i)
+    Registry.Functions[Names[i]] = &Plugin->functions[i];
+  Registry.Libraries.insert(Path);
+  LOG(INFO) << "loadPlugin(): loaded " << Names.size()
+            << " intensity functions of plugin "
+            << (Plugin->name ? Plugin->name : "") << " from " << Path;
+  return Names;
+}
+
+std::vector<std::string> pluginIntensityFunctions() {
+  auto &Registry = registry();
+  std::lock_guard<std::mutex> Lock(Registry.Mutex);
+  std::vector<std::string> Names;
+  for (auto const &x : Registry.Functions)
+    Names.push_back(x.first);
+  return Names;
+}
+
+std::shared_ptr<VectorizedIntensity>
+createPluginIntensity(const std::string &Name,
+                      const std::map<std::string, double> &Parameters,
+                      std::size_t BlockSize) {
+  auto Function = findFunction(Name, "createPluginIntensity");
+  std::vector<ComPWA::Parameter> Values;
+  std::size_t NumberOfGivenParameters(0);
+  for (std::size_t i = 0; i < Function->number_of_parameters; ++i) {
+    std::string ParameterName = Function->parameter_names[i];
+    auto Value = Parameters.find(ParameterName);
+    if (Value != Parameters.end())
+      ++NumberOfGivenParameters;
+    Values.push_back(
+        {ParameterName, Value != Parameters.end()
+                            ? Value->second
+                            : Function->default_parameter_values[i]});
+  }
+  if (NumberOfGivenParameters != Parameters.size())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::createPluginIntensity(): unknown parameters for " +
+        Name + "!");
+
+  return std::make_shared<VectorizedIntensity>(
+      [Function](const std::vector<const double *> &Columns,
+                 std::size_t NumberOfEvents,
+                 const std::vector<double> &ParameterValues,
+                 double *Results) {
+        checkError(Function,
+                   Function->evaluate(Columns.data(), Columns.size(),
+                                      NumberOfEvents, ParameterValues.data(),
+                                      Results));
+      },
+      Values, BlockSize);
+}
+
+} // namespace Tools
+} // namespace PyComPWA
@@ -0,0 +1,39 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_PLUGINS_HPP_
+#define PYCOMPWA_TOOLS_PLUGINS_HPP_
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PyComPWA/Tools/VectorizedIntensity.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+/// Loads a plugin library, see PluginInterface.h, and registers its
+/// intensity functions. Returns the names of the functions. The functions
+/// are registered only if the whole plugin is valid and none of its names is
+/// taken. Loading a library again has no effect. Plugins are never unloaded,
+/// as their functions may still be in use.
+std::vector<std::string> loadPlugin(const std::string &FileName);
+
+/// Names of the intensity functions of all loaded plugins.
+std::vector<std::string> pluginIntensityFunctions();
+
+/// Intensity evaluated by a plugin function. Parameters which are not given
+/// have their default values.
+std::shared_ptr<VectorizedIntensity>
+createPluginIntensity(const std::string &Name,
+                      const std::map<std::string, double> &Parameters = {},
+                      std::size_t BlockSize = 65536);
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
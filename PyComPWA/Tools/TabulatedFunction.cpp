@@ -0,0 +1,179 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Core/Exceptions.hpp"
+
+#include "PyComPWA/Tools/TabulatedFunction.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+template <typename T>
+BasicTabulatedFunction<T>::BasicTabulatedFunction(SourceFunction Function,
+                                                  double Minimum,
+                                                  double Maximum,
+                                                  std::size_t NumberOfPoints)
+    : Function(std::move(Function)), Minimum(Minimum), Maximum(Maximum) {
+  if (!this->Function)
+    throw ComPWA::BadParameter("PyComPWA::Tools::TabulatedFunction::"
+                               "TabulatedFunction(): no function given!");
+  if (!(Minimum < Maximum) || NumberOfPoints < 4)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::TabulatedFunction::TabulatedFunction(): the grid "
+        "needs a non-empty range and at least 4 points!");
+  Step = (Maximum - Minimum) / (NumberOfPoints - 1);
+
+  std::vector<double> Grid(NumberOfPoints);
+  for (std::size_t i = 0; i < NumberOfPoints; ++i)
+    Grid[i] = Minimum + i * Step;
+  Grid.back() = Maximum;
+  Values = this->Function(Grid);
+  if (Values.size() != NumberOfPoints)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::TabulatedFunction::TabulatedFunction(): the "
+        "function returned " +
+        std::to_string(Values.size()) + " values for " +
+        std::to_string(NumberOfPoints) + " points!");
+
+  // Thomas algorithm for the tridiagonal system of the natural spline on an
+  // equidistant grid: M[i-1] + 4 M[i] + M[i+1] = 6 / h^2 * (second difference)
+  // The system is real, so for complex values it is solved for the real and
+  // imaginary parts independently.
+  std::size_t n = NumberOfPoints;
+  SecondDerivatives.assign(n, T(0.0));
+  std::vector<double> Diagonal(n, 4.0);
+  for (std::size_t i = 1; i + 1 < n; ++i)
+    SecondDerivatives[i] =
+        6.0 * (Values[i + 1] - 2.0 * Values[i] + Values[i - 1]) /
+        (Step * Step);
+  for (std::size_t i = 2; i + 1 < n; ++i) {
+    double Factor = 1.0 / Diagonal[i - 1];
+    Diagonal[i] -= Factor;
+    SecondDerivatives[i] -= Factor * SecondDerivatives[i - 1];
+  }
+  // the last second derivative is zero
+  for (std::size_t i = n - 2; i >= 1; --i)
+    SecondDerivatives[i] =
+        (SecondDerivatives[i] - SecondDerivatives[i + 1]) / Diagonal[i];
+}
+
+template <typename T>
+std::vector<T> BasicTabulatedFunction<T>::evaluate(const double *Points,
+                                                   std::size_t Size) const {
+  std::vector<T> Results(Size);
+  std::vector<std::size_t> Outside;
+  double LastInterval = Values.size() - 2;
+  for (std::size_t i = 0; i < Size; ++i) {
+    double x = (Points[i] - Minimum) / Step;
+    // NaN fails both comparisons and is evaluated directly too
+    if (!(x >= 0.0 && Points[i] <= Maximum)) {
+      Outside.push_back(i);
+      continue;
+    }
+    double Interval = std::floor(x);
+    if (Interval > LastInterval)
+      Interval = LastInterval;
+    std::size_t j = static_cast<std::size_t>(Interval);
+    double b = x - Interval;
+    double a = 1.0 - b;
+    Results[i] = a * Values[j] + b * Values[j + 1] +
+                 ((a * a * a - a) * SecondDerivatives[j] +
+                  (b * b * b - b) * SecondDerivatives[j + 1]) *
+                     (Step * Step) / 6.0;
+  }
+
+  if (!Outside.empty()) {
+    std::vector<double> OutsidePoints;
+    for (auto i : Outside)
+      OutsidePoints.push_back(Points[i]);
+    auto OutsideValues = Function(OutsidePoints);
+    if (OutsideValues.size() != Outside.size())
+      throw ComPWA::BadParameter(
+          "PyComPWA::Tools::TabulatedFunction::evaluate(): the function "
+          "returned a wrong number of values!");
+    for (std::size_t i = 0; i < Outside.size(); ++i)
+      Results[Outside[i]] = OutsideValues[i];
+  }
+  return Results;
+}
+
+template <typename T>
+TabulationAccuracy BasicTabulatedFunction<T>::estimateAccuracy() const {
+  std::vector<double> Centers;
+  for (std::size_t i = 0; i + 1 < Values.size(); ++i)
+    Centers.push_back(Minimum + (i + 0.5) * Step);
+  auto Exact = Function(Centers);
+  auto Interpolated = evaluate(Centers);
+  if (Exact.size() != Centers.size())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::TabulatedFunction::estimateAccuracy(): the "
+        "function returned a wrong number of values!");
+
+  TabulationAccuracy Accuracy{0.0, 0.0, Centers.front()};
+  for (std::size_t i = 0; i < Centers.size(); ++i) {
+    double Error = std::abs(Interpolated[i] - Exact[i]);
+    double RelativeError =
+        Exact[i] != 0.0 ? Error / std::abs(Exact[i])
+                        : (Error != 0.0
+                               ? std::numeric_limits<double>::infinity()
+                               : 0.0);
+    Accuracy.MaximumAbsoluteError =
+        std::max(Accuracy.MaximumAbsoluteError, Error);
+    if (RelativeError > Accuracy.MaximumRelativeError) {
+      Accuracy.MaximumRelativeError = RelativeError;
+      Accuracy.WorstPoint = Centers[i];
+    }
+  }
+  return Accuracy;
+}
+
+template class BasicTabulatedFunction<double>;
+template class BasicTabulatedFunction<std::complex<double>>;
+
+TabulatedFunction::SourceFunction
+intensitySlice(std::shared_ptr<ComPWA::Intensity> Intensity,
+               std::size_t VariableIndex, std::vector<double> ReferenceValues) {
+  if (!Intensity)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::intensitySlice(): no intensity given!");
+  if (VariableIndex >= ReferenceValues.size())
+    throw ComPWA::BadParameter("PyComPWA::Tools::intensitySlice(): variable " +
+                               std::to_string(VariableIndex) +
+                               " has no reference value!");
+  return [Intensity, VariableIndex,
+          ReferenceValues](const std::vector<double> &Points) {
+    std::vector<std::vector<double>> Data;
+    for (auto Value : ReferenceValues)
+      Data.emplace_back(Points.size(), Value);
+    Data[VariableIndex] = Points;
+    return Intensity->evaluate(Data);
+  };
+}
+
+std::shared_ptr<VectorizedIntensity>
+createTabulatedIntensity(std::shared_ptr<const TabulatedFunction> Table,
+                         std::size_t VariableIndex) {
+  if (!Table)
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::createTabulatedIntensity(): no table given!");
+  return std::make_shared<VectorizedIntensity>(
+      [Table, VariableIndex](const std::vector<const double *> &Columns,
+                             std::size_t NumberOfEvents,
+                             const std::vector<double> &, double *Results) {
+        if (VariableIndex >= Columns.size())
+          throw ComPWA::BadParameter(
+              "tabulated intensity: the data has only " +
+              std::to_string(Columns.size()) + " variables!");
+        auto Values = Table->evaluate(Columns[VariableIndex], NumberOfEvents);
+        std::copy(Values.begin(), Values.end(), Results);
+      },
+      std::vector<ComPWA::Parameter>());
+}
+
+} // namespace Tools
+} // namespace PyComPWA
@@ -0,0 +1,91 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_TABULATEDFUNCTION_HPP_
+#define PYCOMPWA_TOOLS_TABULATEDFUNCTION_HPP_
+
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PyComPWA/Tools/VectorizedIntensity.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+struct TabulationAccuracy {
+  double MaximumAbsoluteError;
+  double MaximumRelativeError;
+  /// Point with the largest relative error.
+  double WorstPoint;
+};
+
+///
+/// \class BasicTabulatedFunction
+/// Function of one variable, e.g. a lineshape with fixed parameters in the
+/// invariant mass squared, which is expensive to evaluate. It is sampled once
+/// on an equidistant grid and evaluated by natural cubic spline
+/// interpolation. Points outside of the grid are evaluated directly.
+///
+/// Complex functions are interpolated by one spline of the real and one of
+/// the imaginary part. Unlike magnitude and phase, these are smooth wherever
+/// the function is, e.g. also around a zero or a phase jump of 2 pi.
+///
+template <typename T> class BasicTabulatedFunction {
+public:
+  /// Evaluates the function for a vector of points.
+  using SourceFunction =
+      std::function<std::vector<T>(const std::vector<double> &)>;
+
+  BasicTabulatedFunction(SourceFunction Function, double Minimum,
+                         double Maximum, std::size_t NumberOfPoints = 1000);
+
+  std::vector<T> evaluate(const double *Points, std::size_t Size) const;
+  std::vector<T> evaluate(const std::vector<double> &Points) const {
+    return evaluate(Points.data(), Points.size());
+  }
+
+  /// Compares the interpolation with the direct evaluation at the centers of
+  /// the grid intervals, where the interpolation error is largest.
+  TabulationAccuracy estimateAccuracy() const;
+
+  double minimum() const { return Minimum; }
+  double maximum() const { return Maximum; }
+  std::size_t numberOfPoints() const { return Values.size(); }
+
+private:
+  SourceFunction Function;
+  double Minimum;
+  double Maximum;
+  double Step;
+  std::vector<T> Values;
+  /// Second derivatives of the spline at the grid points.
+  std::vector<T> SecondDerivatives;
+};
+
+using TabulatedFunction = BasicTabulatedFunction<double>;
+using ComplexTabulatedFunction = BasicTabulatedFunction<std::complex<double>>;
+
+extern template class BasicTabulatedFunction<double>;
+extern template class BasicTabulatedFunction<std::complex<double>>;
+
+/// Function of the data column \p VariableIndex of \p Intensity, with all
+/// other columns at their \p ReferenceValues.
+TabulatedFunction::SourceFunction
+intensitySlice(std::shared_ptr<ComPWA::Intensity> Intensity,
+               std::size_t VariableIndex, std::vector<double> ReferenceValues);
+
+/// Intensity which interpolates \p Table at the data column \p VariableIndex.
+/// It has no parameters.
+std::shared_ptr<VectorizedIntensity>
+createTabulatedIntensity(std::shared_ptr<const TabulatedFunction> Table,
+                         std::size_t VariableIndex);
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
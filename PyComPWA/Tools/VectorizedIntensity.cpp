@@ -0,0 +1,67 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include "PyComPWA/Tools/VectorizedIntensity.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+VectorizedIntensity::VectorizedIntensity(
+    BlockFunction Function, std::vector<ComPWA::Parameter> Parameters,
+    std::size_t BlockSize)
+    : Function(std::move(Function)), Parameters(std::move(Parameters)),
+      BlockSize(BlockSize) {
+  if (!this->Function)
+    throw ComPWA::BadParameter("PyComPWA::Tools::VectorizedIntensity::"
+                               "VectorizedIntensity(): no function given!");
+  if (BlockSize == 0)
+    throw ComPWA::BadParameter("PyComPWA::Tools::VectorizedIntensity::"
+                               "VectorizedIntensity(): block size is zero!");
+}
+
+std::vector<double> VectorizedIntensity::evaluate(
+    const std::vector<std::vector<double>> &Data) noexcept {
+  std::size_t NumberOfEvents = Data.empty() ? 0 : Data.front().size();
+  std::vector<double> Results(NumberOfEvents);
+  std::vector<double> Values;
+  for (auto const &x : Parameters)
+    Values.push_back(x.Value);
+
+  std::vector<const double *> Columns(Data.size());
+  for (std::size_t Begin = 0; Begin < NumberOfEvents; Begin += BlockSize) {
+    std::size_t Size = std::min(BlockSize, NumberOfEvents - Begin);
+    for (std::size_t i = 0; i < Data.size(); ++i)
+      Columns[i] = Data[i].data() + Begin;
+    try {
+      Function(Columns, Size, Values, Results.data() + Begin);
+    } catch (std::exception &e) {
+      LOG(ERROR) << "VectorizedIntensity::evaluate(): " << e.what();
+      std::fill_n(Results.begin() + Begin, Size,
+                  std::numeric_limits<double>::quiet_NaN());
+    }
+  }
+  return Results;
+}
+
+void VectorizedIntensity::updateParametersFrom(
+    const std::vector<double> &Values) {
+  if (Values.size() != Parameters.size())
+    throw ComPWA::BadParameter(
+        "PyComPWA::Tools::VectorizedIntensity::updateParametersFrom(): "
+        "expected " +
+        std::to_string(Parameters.size()) + " parameters but got " +
+        std::to_string(Values.size()) + "!");
+  for (std::size_t i = 0; i < Values.size(); ++i)
+    Parameters[i].Value = Values[i];
+}
+
+} // namespace Tools
+} // namespace PyComPWA
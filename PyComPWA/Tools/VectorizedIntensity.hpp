@@ -0,0 +1,55 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef PYCOMPWA_TOOLS_VECTORIZEDINTENSITY_HPP_
+#define PYCOMPWA_TOOLS_VECTORIZEDINTENSITY_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "Core/Intensity.hpp"
+
+namespace PyComPWA {
+namespace Tools {
+
+///
+/// \class VectorizedIntensity
+/// Intensity which is evaluated by a function working on blocks of events,
+/// e.g. a python function using numpy. The function is called once per block
+/// of at most \p BlockSize events with pointers to the block of each data
+/// column, the parameter values and a pointer to the results of the block.
+/// Hence the overhead of a call is shared by all events of a block.
+///
+/// The function may throw. As ComPWA::Intensity::evaluate() must not throw,
+/// the error is logged and the intensity of the affected block is NaN.
+///
+class VectorizedIntensity : public ComPWA::Intensity {
+public:
+  using BlockFunction = std::function<void(
+      const std::vector<const double *> &Columns, std::size_t NumberOfEvents,
+      const std::vector<double> &Parameters, double *Results)>;
+
+  VectorizedIntensity(BlockFunction Function,
+                      std::vector<ComPWA::Parameter> Parameters,
+                      std::size_t BlockSize = 65536);
+
+  std::vector<double>
+  evaluate(const std::vector<std::vector<double>> &Data) noexcept final;
+
+  void updateParametersFrom(const std::vector<double> &Values) final;
+  std::vector<ComPWA::Parameter> getParameters() const final {
+    return Parameters;
+  }
+
+private:
+  BlockFunction Function;
+  std::vector<ComPWA::Parameter> Parameters;
+  std::size_t BlockSize;
+};
+
+} // namespace Tools
+} // namespace PyComPWA
+
+#endif
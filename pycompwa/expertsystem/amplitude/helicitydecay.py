@@ -550,11 +550,21 @@ class HelicityAmplitudeGeneratorXML(AbstractAmplitudeGenerator):
             len(self.fit_parameter_names)))
         return self.fit_parameter_names
 
+    def get_model_dict(self):
+        """
+        The particle list, kinematics and intensity of the model in the format
+        of xmltodict. It can be passed directly to ``read_particles``,
+        ``create_helicity_kinematics`` and ``create_intensity`` of the ui
+        module, instead of writing the model to a file first.
+        """
+        full_dict = OrderedDict(self.particle_list)
+        full_dict.update(self.kinematics)
+        full_dict.update(self.helicity_amplitudes)
+        return full_dict
+
     def write_to_file(self, filename):
         with open(filename, mode='w') as xmlfile:
-            full_dict = self.particle_list
-            full_dict.update(self.kinematics)
-            full_dict.update(self.helicity_amplitudes)
+            full_dict = self.get_model_dict()
             # xmltodict only allows a single xml root
             xmlstring = xmltodict.unparse(OrderedDict(
                 {'root': full_dict}), pretty=True)
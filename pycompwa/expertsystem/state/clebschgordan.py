@@ -0,0 +1,86 @@
+"""
+Exact Clebsch-Gordan and Wigner 3j coefficients.
+
+The coefficients are evaluated with Racah's formula in rational arithmetic. A
+coefficient is returned as its sign and its square, which is a
+:class:`~fractions.Fraction`. All results are cached, so repeated rule checks
+and amplitude constructions evaluate each coefficient only once. The same
+table is available natively as :func:`pycompwa.ui.clebsch_gordan`.
+"""
+
+from fractions import Fraction
+from functools import lru_cache
+from math import factorial
+
+
+def _twice(value):
+    twice = round(2 * value)
+    if abs(twice - 2 * value) > 1e-6:
+        raise ValueError(str(value) + " is not a multiple of 1/2")
+    return twice
+
+
+@lru_cache(maxsize=None)
+def _clebsch_gordan_twice(tj1, tm1, tj2, tm2, tj, tm):
+    """Sign and square of the coefficient, with all spins times two."""
+    if (tm1 + tm2 != tm or abs(tm1) > tj1 or abs(tm2) > tj2 or abs(tm) > tj
+            or not abs(tj1 - tj2) <= tj <= tj1 + tj2
+            or (tj1 + tm1) % 2 or (tj2 + tm2) % 2 or (tj + tm) % 2
+            or (tj1 + tj2 + tj) % 2):
+        return (0, Fraction(0))
+    j1_plus_j2_minus_j = (tj1 + tj2 - tj) // 2
+    j1_minus_m1 = (tj1 - tm1) // 2
+    j2_plus_m2 = (tj2 + tm2) // 2
+    j_minus_j2_plus_m1 = (tj - tj2 + tm1) // 2
+    j_minus_j1_minus_m2 = (tj - tj1 - tm2) // 2
+
+    total = Fraction(0)
+    k_min = max(0, -j_minus_j2_plus_m1, -j_minus_j1_minus_m2)
+    k_max = min(j1_plus_j2_minus_j, j1_minus_m1, j2_plus_m2)
+    for k in range(k_min, k_max + 1):
+        term = Fraction(1, factorial(k)
+                        * factorial(j1_plus_j2_minus_j - k)
+                        * factorial(j1_minus_m1 - k)
+                        * factorial(j2_plus_m2 - k)
+                        * factorial(j_minus_j2_plus_m1 + k)
+                        * factorial(j_minus_j1_minus_m2 + k))
+        total += -term if k % 2 else term
+    if total == 0:
+        return (0, Fraction(0))
+
+    prefactor = Fraction(
+        (tj + 1) * factorial((tj + tj1 - tj2) // 2)
+        * factorial((tj - tj1 + tj2) // 2)
+        * factorial(j1_plus_j2_minus_j),
+        factorial((tj1 + tj2 + tj) // 2 + 1))
+    prefactor *= (factorial((tj + tm) // 2) * factorial((tj - tm) // 2)
+                  * factorial(j1_minus_m1) * factorial((tj1 + tm1) // 2)
+                  * factorial((tj2 - tm2) // 2) * factorial(j2_plus_m2))
+    return (1 if total > 0 else -1, prefactor * total * total)
+
+
+def clebsch_gordan_squared(j1, m1, j2, m2, j, m):
+    r"""
+    Sign and exact square of :math:`\langle j_1 m_1 j_2 m_2 | j m \rangle`.
+    """
+    return _clebsch_gordan_twice(_twice(j1), _twice(m1), _twice(j2),
+                                 _twice(m2), _twice(j), _twice(m))
+
+
+def clebsch_gordan(j1, m1, j2, m2, j, m):
+    r"""
+    Clebsch-Gordan coefficient :math:`\langle j_1 m_1 j_2 m_2 | j m \rangle`.
+    """
+    sign, square = clebsch_gordan_squared(j1, m1, j2, m2, j, m)
+    return sign * float(square)**0.5
+
+
+def wigner_3j(j1, m1, j2, m2, j3, m3):
+    r"""
+    Wigner 3j symbol :math:`\begin{pmatrix} j_1 & j_2 & j_3 \\ m_1 & m_2 &
+    m_3 \end{pmatrix}`.
+    """
+    sign, square = clebsch_gordan_squared(j1, m1, j2, m2, j3, -m3)
+    if (_twice(j1) - _twice(j2) - _twice(m3)) % 4:
+        sign = -sign
+    return sign * float(square / (_twice(j3) + 1))**0.5
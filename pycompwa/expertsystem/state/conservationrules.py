@@ -14,6 +14,7 @@ from .particle import (
     QuantumNumberClasses,
     is_boson,
     Spin)
+from .clebschgordan import clebsch_gordan_squared
 
 
 ''' Functors for quantum number condition checks '''
@@ -591,6 +592,18 @@ def is_clebsch_gordan_coefficient_zero(spin1, spin2, spin_coupled):
     return iszero
 
 
+def is_exact_clebsch_gordan_coefficient_zero(spin1, spin2, spin_coupled):
+    """
+    Exact version of :func:`is_clebsch_gordan_coefficient_zero`, which also
+    finds the coefficients that vanish outside of the simple selection rules.
+    """
+    sign, _ = clebsch_gordan_squared(
+        spin1.magnitude(), spin1.projection(),
+        spin2.magnitude(), spin2.projection(),
+        spin_coupled.magnitude(), spin_coupled.projection())
+    return sign == 0
+
+
 class ClebschGordanCheckHelicityToCanonical(AbstractRule):
     """
     implements clebsch gordan checks for :math:`S_1, S_2` to :math:`S` and the
@@ -599,7 +612,11 @@ class ClebschGordanCheckHelicityToCanonical(AbstractRule):
     """
 
     def __init__(self):
-        super().__init__('ClebschGordanCheckHelicityToCanonical')
+        super().__init__(type(self).__name__)
+
+    @staticmethod
+    def is_coefficient_zero(spin1, spin2, spin_coupled):
+        return is_clebsch_gordan_coefficient_zero(spin1, spin2, spin_coupled)
 
     def specify_required_qns(self):
         self.add_required_qn(
@@ -623,14 +640,28 @@ class ClebschGordanCheckHelicityToCanonical(AbstractRule):
                     in_spins[0].magnitude() < abs(helicity_diff)):
                 return False
             S = Spin(S.magnitude(), helicity_diff)
-            if is_clebsch_gordan_coefficient_zero(out_spins[0],
-                                                  out_spins[1], S):
+            if self.is_coefficient_zero(out_spins[0], out_spins[1], S):
                 return False
             in_spins[0] = Spin(in_spins[0].magnitude(), helicity_diff)
-            return not is_clebsch_gordan_coefficient_zero(L, S, in_spins[0])
+            return not self.is_coefficient_zero(L, S, in_spins[0])
         return False
 
 
+class ExactClebschGordanCheckHelicityToCanonical(
+        ClebschGordanCheckHelicityToCanonical):
+    """
+    :class:`ClebschGordanCheckHelicityToCanonical` with the exact
+    coefficients, which also removes the couplings whose coefficient vanishes
+    outside of the simple selection rules. This only differs for spins above
+    2. The native implementation is limited to spins up to 10.
+    """
+
+    @staticmethod
+    def is_coefficient_zero(spin1, spin2, spin_coupled):
+        return is_exact_clebsch_gordan_coefficient_zero(spin1, spin2,
+                                                        spin_coupled)
+
+
 class HelicityConservation(AbstractRule):
     def __init__(self):
         super().__init__('HelicityConservation')
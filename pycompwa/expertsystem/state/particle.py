@@ -10,6 +10,7 @@ from numpy import arange
 from itertools import permutations
 from json import loads, dumps
 from collections import OrderedDict
+from bisect import bisect_left, bisect_right
 
 import xmltodict
 
@@ -238,11 +239,24 @@ def is_boson(qn_dict):
 particle_list = []
 
 
-def load_particle_list_from_xml(file_path):
-    with open(file_path, "rb") as xmlfile:
-        full_dict = xmltodict.parse(xmlfile)
-        for p in full_dict['ParticleList']['Particle']:
-            particle_list.append(dict(p))
+def load_particle_list_from_xml(file_path, use_cache_file=False):
+    """
+    Appends the particles of the xml file to the particle list. The compiled
+    particle database of the ui module is used if available, so that the xml
+    file is only parsed again if it changes. With use_cache_file, the
+    database is also written to the cache directory for other processes.
+    """
+    try:
+        from pycompwa import ui
+    except ImportError:
+        logging.debug("ui module not available, parsing the particle list")
+        with open(file_path, "rb") as xmlfile:
+            full_dict = xmltodict.parse(xmlfile)
+            for p in full_dict['ParticleList']['Particle']:
+                particle_list.append(dict(p))
+    else:
+        particle_list.extend(ui.ParticleDatabase.open(
+            file_path, use_cache_file).particles())
 
 
 def get_particle_with_name(particle_name):
@@ -416,6 +430,89 @@ class CompareGraphElementPropertiesFunctor():
         return True
 
 
+def normalize_property_value(value):
+    """
+    Converts numbers to floats, as numbers of different types but equal value
+    are equal for the :class:`.CompareGraphElementPropertiesFunctor`.
+    """
+    if isinstance(value, (bool, int, float)):
+        return float(value)
+    if isinstance(value, dict):
+        return {k: normalize_property_value(v) for k, v in value.items()}
+    if isinstance(value, (list, tuple)):
+        return [normalize_property_value(x) for x in value]
+    return value
+
+
+class GraphFingerprintFunctor():
+    """
+    Computes a fingerprint of a :class:`.StateTransitionGraph`, which is the
+    same for all graphs that are equal according to the
+    :class:`.CompareGraphElementPropertiesFunctor` with the same ignored
+    quantum numbers. Different graphs may share a fingerprint, so graphs
+    with equal fingerprints still have to be compared.
+
+    The fingerprint is computed with the
+    :class:`pycompwa.ui.GraphFingerprinter`, or with a slower python
+    implementation if the ui module is not available.
+    """
+
+    def __init__(self, ignored_qn_list=[]):
+        self.ignored_qn_list = [x.name for x in ignored_qn_list
+                                if isinstance(x,
+                                              (StateQuantumNumberNames,
+                                               InteractionQuantumNumberNames))]
+        try:
+            from pycompwa import ui
+            self.fingerprinter = ui.GraphFingerprinter(self.ignored_qn_list)
+        except ImportError:
+            logging.debug("ui module not available, using python graph "
+                          "fingerprints")
+            self.fingerprinter = self.create_python_fingerprint
+
+    def encode_properties(self, props):
+        qns_label = get_xml_label(XMLLabelConstants.QuantumNumber)
+        type_label = get_xml_label(XMLLabelConstants.Type)
+        encoded_props = []
+        for ele_id, ele_props in props.items():
+            qns = []
+            for qn in ele_props.get(qns_label, []):
+                qns.append((qn[type_label],
+                            [(k, dumps(normalize_property_value(v),
+                                       sort_keys=True))
+                             for k, v in qn.items() if k != type_label]))
+            others = [(k, dumps(normalize_property_value(v), sort_keys=True))
+                      for k, v in ele_props.items() if k != qns_label]
+            encoded_props.append((ele_id, qns, others))
+        return encoded_props
+
+    def create_python_fingerprint(self, nodes, edges, node_props,
+                                  edge_props):
+        def canonical_properties(encoded_props):
+            canonical_props = []
+            for ele_id, qns, others in encoded_props:
+                # as in the comparison, the last qn of each type counts
+                qn_dict = {qn_type: tuple(sorted(attributes))
+                           for qn_type, attributes in qns
+                           if qn_type not in self.ignored_qn_list}
+                canonical_props.append((ele_id, tuple(sorted(qn_dict.items())),
+                                        tuple(sorted(others))))
+            return tuple(sorted(canonical_props))
+        return (tuple(sorted(set(nodes))), tuple(sorted(edges)),
+                canonical_properties(node_props),
+                canonical_properties(edge_props))
+
+    def __call__(self, graph):
+        edges = [(edge_id,
+                  -1 if edge.originating_node_id is None
+                  else edge.originating_node_id,
+                  -1 if edge.ending_node_id is None else edge.ending_node_id)
+                 for edge_id, edge in graph.edges.items()]
+        return self.fingerprinter(list(graph.nodes), edges,
+                                  self.encode_properties(graph.node_props),
+                                  self.encode_properties(graph.edge_props))
+
+
 def initialize_graph(graph, initial_state, final_state, final_state_groupings):
     is_edges = get_initial_state_edges(graph)
     if len(initial_state) != len(is_edges):
@@ -703,6 +800,139 @@ def compare_qns(qn_dict, qn_dict2):
     return val1 == val2
 
 
+def get_comparable_qn_value(qn_name, value):
+    """
+    Value of a state quantum number in the form that is compared by
+    :func:`compare_qns`. Spin-like values without projection are compared by
+    their magnitude only.
+    """
+    qn_class = QNNameClassMapping[qn_name]
+    if qn_class is QuantumNumberClasses.Int:
+        return int(value)
+    if qn_class is QuantumNumberClasses.Float:
+        return float(value)
+    return (value.magnitude(), value.projection())
+
+
+class ParticleIndex():
+    """
+    Index of a particle list for the fast lookup of the particle candidates
+    of a state, see :func:`get_particle_candidates_for_state`. Particles are
+    referred to by their position in the list.
+    """
+
+    def __init__(self, particles):
+        self.particles = tuple(particles)
+        self.all_particles = frozenset(range(len(self.particles)))
+        # sets of particles by quantum number name and comparable value,
+        # plain dicts keep the index picklable for the process pool
+        self.qn_values = {}
+        self.masses = []
+        self.widths = []
+        self.particles_without_mass = set()
+        self.mass_orderings = {}
+
+        qns_label = get_xml_label(XMLLabelConstants.QuantumNumber)
+        type_label = get_xml_label(XMLLabelConstants.Type)
+        value_label = get_xml_label(XMLLabelConstants.Value)
+        proj_label = get_xml_label(XMLLabelConstants.Projection)
+        for index, particle in enumerate(self.particles):
+            found_qns = set()
+            for qn_entry in particle[qns_label]:
+                qn_name = StateQuantumNumberNames[qn_entry[type_label]]
+                # as in check_qns_equal, the first entry of a type counts
+                if qn_name in found_qns:
+                    continue
+                found_qns.add(qn_name)
+                value = qn_entry[value_label]
+                if QNNameClassMapping[qn_name] is QuantumNumberClasses.Spin:
+                    value = (float(value), float(qn_entry[proj_label])
+                             if proj_label in qn_entry else None)
+                else:
+                    value = get_comparable_qn_value(qn_name, value)
+                self.add_qn_value(qn_name, value, index)
+            for qn_name, value in QNDefaultValues.items():
+                if qn_name not in found_qns:
+                    self.add_qn_value(qn_name, get_comparable_qn_value(
+                        qn_name, value), index)
+
+            mass = get_particle_property(particle, ParticlePropertyNames.Mass)
+            width = get_particle_property(particle,
+                                          ParticleDecayPropertyNames.Width)
+            if mass is None:
+                self.particles_without_mass.add(index)
+            self.masses.append(mass)
+            self.widths.append(width if width is not None else 0.0)
+
+    def add_qn_value(self, qn_name, value, index):
+        self.qn_values.setdefault(qn_name, {}).setdefault(
+            value, set()).add(index)
+
+    def get_particles_with_qn_value(self, qn_name, value):
+        return self.qn_values.get(qn_name, {}).get(
+            get_comparable_qn_value(qn_name, value), set())
+
+    def get_allowed_values(self, qn_name, domain, particle_indices):
+        """
+        Values of the domain which match at least one of the particles.
+        Undefined values (None) are always allowed.
+        """
+        values = set(x for x, indices in
+                     self.qn_values.get(qn_name, {}).items()
+                     if not particle_indices.isdisjoint(indices))
+        allowed_values = []
+        for value in domain:
+            if value is not None:
+                comparable_value = get_comparable_qn_value(qn_name, value)
+                if comparable_value not in values and not (
+                        isinstance(comparable_value, tuple) and
+                        (comparable_value[0], None) in values):
+                    continue
+            allowed_values.append(value)
+        return allowed_values
+
+    def get_mass_range(self, particle_indices, width_factor):
+        """
+        Smallest mass minus and largest mass plus width_factor times the
+        width of the particles, or None if a particle has no mass.
+        """
+        if not particle_indices or not particle_indices.isdisjoint(
+                self.particles_without_mass):
+            return None
+        return (min(self.masses[x] - width_factor * self.widths[x]
+                    for x in particle_indices),
+                max(self.masses[x] + width_factor * self.widths[x]
+                    for x in particle_indices))
+
+    def get_particles_above(self, threshold, width_factor):
+        """
+        Particles with a mass plus width_factor times the width above the
+        threshold. Particles without mass are included.
+        """
+        ordering = self.get_mass_ordering(width_factor, 1)
+        return self.particles_without_mass.union(
+            ordering[1][bisect_right(ordering[0], threshold):])
+
+    def get_particles_below(self, threshold, width_factor):
+        """
+        Particles with a mass minus width_factor times the width below the
+        threshold. Particles without mass are included.
+        """
+        ordering = self.get_mass_ordering(width_factor, -1)
+        return self.particles_without_mass.union(
+            ordering[1][:bisect_left(ordering[0], threshold)])
+
+    def get_mass_ordering(self, width_factor, sign):
+        key = (width_factor, sign)
+        if key not in self.mass_orderings:
+            ordered = sorted(
+                (self.masses[x] + sign * width_factor * self.widths[x], x)
+                for x in self.all_particles - self.particles_without_mass)
+            self.mass_orderings[key] = ([x[0] for x in ordered],
+                                        [x[1] for x in ordered])
+        return self.mass_orderings[key]
+
+
 def merge_qn_props(qns_state, qns_particle):
     class_label = get_xml_label(XMLLabelConstants.Class)
     type_label = get_xml_label(XMLLabelConstants.Type)
@@ -23,19 +23,26 @@ from ..topology.graph import (
     get_edges_ingoing_to_node,
     get_edges_outgoing_to_node,
     get_intermediate_state_edges)
-from ..state.conservationrules import AbstractRule
+from ..state.conservationrules import (
+    AbstractRule,
+    AdditiveQuantumNumberConservation,
+    SpinConservation,
+    MassConservation)
 from ..state.particle import (
     get_xml_label, XMLLabelConstants,
     StateQuantumNumberNames,
     InteractionQuantumNumberNames,
     ParticlePropertyNames,
+    ParticleDecayPropertyNames,
     get_particle_property,
     get_interaction_property,
     QNNameClassMapping,
     QNClassConverterMapping,
+    QuantumNumberClasses,
     initialize_graphs_with_particles,
     get_particle_candidates_for_state,
-    initialize_allowed_particle_list)
+    initialize_allowed_particle_list,
+    ParticleIndex)
 
 
 graph_element_types = Enum('GraphElementTypes', 'node edge')
@@ -99,10 +106,25 @@ class AbstractPropagator(ABC):
 
 
 class FullPropagator():
-    def __init__(self, graph, propagation_mode='fast'):
-        self.propagator = CSPPropagator(graph)
+    """
+    With prune_domains, the domains of the intermediate edges are restricted
+    to the quantum numbers of the allowed intermediate particles. This is
+    opt-in: if the pruned problem has no solutions, it is solved a second
+    time without pruning to report the violated rules.
+    """
+
+    def __init__(self, graph, propagation_mode='fast', backend='python',
+                 prune_domains=False):
+        if backend == 'native':
+            self.propagator = NativeCSPPropagator(graph)
+        elif backend == 'python':
+            self.propagator = CSPPropagator(graph)
+        else:
+            raise ValueError("Unknown propagation backend " + str(backend) +
+                             "! Use 'native' or 'python'.")
+        self.propagator.prune_domains = prune_domains
         self.propagation_mode = propagation_mode
-        logging.debug("using CSP propagator")
+        logging.debug("using CSP propagator (" + backend + " backend)")
 
         self.node_non_satisfied_laws = defaultdict(list)
 
@@ -119,15 +141,59 @@ class FullPropagator():
                                                     interaction_settings)
 
     def set_allowed_intermediate_particles(self,
-                                           allowed_intermediate_particles):
+                                           allowed_intermediate_particles,
+                                           particle_index=None):
+        """
+        The :class:`.ParticleIndex` of the allowed intermediate particles can
+        be passed to share it between propagators, otherwise it is created
+        when the domains are pruned.
+        """
         self.propagator.allowed_intermediate_particles = allowed_intermediate_particles
+        self.propagator.particle_index = particle_index
 
     def get_non_satisfied_conservation_laws(self):
         return self.node_non_satisfied_laws
 
     def find_solutions(self):
+        return self.complete_solutions(self.propagator.find_solutions())
+
+    def create_native_problem(self, native_rules=None):
+        """
+        Returns the native problem of the graph, or None if the native solver
+        can not be used. The native rules can be shared with other
+        propagators via the native_rules dict.
+        """
+        if not isinstance(self.propagator, NativeCSPPropagator):
+            return None
+        if native_rules is not None:
+            self.propagator.native_rules = native_rules
+        return self.propagator.create_native_problem()
+
+    def complete_solutions(self, solutions):
+        full_particle_graphs = self.initialize_and_validate_solutions(
+            solutions)
+        if not full_particle_graphs and self.propagator.pruned_domains:
+            # the violated rules depend on the domains
+            logging.debug("no solutions, solving again without pruning")
+            self.node_non_satisfied_laws = defaultdict(list)
+            self.propagator = self.create_unpruned_propagator()
+            full_particle_graphs = self.initialize_and_validate_solutions(
+                self.propagator.find_solutions())
+        return full_particle_graphs
+
+    def create_unpruned_propagator(self):
+        propagator = type(self.propagator)(self.propagator.graph)
+        propagator.node_settings = self.propagator.node_settings
+        propagator.allowed_intermediate_particles = \
+            self.propagator.allowed_intermediate_particles
+        propagator.particle_index = self.propagator.particle_index
+        propagator.prune_domains = False
+        if isinstance(propagator, NativeCSPPropagator):
+            propagator.native_rules = self.propagator.native_rules
+        return propagator
+
+    def initialize_and_validate_solutions(self, solutions):
         run_validation = False
-        solutions = self.propagator.find_solutions()
         logging.debug("Number of solutions after propagator: " +
                       str(len(solutions)))
         if not solutions:
@@ -336,12 +402,24 @@ class CSPPropagator(AbstractPropagator):
         solver = BacktrackingSolver(True)
         self.problem = Problem(solver)
         self.particle_variable_delimiter = "-*-"
+        self.prune_domains = False
+        self.pruned_domains = False
+        self.particle_index = None
+        self.intermediate_candidates = None
         super().__init__(graph)
 
     def find_solutions(self):
         self.initialize_contraints()
         solutions = self.problem.getSolutions()
         solution_graphs = self.apply_solutions_to_graph(solutions)
+        self.evaluate_constraint_statistics()
+        return solution_graphs
+
+    def evaluate_constraint_statistics(self):
+        """
+        Rules which were never checked are postponed to the validation of the
+        solution graphs. Rules which never passed are not satisfied.
+        """
         for constraint in self.constraints:
             if (constraint.conditions_never_met or
                     sum(constraint.scenario_results) == 0):
@@ -351,7 +429,6 @@ class CSPPropagator(AbstractPropagator):
                     constraint.scenario_results[1] == 0):
                 self.node_non_satisfied_laws[constraint.node_id].append(
                     constraint.rule)
-        return solution_graphs
 
     def initialize_contraints(self):
         """
@@ -362,6 +439,8 @@ class CSPPropagator(AbstractPropagator):
         enter or exit the node and play a role for this conservation law.
         Hence variables are also created within this method.
         """
+        if self.prune_domains:
+            self.determine_intermediate_candidates()
         for node_id, interaction_settings in self.node_settings.items():
             new_cons_laws = interaction_settings.conservation_laws
             for cons_law in new_cons_laws:
@@ -407,7 +486,7 @@ class CSPPropagator(AbstractPropagator):
                 constraint.register_graph_node(node_id)
                 self.constraints.append(constraint)
                 if var_list:
-                    self.problem.addConstraint(constraint, var_list)
+                    self.add_constraint(constraint, var_list)
                 else:
                     self.constraints[-1].conditions_never_met = True
 
@@ -475,11 +554,161 @@ class CSPPropagator(AbstractPropagator):
                                             edge_id,
                                             qn_name
                                             )
+                    qn_domain = self.prune_domain(edge_id, qn_name, qn_domain)
                     if qn_domain:
                         key = self.add_variable(var_info, qn_domain)
                         variables[0].add(key)
         return variables
 
+    def determine_intermediate_candidates(self):
+        """
+        Determines the particles which are still possible for each
+        intermediate edge before the search. The allowed intermediate
+        particles are reduced with the values of additive quantum numbers,
+        which are fixed by the edges around a node, and with the mass
+        thresholds of the :class:`.MassConservation` rules. The domains of the
+        intermediate edges are then pruned to the values of these particles.
+
+        Only values are removed for which there is no particle candidate, or
+        which violate a conservation rule, so the solutions with particle
+        candidates are the same as without pruning.
+        """
+        if self.particle_index is None:
+            self.particle_index = ParticleIndex(
+                initialize_allowed_particle_list(
+                    self.allowed_intermediate_particles))
+        candidates = {edge_id: self.particle_index.all_particles
+                      for edge_id in get_intermediate_state_edges(self.graph)}
+        additive_values = {}
+        changed = True
+        while changed:
+            changed = False
+            for node_id, interaction_settings in self.node_settings.items():
+                for rule in interaction_settings.conservation_laws:
+                    if isinstance(rule, AdditiveQuantumNumberConservation):
+                        edge_value = self.determine_additive_qn_value(
+                            node_id, rule.qn_name, additive_values)
+                        if edge_value is None:
+                            continue
+                        edge_id, value = edge_value
+                        additive_values[(edge_id, rule.qn_name)] = value
+                        candidates[edge_id] = candidates[edge_id].intersection(
+                            self.particle_index.get_particles_with_qn_value(
+                                rule.qn_name, value))
+                        changed = True
+                    elif (isinstance(rule, MassConservation) and
+                            ParticlePropertyNames.Mass not in
+                            interaction_settings.qn_domains):
+                        changed |= self.apply_mass_threshold(
+                            node_id, rule.width_factor, candidates)
+            if not all(candidates.values()):
+                # there are no solutions anyway, the search has to find out
+                # which rules are violated
+                return
+        self.intermediate_candidates = candidates
+
+    def determine_additive_qn_value(self, node_id, qn_name, additive_values):
+        """
+        Returns the intermediate edge and its value of the additive quantum
+        number, if the values of all other edges of the node are known and
+        the value of the edge is always defined in the search.
+        """
+        in_edges = get_edges_ingoing_to_node(self.graph, node_id)
+        out_edges = get_edges_outgoing_to_node(self.graph, node_id)
+        unknown_edges = []
+        qn_sum = 0
+        for edge_id in in_edges + out_edges:
+            sign = 1 if edge_id in in_edges else -1
+            if edge_id in self.graph.edge_props:
+                value = get_particle_property(
+                    self.graph.edge_props[edge_id], qn_name)
+                if value is None:
+                    return None
+                qn_sum += sign * value
+            elif (edge_id, qn_name) in additive_values:
+                qn_sum += sign * additive_values[(edge_id, qn_name)]
+            else:
+                unknown_edges.append((edge_id, sign))
+        if len(unknown_edges) != 1:
+            return None
+        edge_id, sign = unknown_edges[0]
+        # undefined values switch off the rule
+        edge = self.graph.edges[edge_id]
+        for other_node_id in [edge.originating_node_id, edge.ending_node_id]:
+            if other_node_id not in self.node_settings:
+                return None
+            domain = self.node_settings[other_node_id].qn_domains.get(
+                qn_name, [])
+            if None in domain or (other_node_id == node_id and not domain):
+                return None
+        return (edge_id, -sign * qn_sum)
+
+    def apply_mass_threshold(self, node_id, width_factor, candidates):
+        """
+        Removes the candidates of the intermediate edges of the node, which
+        violate the mass conservation even for the most favourable masses of
+        the other edges. Returns True if candidates were removed.
+        """
+        in_edges = get_edges_ingoing_to_node(self.graph, node_id)
+        out_edges = get_edges_outgoing_to_node(self.graph, node_id)
+        mass_ranges = {}
+        for edge_id in in_edges + out_edges:
+            if edge_id in self.graph.edge_props:
+                mass = get_particle_property(
+                    self.graph.edge_props[edge_id],
+                    ParticlePropertyNames.Mass)
+                if mass is None:
+                    return False
+                width = get_particle_property(
+                    self.graph.edge_props[edge_id],
+                    ParticleDecayPropertyNames.Width)
+                width = width_factor * width if width is not None else 0.0
+                mass_ranges[edge_id] = (mass - width, mass + width)
+            else:
+                mass_ranges[edge_id] = self.particle_index.get_mass_range(
+                    candidates[edge_id], width_factor)
+
+        changed = False
+        for edge_id in [x for x in in_edges + out_edges if x in candidates]:
+            other_ranges = [mass_ranges[x] for x in in_edges + out_edges
+                            if x != edge_id]
+            if None in other_ranges:
+                continue
+            max_mass_in = sum(mass_ranges[x][1] for x in in_edges
+                              if x != edge_id)
+            min_mass_out = sum(mass_ranges[x][0] for x in out_edges
+                               if x != edge_id)
+            if edge_id in in_edges:
+                allowed = self.particle_index.get_particles_above(
+                    min_mass_out - max_mass_in, width_factor)
+            else:
+                allowed = self.particle_index.get_particles_below(
+                    max_mass_in - min_mass_out, width_factor)
+            if not candidates[edge_id].issubset(allowed):
+                candidates[edge_id] = candidates[edge_id].intersection(
+                    allowed)
+                mass_ranges[edge_id] = self.particle_index.get_mass_range(
+                    candidates[edge_id], width_factor)
+                changed = True
+        return changed
+
+    def prune_domain(self, edge_id, qn_name, domain):
+        """
+        Reduces the domain of a quantum number of an intermediate edge to the
+        values of its particle candidates. Domains are never emptied, as
+        this would switch off the rules instead.
+        """
+        if (self.intermediate_candidates is None or
+                edge_id not in self.intermediate_candidates or
+                not isinstance(qn_name, StateQuantumNumberNames)):
+            return domain
+        pruned_domain = self.particle_index.get_allowed_values(
+            qn_name, domain, self.intermediate_candidates[edge_id])
+        if not pruned_domain or len(pruned_domain) == len(domain):
+            return domain
+        self.pruned_domains = True
+        return pruned_domain
+
     def add_variable(self, var_info, domain):
         key = encode_variable_name(var_info,
                                    self.particle_variable_delimiter)
@@ -488,6 +717,9 @@ class CSPPropagator(AbstractPropagator):
             self.problem.addVariable(key, domain)
         return key
 
+    def add_constraint(self, constraint, variables):
+        self.problem.addConstraint(constraint, variables)
+
     def apply_solutions_to_graph(self, solutions):
         """
         Apply the CSP solutions to the graph instance.
@@ -707,3 +939,196 @@ class ConservationLawConstraintWrapper(Constraint):
                 raise ValueError("The variable with name " +
                                  var_name +
                                  "does not appear in the variable mapping!")
+
+
+def encode_qn_value(qn_name, value):
+    """
+    Encodes a quantum number value for the native solver as the tuple
+    (defined, value, projection, real). Spin-like values are multiplied by
+    two, floating point values are stored in the last entry.
+    """
+    if value is None:
+        return (False, 0, 0, 0.0)
+    qn_class = QNNameClassMapping[qn_name]
+    if qn_class is QuantumNumberClasses.Spin:
+        return (True, int(round(2 * value.magnitude())),
+                int(round(2 * value.projection())), 0.0)
+    if qn_class is QuantumNumberClasses.Float:
+        return (True, 0, 0, float(value))
+    return (True, int(round(value)), 0, 0.0)
+
+
+def get_native_rule_settings(rule):
+    """
+    Arguments of the native implementation of a conservation rule, see
+    :class:`pycompwa.ui.ConservationRule`.
+    """
+    settings = {'type': type(rule).__name__}
+    if isinstance(rule, AdditiveQuantumNumberConservation):
+        settings['quantum_number'] = rule.qn_name.name
+    elif isinstance(rule, SpinConservation):
+        settings['quantum_number'] = rule.spinlike_qn.name
+        settings['use_projection'] = rule.use_projection
+    elif isinstance(rule, MassConservation):
+        settings['width_factor'] = rule.width_factor
+    return settings
+
+
+class NativeCSPPropagator(CSPPropagator):
+    """
+    Quantum number propagator which solves the same constraint satisfaction
+    problem as the :class:`.CSPPropagator` with the native solver of the ui
+    module (:class:`pycompwa.ui.QuantumNumberProblem`). It falls back to the
+    python solver if the ui module is not available, or if one of the rules
+    has no native implementation.
+
+    In contrast to the python wrapper, a rule is not switched off as soon as
+    its requirements are not met for one assignment. It is still checked for
+    all other assignments. Such rules are postponed in both cases, so the
+    validated solutions are the same.
+
+    Which rules are reported as violated depends on the search of the
+    solver. The native solver checks the value combinations of each rule
+    once before its search, in a fixed order, and reports the rules which
+    never passed. The python solver reports the rules which never passed in
+    its own search, so the two backends can report different violated rules
+    for graphs without solutions.
+    """
+
+    def __init__(self, graph):
+        super().__init__(graph)
+        self.native_problem = None
+        self.native_variables = []
+        self.native_variable_indices = {}
+        self.native_constraints = []
+        self.native_rules = {}
+
+    def find_solutions(self):
+        native_problem = self.create_native_problem()
+        if native_problem is None:
+            return super().find_solutions()
+        return self.apply_native_solutions(native_problem.solve())
+
+    def create_native_problem(self):
+        """
+        Returns the native problem of the graph, or None if the python solver
+        has to be used.
+        """
+        ui = self.get_native_module()
+        if ui is None:
+            return None
+        self.native_problem = ui.QuantumNumberProblem()
+        self.initialize_contraints()
+        return self.native_problem
+
+    def apply_native_solutions(self, native_solutions):
+        """
+        Converts the solutions of the native problem, given as indices of the
+        values in the variable domains, to solution graphs.
+        """
+        solutions = []
+        for indices in native_solutions:
+            solutions.append({key: domain[index] for (key, domain), index
+                              in zip(self.native_variables, indices)})
+        for constraint, statistics in zip(self.native_constraints,
+                                          self.native_problem.statistics()):
+            constraint.scenario_results = [statistics[0], statistics[1]]
+            constraint.conditions_never_met = statistics[2]
+        solution_graphs = self.apply_solutions_to_graph(solutions)
+        self.evaluate_constraint_statistics()
+        return solution_graphs
+
+    def get_native_module(self):
+        try:
+            from pycompwa import ui
+        except ImportError:
+            logging.debug("ui module not available, using the python solver")
+            return None
+        supported_rules = ui.supported_conservation_rules()
+        for interaction_settings in self.node_settings.values():
+            for rule in interaction_settings.conservation_laws:
+                if type(rule).__name__ not in supported_rules:
+                    logging.debug("no native implementation of " +
+                                  type(rule).__name__ +
+                                  ", using the python solver")
+                    return None
+        return ui
+
+    def add_variable(self, var_info, domain):
+        if self.native_problem is None:
+            return super().add_variable(var_info, domain)
+        key = encode_variable_name(var_info,
+                                   self.particle_variable_delimiter)
+        if key not in self.native_variable_indices:
+            self.native_variable_indices[key] = \
+                self.native_problem.add_variable(
+                    [encode_qn_value(var_info.qn_name, x) for x in domain])
+            self.native_variables.append((key, list(domain)))
+        return key
+
+    def add_constraint(self, constraint, variables):
+        if self.native_problem is None:
+            return super().add_constraint(constraint, variables)
+        # equal rules share their native implementation
+        rule_settings = get_native_rule_settings(constraint.rule)
+        rule_key = tuple(sorted(rule_settings.items()))
+        if rule_key not in self.native_rules:
+            from pycompwa import ui
+            self.native_rules[rule_key] = ui.ConservationRule(**rule_settings)
+
+        # the edges keep the order of the particle lists of the wrapper
+        def encode_fixed_values(qn_dict):
+            return [(qn_name.name, encode_qn_value(qn_name, value))
+                    for qn_name, value in qn_dict.items()]
+        ingoing = [(encode_fixed_values(x), []) for x in constraint.part_in]
+        outgoing = [(encode_fixed_values(x), [])
+                    for x in constraint.part_out]
+        interaction = (
+            [(qn_name.name, encode_qn_value(qn_name, value))
+             for qn_name, value in
+             constraint.fixed_interaction_variable_set], [])
+        for var_name, (index, qn_name) in \
+                constraint.variable_name_decoding_map.items():
+            variable = (qn_name.name, self.native_variable_indices[var_name])
+            if var_name in constraint.in_variable_set:
+                ingoing[index][1].append(variable)
+            elif var_name in constraint.out_variable_set:
+                outgoing[index][1].append(variable)
+            else:
+                interaction[1].append(variable)
+
+        self.native_problem.add_constraint(
+            self.native_rules[rule_key], ingoing, outgoing, interaction)
+        self.native_constraints.append(constraint)
+
+
+def find_solutions_in_bulk(propagators, number_of_threads=0):
+    """
+    Finds the solutions of several :class:`.FullPropagator` instances. The
+    native problems of all propagators are solved at once on a native thread
+    pool, which shares the conservation rules. Propagators which can not use
+    the native solver are run one after the other.
+
+    Returns:
+      list of the solution graphs of each propagator
+    """
+    native_rules = {}
+    native_problems = []
+    native_propagators = []
+    results = [None] * len(propagators)
+    for index, propagator in enumerate(propagators):
+        native_problem = propagator.create_native_problem(native_rules)
+        if native_problem is None:
+            results[index] = propagator.find_solutions()
+        else:
+            native_problems.append(native_problem)
+            native_propagators.append((index, propagator))
+    if native_problems:
+        from pycompwa import ui
+        native_solutions = ui.solve_quantum_number_problems(
+            native_problems, number_of_threads)
+        for (index, propagator), solutions in zip(native_propagators,
+                                                  native_solutions):
+            results[index] = propagator.complete_solutions(
+                propagator.propagator.apply_native_solutions(solutions))
+    return results
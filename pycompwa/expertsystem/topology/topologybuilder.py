@@ -10,8 +10,11 @@ import copy
 import itertools
 import logging
 
-from .graph import (
-    StateTransitionGraph, InteractionNode, are_graphs_isomorphic)
+from .graph import StateTransitionGraph, InteractionNode
+
+# native topology generators of the ui module by their interaction node types,
+# these memoize the topologies
+native_topology_generators = {}
 
 
 class SimpleStateTransitionTopologyBuilder():
@@ -19,6 +22,11 @@ class SimpleStateTransitionTopologyBuilder():
     Simple topology builder. Recursively trys to add the interaction nodes
     to available open end edges/lines in all combinations until the number of
     open end lines matches the final state lines
+
+    The topologies are generated with the
+    :class:`pycompwa.ui.TopologyGenerator`, which removes isomorphic graphs.
+    The python implementation is only used if the ui module is not available.
+    It removes isomorphic graphs with the same canonical form.
     """
 
     def __init__(self, interaction_node_set):
@@ -42,6 +50,12 @@ class SimpleStateTransitionTopologyBuilder():
             raise ValueError("number_of_final_edges has to be larger than 0")
 
         logging.info('building topology graphs...')
+        native_graphs = self.build_native_graphs(number_of_intial_edges,
+                                                 number_of_final_edges)
+        if native_graphs is not None:
+            logging.info('finished building topology graphs...')
+            return native_graphs
+
         # result list
         graph_tuple_list = []
         # create seed graph
@@ -63,14 +77,16 @@ class SimpleStateTransitionTopologyBuilder():
 
                 extendable_graph_list.extend(self.extend_graph(active_graph))
 
-            # check if two topologies are the same
-            for graph_index1, graph_index2 in itertools.combinations(
-                    range(len(extendable_graph_list)), 2):
-                if are_graphs_isomorphic(
-                        extendable_graph_list[graph_index1][0],
-                        extendable_graph_list[graph_index2][0]):
-                    extendable_graph_list.remove(
-                        extendable_graph_list[graph_index2])
+            # remove isomorphic topologies by their canonical form, the same
+            # fingerprint as in pycompwa.ui.TopologyGenerator
+            canonical_forms = set()
+            unique_graph_list = []
+            for extended_graph in extendable_graph_list:
+                form = canonical_form(extended_graph[0])
+                if form not in canonical_forms:
+                    canonical_forms.add(form)
+                    unique_graph_list.append(extended_graph)
+            extendable_graph_list = unique_graph_list
 
         logging.info('finished building topology graphs...')
         # strip the current open end edges list from the result graph tuples
@@ -79,6 +95,38 @@ class SimpleStateTransitionTopologyBuilder():
             result_graph_list.append(graph_tuple[0])
         return result_graph_list
 
+    def build_native_graphs(self, number_of_intial_edges,
+                            number_of_final_edges):
+        node_types = tuple((x.number_of_ingoing_edges,
+                            x.number_of_outgoing_edges)
+                           for x in self.interaction_node_set)
+        if node_types not in native_topology_generators:
+            try:
+                from pycompwa import ui
+            except ImportError:
+                logging.debug("ui module not available, building topologies"
+                              " in python")
+                return None
+            native_topology_generators[node_types] = ui.TopologyGenerator(
+                list(node_types))
+        topologies = native_topology_generators[node_types].generate(
+            number_of_intial_edges, number_of_final_edges)
+
+        graphs = []
+        for number_of_nodes, edges in topologies:
+            graph = StateTransitionGraph()
+            graph.add_edges(list(range(len(edges))))
+            for node_id in range(number_of_nodes):
+                graph.add_node(node_id)
+                graph.attach_edges_to_node_ingoing(
+                    [i for i, x in enumerate(edges) if x[1] == node_id],
+                    node_id)
+                graph.attach_edges_to_node_outgoing(
+                    [i for i, x in enumerate(edges) if x[0] == node_id],
+                    node_id)
+            graphs.append(graph)
+        return graphs
+
     def extend_graph(self, graph):
         extended_graph_list = []
 
@@ -132,3 +180,63 @@ def attach_node_to_edges(graph, interaction_node, ingoing_edge_ids):
         new_open_end_lines.append(edge_id)
 
     return (temp_graph, new_open_end_lines)
+
+
+def _refine_node_colors(nodes, edges, colors):
+    """Color refinement of the nodes: nodes keep the same color only if they
+    have the same number of edges to and from each color. The colors are
+    ranks, hence they only depend on the structure of the graph."""
+    number_of_colors = len(set(colors.values()))
+    while True:
+        signatures = {node: [] for node in nodes}
+        for edge in edges:
+            # edges to the initial or final state are marked by zero
+            if edge.ending_node_id is not None:
+                signatures[edge.ending_node_id].append(
+                    2 * (colors[edge.originating_node_id] + 1
+                         if edge.originating_node_id is not None else 0))
+            if edge.originating_node_id is not None:
+                signatures[edge.originating_node_id].append(
+                    2 * (colors[edge.ending_node_id] + 1
+                         if edge.ending_node_id is not None else 0) + 1)
+        signatures = {node: (colors[node],) + tuple(sorted(x))
+                      for node, x in signatures.items()}
+        ranks = sorted(set(signatures.values()))
+        colors = {node: ranks.index(x) for node, x in signatures.items()}
+        # the signatures start with the old color, so the partition can only
+        # become finer
+        if len(ranks) == number_of_colors:
+            return colors
+        number_of_colors = len(ranks)
+
+
+def _search_canonical_form(nodes, edges, colors):
+    colors = _refine_node_colors(nodes, edges, colors)
+    counts = [list(colors.values()).count(x) for x in range(len(nodes))]
+    cell_color = next((x for x, count in enumerate(counts) if count > 1),
+                      None)
+    if cell_color is None:
+        return tuple(sorted(
+            (colors[x.originating_node_id]
+             if x.originating_node_id is not None else -1,
+             colors[x.ending_node_id]
+             if x.ending_node_id is not None else -1) for x in edges))
+    forms = []
+    for node in nodes:
+        if colors[node] != cell_color:
+            continue
+        individualized = {
+            other: 2 * color + (color == cell_color and other != node)
+            for other, color in colors.items()}
+        forms.append(_search_canonical_form(nodes, edges, individualized))
+    return min(forms)
+
+
+def canonical_form(graph):
+    """Canonical form of the topology of a graph, which is equal for two
+    graphs only if they are isomorphic. The edges are given as sorted pairs
+    of the canonical originating and ending node labels, where -1 marks the
+    initial and final state. This is the same form as in
+    :class:`pycompwa.ui.TopologyGenerator`."""
+    return _search_canonical_form(graph.nodes, list(graph.edges.values()),
+                                  {node: 0 for node in graph.nodes})
@@ -1,3 +1,4 @@
-__all__ = ['default_settings', 'system_control']
+__all__ = ['default_settings', 'solution_cache', 'system_control']
 from . import default_settings
+from . import solution_cache
 from . import system_control
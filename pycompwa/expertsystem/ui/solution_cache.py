@@ -0,0 +1,185 @@
+"""
+On-disk cache of the solutions of the :class:`.StateTransitionManager`.
+
+The solutions only depend on the prepared graphs and their interaction
+settings, the allowed intermediate particles, the particle database and the
+implementation of the expert system. A sha256 hash of these inputs is used as
+the key of the cached solutions, so a change of any of them results in a new
+run.
+"""
+
+import hashlib
+import json
+import logging
+import os
+import tempfile
+from enum import Enum
+from functools import lru_cache
+from importlib import import_module
+from types import FunctionType, BuiltinFunctionType
+
+from ..topology.graph import StateTransitionGraph, Edge
+from ..state.particle import CompareGraphElementPropertiesFunctor
+
+
+# increase if the format of the cached solutions changes
+solution_cache_format_version = 2
+
+
+def encode_for_hashing(obj):
+    """
+    Converts an object into a json serializable structure, which does not
+    depend on the order of dictionaries and sets or the memory layout. Objects
+    like the conservation rules and graphs are encoded by their class name and
+    attributes.
+    """
+    if obj is None or isinstance(obj, (bool, int, str)):
+        return obj
+    if isinstance(obj, float):
+        return repr(obj)
+    if isinstance(obj, Enum):
+        return type(obj).__name__ + '.' + obj.name
+    if isinstance(obj, dict):
+        return ['dict'] + sorted(
+            ([encode_for_hashing(k), encode_for_hashing(v)]
+             for k, v in obj.items()),
+            key=lambda x: repr(x[0]))
+    if isinstance(obj, (list, tuple)):
+        return [encode_for_hashing(x) for x in obj]
+    if isinstance(obj, (set, frozenset)):
+        return ['set'] + sorted((encode_for_hashing(x) for x in obj),
+                                key=repr)
+    if isinstance(obj, (type, FunctionType, BuiltinFunctionType)):
+        return obj.__module__ + '.' + obj.__qualname__
+    type_name = type(obj).__module__ + '.' + type(obj).__qualname__
+    if hasattr(obj, '__dict__'):
+        return [type_name, encode_for_hashing(vars(obj))]
+    # the default representation contains the memory address
+    if type(obj).__repr__ is object.__repr__:
+        raise TypeError("cannot encode an object of type " + type_name +
+                        " for hashing")
+    return [type_name, repr(obj)]
+
+
+def create_hash(obj):
+    encoded = json.dumps(encode_for_hashing(obj), separators=(',', ':'))
+    return hashlib.sha256(encoded.encode('utf-8')).hexdigest()
+
+
+@lru_cache(maxsize=None)
+def create_implementation_hash(include_native_module=False):
+    """
+    Hash of the source files of the expert system, and optionally of the
+    native module with the quantum number solver. A changed conservation rule
+    or propagator therefore invalidates the cached solutions.
+    """
+    sha = hashlib.sha256()
+    package_directory = os.path.dirname(os.path.dirname(__file__))
+    file_paths = []
+    for directory, subdirectories, file_names in os.walk(package_directory):
+        subdirectories.sort()
+        file_paths.extend(os.path.join(directory, x)
+                          for x in sorted(file_names) if x.endswith('.py'))
+    if include_native_module:
+        file_paths.append(import_module('pycompwa.ui').__file__)
+    for file_path in file_paths:
+        sha.update(os.path.relpath(file_path, package_directory).encode())
+        with open(file_path, 'rb') as source_file:
+            sha.update(source_file.read())
+    return sha.hexdigest()
+
+
+def encode_graph(graph):
+    """
+    Converts a solution graph into a json serializable structure. The
+    properties of the graph elements are plain dictionaries after the
+    propagation.
+    """
+    comparator = graph.graph_element_properties_comparator
+    if comparator is not None:
+        if type(comparator) is not CompareGraphElementPropertiesFunctor:
+            raise TypeError("cannot encode a graph with a comparator of type "
+                            + type(comparator).__qualname__)
+        comparator = comparator.ignored_qn_list
+    return {
+        'nodes': graph.nodes,
+        'edges': [[x, y.ending_node_id, y.originating_node_id]
+                  for x, y in graph.edges.items()],
+        'node_props': [[x, y] for x, y in graph.node_props.items()],
+        'edge_props': [[x, y] for x, y in graph.edge_props.items()],
+        'ignored_qn_list': comparator,
+    }
+
+
+def decode_graph(encoded_graph):
+    graph = StateTransitionGraph()
+    graph.nodes = encoded_graph['nodes']
+    for edge_id, ending_node_id, originating_node_id in (
+            encoded_graph['edges']):
+        graph.edges[edge_id] = Edge()
+        graph.edges[edge_id].ending_node_id = ending_node_id
+        graph.edges[edge_id].originating_node_id = originating_node_id
+    graph.node_props = dict(encoded_graph['node_props'])
+    graph.edge_props = dict(encoded_graph['edge_props'])
+    if encoded_graph['ignored_qn_list'] is not None:
+        comparator = CompareGraphElementPropertiesFunctor()
+        comparator.ignored_qn_list = encoded_graph['ignored_qn_list']
+        graph.set_graph_element_properties_comparator(comparator)
+    return graph
+
+
+class SolutionCache():
+    """
+    Stores the results of :meth:`.StateTransitionManager.find_solutions` as
+    json files in a directory, one file per key. Files are written
+    atomically, so several jobs can share the same cache directory. Unlike
+    pickle files, reading a file from a shared directory cannot execute code.
+    """
+
+    def __init__(self, directory):
+        self.directory = directory
+
+    def get_file_path(self, key):
+        return os.path.join(self.directory, key + '.json')
+
+    def load(self, key):
+        """
+        Returns the cached result or None, if there is no valid entry.
+        """
+        file_path = self.get_file_path(key)
+        if not os.path.exists(file_path):
+            return None
+        try:
+            with open(file_path, 'r') as cache_file:
+                content = json.load(cache_file)
+            if content['format_version'] != solution_cache_format_version:
+                return None
+            result = ([decode_graph(x) for x in content['solutions']],
+                      content['violated_rules'])
+        except Exception as error:
+            logging.warning("could not read solution cache file " +
+                            file_path + ": " + str(error))
+            return None
+        logging.info("loaded solutions from cache file " + file_path)
+        return result
+
+    def store(self, key, result):
+        """
+        Stores the solution graphs and the names of the violated rules.
+        """
+        (solutions, violated_rules) = result
+        content = {'format_version': solution_cache_format_version,
+                   'solutions': [encode_graph(x) for x in solutions],
+                   'violated_rules': [str(x) for x in violated_rules]}
+        os.makedirs(self.directory, exist_ok=True)
+        file_descriptor, temp_path = tempfile.mkstemp(
+            dir=self.directory, suffix='.tmp')
+        try:
+            with os.fdopen(file_descriptor, 'w') as cache_file:
+                json.dump(content, cache_file)
+            os.replace(temp_path, self.get_file_path(key))
+        except Exception:
+            os.remove(temp_path)
+            raise
+        logging.info("stored solutions in cache file " +
+                     self.get_file_path(key))
@@ -24,15 +24,19 @@ from ..state.particle import (
     get_particle_property, get_interaction_property,
     XMLLabelConstants, get_xml_label,
     StateQuantumNumberNames, InteractionQuantumNumberNames,
-    ParticlePropertyNames, CompareGraphElementPropertiesFunctor)
+    ParticlePropertyNames, CompareGraphElementPropertiesFunctor,
+    GraphFingerprintFunctor, ParticleIndex, initialize_allowed_particle_list)
 
 from ..state.propagation import (
-    FullPropagator, InteractionTypes, InteractionNodeSettings)
+    FullPropagator, InteractionTypes, InteractionNodeSettings,
+    find_solutions_in_bulk)
 
 from .default_settings import (
     create_default_interaction_settings,
     default_particle_list_search_paths
 )
+from .solution_cache import (
+    SolutionCache, create_hash, create_implementation_hash)
 
 
 def change_qn_domain(interaction_settings, qn_name, new_domain):
@@ -120,17 +124,22 @@ def remove_duplicate_solutions(results, remove_qns_list=[],
     logging.info("removing these qns from graphs: " + str(remove_qns_list))
     logging.info("ignoring qns in graph comparison: " + str(ingore_qns_list))
     filtered_results = {}
-    solutions = []
+    # kept solutions by their fingerprint, only graphs with the same
+    # fingerprint can be equal
+    solutions = {}
+    create_fingerprint = GraphFingerprintFunctor(ingore_qns_list)
     remove_counter = 0
     for strength, group_results in results.items():
         for (sol_graphs, rule_violations) in group_results:
             temp_graphs = []
             for sol_graph in sol_graphs:
                 sol_graph = remove_qns_from_graph(sol_graph, remove_qns_list)
-                found_graph = check_equal_ignoring_qns(sol_graph, solutions,
-                                                       ingore_qns_list)
+                fingerprint = create_fingerprint(sol_graph)
+                found_graph = check_equal_ignoring_qns(
+                    sol_graph, solutions.get(fingerprint, []),
+                    ingore_qns_list)
                 if found_graph is None:
-                    solutions.append(sol_graph)
+                    solutions.setdefault(fingerprint, []).append(sol_graph)
                     temp_graphs.append(sol_graph)
                 else:
                     # check if found solution also has the prefactors
@@ -455,9 +464,12 @@ class StateTransitionManager():
                  formalism_type='helicity',
                  topology_building='isobar',
                  number_of_threads=4,
-                 propagation_mode='fast'):
+                 propagation_mode='fast',
+                 propagation_backend='python',
+                 solution_cache_directory=None):
         self.number_of_threads = number_of_threads
         self.propagation_mode = propagation_mode
+        self.propagation_backend = propagation_backend
         self.initial_state = initial_state
         self.final_state = final_state
         self.interaction_type_settings = interaction_type_settings
@@ -466,6 +478,9 @@ class StateTransitionManager():
                 create_default_interaction_settings(formalism_type)
         self.interaction_determinators = [LeptonCheck(), GammaCheck()]
         self.allowed_intermediate_particles = allowed_intermediate_particles
+        # index of the allowed intermediate particles, which is shared by the
+        # propagators of a find_solutions()
+        self.particle_index = None
         self.final_state_groupings = []
         self.allowed_interaction_types = [InteractionTypes.Strong,
                                           InteractionTypes.EM,
@@ -496,6 +511,9 @@ class StateTransitionManager():
                         False)
         self.topology_builder = SimpleStateTransitionTopologyBuilder(
             int_nodes)
+        self.solution_cache = None
+        if solution_cache_directory:
+            self.solution_cache = SolutionCache(solution_cache_directory)
 
         # load default particles from database/file
         if len(particle_list) == 0:
@@ -612,7 +630,37 @@ class StateTransitionManager():
                 graph_settings_groups[strength].append((graph, setting))
         return graph_settings_groups
 
+    def create_solution_cache_key(self, graph_setting_groups):
+        """
+        The seed graphs of the groups contain the initial and final state and
+        the node settings contain the rules, so together with the particles
+        they determine the solutions. The backend can change the reported
+        violated rules, the number of threads does not change the result.
+        The hash of the implementation covers changes of the rules.
+        """
+        return create_hash([
+            self.initial_state, self.final_state,
+            self.allowed_intermediate_particles, graph_setting_groups,
+            self.filter_remove_qns, self.filter_ignore_qns,
+            self.propagation_mode, self.propagation_backend, particle_list,
+            create_implementation_hash(self.propagation_backend == 'native')])
+
     def find_solutions(self, graph_setting_groups):
+        cache_key = None
+        if self.solution_cache is not None:
+            try:
+                cache_key = self.create_solution_cache_key(
+                    graph_setting_groups)
+            except TypeError as error:
+                logging.warning("solutions are not cached: " + str(error))
+        if cache_key is not None:
+            cached_result = self.solution_cache.load(cache_key)
+            if cached_result is not None:
+                return cached_result
+
+        # the particles may have changed since the last call
+        self.particle_index = ParticleIndex(initialize_allowed_particle_list(
+            self.allowed_intermediate_particles))
         results = {}
         # check for solutions for a specific set of interaction settings
         logging.info("Number of interaction settings groups being processed: "
@@ -630,7 +678,13 @@ class StateTransitionManager():
             bar = IncrementalBar('Propagating quantum numbers...',
                                  max=len(graph_setting_group))
             bar.update()
-            if self.number_of_threads > 1:
+            if self.propagation_backend == 'native':
+                # the threads of the native solver share the process, so
+                # nothing has to be pickled
+                temp_results = self.propagate_quantum_numbers_in_bulk(
+                    graph_setting_group)
+                bar.next(len(graph_setting_group))
+            elif self.number_of_threads > 1:
                 with Pool(self.number_of_threads) as p:
                     for result in p.imap_unordered(
                             self.propagate_quantum_numbers,
@@ -681,6 +735,12 @@ class StateTransitionManager():
                 perform_external_edge_identical_particle_combinatorics(sol)
             )
 
+        if cache_key is not None:
+            try:
+                self.solution_cache.store(cache_key,
+                                          (final_solutions, violated_laws))
+            except TypeError as error:
+                logging.warning("solutions are not cached: " + str(error))
         return (final_solutions, violated_laws)
 
     def propagate_quantum_numbers(self, state_graph_node_settings_pair):
@@ -690,8 +750,17 @@ class StateTransitionManager():
         solutions = propagator.find_solutions()
         return (solutions, propagator.get_non_satisfied_conservation_laws())
 
+    def propagate_quantum_numbers_in_bulk(self, graph_setting_group):
+        propagators = [self.initialize_qn_propagator(graph, node_settings)
+                       for graph, node_settings in graph_setting_group]
+        solutions = find_solutions_in_bulk(propagators,
+                                           self.number_of_threads)
+        return [(x, propagator.get_non_satisfied_conservation_laws())
+                for x, propagator in zip(solutions, propagators)]
+
     def initialize_qn_propagator(self, state_graph, node_settings):
-        propagator = FullPropagator(state_graph, self.propagation_mode)
+        propagator = FullPropagator(state_graph, self.propagation_mode,
+                                    self.propagation_backend)
         for node_id, interaction_settings in node_settings.items():
             propagator.assign_settings_to_node(
                 node_id, interaction_settings)
@@ -699,6 +768,6 @@ class StateTransitionManager():
         # particles. If list is empty, then all particles in the default
         # particle list are used
         propagator.set_allowed_intermediate_particles(
-            self.allowed_intermediate_particles)
+            self.allowed_intermediate_particles, self.particle_index)
 
         return propagator
@@ -57,22 +57,257 @@ def correct_phi_range(phi):
             return phi
 
 
-def chisquare_test(histogram, func):
-    from functools import reduce
-    function_hist = function_to_histogram(func, histogram)
-    function_hist = scale_to_other_histogram(function_hist, histogram)
-    dof = reduce((lambda x, y: x * y),
-                 np.asarray(histogram.bin_contents).shape)-1
-
-    redchi2 = chisquare(histogram.bin_contents, histogram.bin_errors,
-                        function_hist.bin_contents)/dof
+def chisquare_test(histogram, func, **kwargs):
+    """Compare a histogram to a theory function.
+
+    The function is integrated over the histogram bins (see
+    :func:`function_to_histogram`), scaled to the histogram and compared via
+    a chi square.
+
+    Bins without uncertainty (neither in the histogram nor in the integrated
+    function) do not enter the chi square and are not counted as degrees of
+    freedom. If all bins have an uncertainty, the degrees of freedom are the
+    number of bins minus one, as before.
+
+    Returns:
+        tuple: expected and observed reduced chi square, and the expected
+        uncertainty of the reduced chi square
+    """
+    from pycompwa import ui
+    function_hist = function_to_histogram(func, histogram, **kwargs)
+
+    observed = np.asarray(histogram.bin_contents, dtype=float).ravel()
+    if histogram.bin_errors is None:
+        observed_errors = np.sqrt(np.abs(observed))
+    else:
+        observed_errors = np.asarray(histogram.bin_errors,
+                                     dtype=float).ravel()
+    expected_errors = []
+    if function_hist.bin_errors is not None:
+        expected_errors = np.asarray(function_hist.bin_errors).ravel()
+
+    chi2, dof, _ = ui.binned_chisquare(
+        observed, observed_errors,
+        np.asarray(function_hist.bin_contents).ravel(), expected_errors)
+    if dof == 0:
+        raise ValueError("Histogram does not contain any filled bins!")
+
+    redchi2 = chi2/dof
     logging.info("chisquare/dof: " + str(redchi2) +
                  " +- " + str(2.0*sqrt(2/dof)))
 
     return 1.0, redchi2, 2.0*sqrt(2/dof)
 
 
-def function_to_histogram(func, histogram):
+def unbinned_goodness_of_fit_tests(plot_data, column_names,
+                                   tests=('point_to_point_dissimilarity',
+                                          'mixed_sample_nearest_neighbours'),
+                                   number_of_permutations=100,
+                                   use_cosine_theta=True, **kwargs):
+    """Compare the fit result to the data without binning.
+
+    The data is compared to the intensity weighted phase space sample of the
+    plot data with the tests of :class:`pycompwa.ui.UnbinnedGoodnessOfFit`.
+    Possible tests are 'energy_test', 'point_to_point_dissimilarity' and
+    'mixed_sample_nearest_neighbours'. The run time of the energy test is
+    quadratic in the sample size.
+
+    Args:
+        plot_data (PlotData): data and fit result
+        column_names (list): variables that are compared
+        tests (list): names of the tests
+        number_of_permutations (int): permutations for the p-values
+        kwargs: further arguments for each test, e.g.
+            ``point_to_point_dissimilarity={'sigma': 0.2}``
+
+    Returns:
+        dict: test statistic and p-value for each test
+    """
+    from pycompwa import ui
+    dimensions = [Dimension(x) for x in column_names]
+    _, data_values = create_data_values(plot_data.data, dimensions,
+                                        use_cosine_theta)
+    _, fit_values = create_data_values(plot_data.fit_result_data, dimensions,
+                                       use_cosine_theta)
+    fit_result_weights = (plot_data.fit_result_data.intensity *
+                          plot_data.fit_result_data.weight)
+    gof = ui.UnbinnedGoodnessOfFit(
+        [np.asarray(x, dtype=float) for x in data_values],
+        np.asarray(plot_data.data.weight, dtype=float),
+        [np.asarray(x, dtype=float) for x in fit_values],
+        np.asarray(fit_result_weights, dtype=float))
+
+    results = {}
+    for test in tests:
+        results[test] = getattr(gof, test)(
+            number_of_permutations=number_of_permutations, **kwargs.get(
+                test, {}))
+        logging.info(test + ": statistic " + str(results[test][0]) +
+                     ", p-value " + str(results[test][1]))
+    return results
+
+
+def adaptive_binning_chisquare_test(plot_data, column_names,
+                                    minimal_events_per_bin=20,
+                                    use_cosine_theta=True):
+    """Chi square test of the fit result in an adaptive binning.
+
+    The data is split into bins with nearly equal numbers of events, so that
+    also multidimensional distributions can be compared without empty bins.
+    The intensity weighted phase space sample of the plot data gives the
+    expectation in each bin.
+
+    Returns:
+        tuple: reduced chi square and the binning (see
+        :func:`pycompwa.ui.adaptive_binning_chisquare`), which can be drawn
+        with :func:`plot_adaptive_binning_2d`
+    """
+    from pycompwa import ui
+    dimensions = [Dimension(x) for x in column_names]
+    _, data_values = create_data_values(plot_data.data, dimensions,
+                                        use_cosine_theta)
+    _, fit_values = create_data_values(plot_data.fit_result_data, dimensions,
+                                       use_cosine_theta)
+    fit_result_weights = (plot_data.fit_result_data.intensity *
+                          plot_data.fit_result_data.weight)
+    binning = ui.adaptive_binning_chisquare(
+        [np.asarray(x, dtype=float) for x in data_values],
+        np.asarray(plot_data.data.weight, dtype=float),
+        [np.asarray(x, dtype=float) for x in fit_values],
+        np.asarray(fit_result_weights, dtype=float), minimal_events_per_bin)
+    binning['dimensions'] = dimensions
+    if binning['degrees_of_freedom'] == 0:
+        raise ValueError("Adaptive binning does not contain filled bins!")
+
+    redchi2 = binning['chi_square']/binning['degrees_of_freedom']
+    logging.info("chisquare/dof in " + str(len(binning['data'])) +
+                 " adaptive bins: " + str(redchi2))
+    return redchi2, binning
+
+
+def plot_adaptive_binning_2d(binning, plot_data=None, **kwargs):
+    """Draw a two dimensional adaptive binning, colored by the pulls
+    (data - model) / error of the bins."""
+    from matplotlib.collections import PatchCollection
+    from matplotlib.patches import Rectangle
+    if np.shape(binning['lower_edges'])[1] != 2:
+        raise ValueError("Only two dimensional binnings can be drawn!")
+
+    errors = np.sqrt(np.asarray(binning['data_errors'])**2 +
+                     np.asarray(binning['model_errors'])**2)
+    errors[errors == 0.0] = 1.0
+    pulls = (np.asarray(binning['data']) -
+             np.asarray(binning['model'])) / errors
+    widths = binning['upper_edges'] - binning['lower_edges']
+    rectangles = [Rectangle(low, width[0], width[1]) for low, width
+                  in zip(binning['lower_edges'], widths)]
+    limit = max(np.max(np.abs(pulls)), 1.0)
+    collection = PatchCollection(rectangles, cmap=plt.get_cmap('bwr'),
+                                 edgecolor='grey', linewidth=0.2, **kwargs)
+    collection.set_array(pulls)
+    collection.set_clim(-limit, limit)
+
+    axis = plt.gca()
+    axis.add_collection(collection)
+    axis.set_xlim(np.min(binning['lower_edges'][:, 0]),
+                  np.max(binning['upper_edges'][:, 0]))
+    axis.set_ylim(np.min(binning['lower_edges'][:, 1]),
+                  np.max(binning['upper_edges'][:, 1]))
+    if plot_data is not None and 'dimensions' in binning:
+        axis.set_xlabel(create_axis_title(binning['dimensions'][0],
+                                          plot_data))
+        axis.set_ylabel(create_axis_title(binning['dimensions'][1],
+                                          plot_data))
+    cbar = plt.colorbar(collection, ax=axis)
+    cbar.ax.set_ylabel('pull')
+    return collection
+
+
+def compare_angular_moments(plot_data, theta_name, phi_name=None, max_l=4,
+                            mass_name=None, mass_bin_edges=None):
+    """Compare the angular moments of the data and the fit result.
+
+    The weighted sums of the Legendre polynomials of cos(theta), or of the
+    real spherical harmonics if phi_name is given, are computed for the data
+    and the intensity weighted phase space sample in a single pass (see
+    :func:`pycompwa.ui.angular_moments`). The fit result is scaled to the
+    data. If mass_bin_edges are given, the moments are computed in bins of
+    the column mass_name.
+
+    Returns:
+        dict: (L, M) 'indices', 'data' and 'fit' moments and their
+        covariances with the shape (mass bins, moments), the 'pulls' of each
+        moment and the 'chi_square' of each mass bin
+    """
+    from pycompwa import ui
+    if mass_bin_edges is None:
+        mass_bin_edges = []
+    elif not mass_name:
+        raise ValueError("mass_bin_edges require a mass_name!")
+
+    def moments(record, weights):
+        return ui.angular_moments(
+            np.cos(np.asarray(record[theta_name], dtype=float)),
+            np.asarray(record[phi_name], dtype=float) if phi_name
+            else np.array([]),
+            np.asarray(weights, dtype=float), max_l,
+            np.asarray(record[mass_name], dtype=float) if mass_name
+            else np.array([]),
+            list(mass_bin_edges))
+
+    data_weights = plot_data.data.weight
+    indices, data, data_covariance = moments(plot_data.data, data_weights)
+    result = {'indices': indices,
+              'data': data,
+              'data_covariance': data_covariance}
+    if plot_data.fit_result_data.size > 0:
+        fit_result_weights = (plot_data.fit_result_data.intensity *
+                              plot_data.fit_result_data.weight)
+        scaling_factor = sum(data_weights) / sum(fit_result_weights)
+        _, fit, fit_covariance = moments(
+            plot_data.fit_result_data, fit_result_weights*scaling_factor)
+        covariance = data_covariance + fit_covariance
+        errors = np.sqrt(np.diagonal(covariance, axis1=1, axis2=2))
+        difference = data - fit
+        result['fit'] = fit
+        result['fit_covariance'] = fit_covariance
+        result['pulls'] = np.divide(difference, errors,
+                                    out=np.zeros_like(difference),
+                                    where=errors > 0)
+        result['chi_square'] = np.array(
+            [x.dot(np.linalg.pinv(c)).dot(x)
+             for x, c in zip(difference, covariance)])
+    return result
+
+
+def function_to_histogram(func, histogram, method='nquad', points_per_bin=64):
+    """Integrate a function over the bins of a histogram.
+
+    Args:
+        func: function of the histogram variables, called as func(x, y, ...)
+        histogram (Histogram): provides the bin edges
+        method (str): 'nquad' integrates each bin separately with
+            :func:`scipy.integrate.nquad`, 'quasi_monte_carlo' integrates all
+            bins at once with quasi-random points in the native module
+        points_per_bin (int): number of quasi-random points per bin
+
+    Returns:
+        Histogram: integrals of the function in each bin
+    """
+    if method == 'quasi_monte_carlo':
+        from pycompwa import ui
+        bin_edges = histogram.bin_edges
+        values, errors = ui.integrate_function_in_bins(
+            _vectorize(func, len(bin_edges)),
+            [np.asarray(x, dtype=float).tolist() for x in bin_edges],
+            points_per_bin)
+        shape = tuple(len(x)-1 for x in bin_edges)
+        return Histogram(histogram.dimensions, bin_edges,
+                         np.reshape(values, shape),
+                         bin_errors=np.reshape(errors, shape))
+    if method != 'nquad':
+        raise ValueError("Unknown integration method " + str(method))
+
     bin_edges = histogram.bin_edges
     int_ranges = [[x] for x in zip(bin_edges[0][:-1], bin_edges[0][1:])]
     for dim_edges in bin_edges[1:]:
@@ -90,6 +325,48 @@ def function_to_histogram(func, histogram):
                      integrate_row_of_bins(func, int_ranges))
 
 
+def _vectorize(func, dimensions):
+    """Wrap func with :func:`numpy.vectorize` if it does not accept arrays."""
+    test_points = [np.linspace(0.1, 0.2, 3) for _ in range(dimensions)]
+    try:
+        if np.shape(func(*test_points)) == (3,):
+            return func
+    except TypeError:
+        pass
+    return np.vectorize(func, otypes=[float])
+
+
+def intensity_to_histogram(intensity, phsp_sample, histogram):
+    """Integrate an intensity over the bins of a histogram.
+
+    The phase space sample is weighted with the intensity and histogrammed
+    in the native module.
+
+    Args:
+        intensity: a pycompwa.ui.Intensity
+        phsp_sample (pycompwa.ui.DataSet): phase space sample, which contains
+            the kinematic variables of the histogram dimensions
+        histogram (Histogram): provides the bin edges and dimensions
+
+    Returns:
+        Histogram: integrals of the intensity in each bin
+    """
+    from pycompwa import ui
+    variable_names = []
+    for x in histogram.dimensions:
+        if x.binary_operator:
+            raise ValueError("Dimensions with binary operators are not "
+                             "supported.")
+        variable_names.append(x.field_name)
+    values, errors = ui.integrate_intensity_in_bins(
+        intensity, phsp_sample, variable_names,
+        [np.asarray(x, dtype=float).tolist() for x in histogram.bin_edges])
+    shape = tuple(len(x)-1 for x in histogram.bin_edges)
+    return Histogram(histogram.dimensions, histogram.bin_edges,
+                     np.reshape(values, shape),
+                     bin_errors=np.reshape(errors, shape))
+
+
 def integrate_row_of_bins(func, integration_ranges):
     import scipy.integrate as integrate
     if isinstance(integration_ranges[0][0], tuple):
@@ -103,7 +380,7 @@ def scale_to_other_histogram(histogram, histogram_reference):
     logging.info("calculated normalization:" + str(normalization))
     new_bin_contents = np.multiply(normalization, histogram.bin_contents)
     new_bin_errors = None
-    if histogram.bin_errors:
+    if histogram.bin_errors is not None:
         new_bin_errors = [np.sqrt(normalization) *
                           x for x in histogram.bin_errors]
     return Histogram(histogram.dimensions, histogram.bin_edges,
@@ -172,8 +449,14 @@ def make_binned_distributions(plot_data, dimensions_list,
                               number_of_bins=50,
                               nofit=False,
                               use_cosine_theta=True,
+                              use_kde=False,
                               **kwargs):
+    """
+    If use_kde is set, the distributions are smooth kernel density estimates
+    (see :func:`estimate_density`) instead of histograms.
+    """
     binned_distributions = []
+    make_distribution = estimate_density if use_kde else make_histogram
 
     if isinstance(dimensions_list, str):
         dimensions_list = [[Dimension(dimensions_list)]]
@@ -206,8 +489,8 @@ def make_binned_distributions(plot_data, dimensions_list,
     for dimensions in dimensions_list:
         new_dimensions, data_array = create_data_values(
             plot_data.data, dimensions, use_cosine_theta)
-        temp_hist = make_histogram(new_dimensions, data_array, data_weights,
-                                   number_of_bins, fmt='o')
+        temp_hist = make_distribution(new_dimensions, data_array,
+                                      data_weights, number_of_bins, fmt='o')
         new_distributions = {
             'data': temp_hist
         }
@@ -215,7 +498,7 @@ def make_binned_distributions(plot_data, dimensions_list,
         if fit_result_weights.size > 0:
             new_dimensions, fit_data_array = create_data_values(
                 plot_data.fit_result_data, dimensions, use_cosine_theta)
-            new_distributions['fit'] = make_histogram(
+            new_distributions['fit'] = make_distribution(
                 new_dimensions, fit_data_array, fit_result_weights,
                 bins=temp_hist.bin_edges)
 
@@ -272,6 +555,45 @@ def make_histogram(dimensions, values, weights, bins=50, **kwargs):
     return Histogram(dimensions, bin_edges, bin_content, errs, **kwargs)
 
 
+def estimate_density(dimensions, values, weights, bins=50, adaptive=True,
+                     bandwidth_scale=1.0, **kwargs):
+    """Smooth counterpart of :func:`make_histogram`.
+
+    The density of the weighted sample is estimated with an (adaptive)
+    Gaussian kernel density estimate in the native module. The bin contents
+    are the estimated sum of weights in each bin.
+
+    Args:
+        dimensions (list): list of Dimension, one to three dimensions
+        values: one array of values per dimension
+        weights: event weights
+        bins: number of bins (per dimension) or a list of equidistant bin
+            edges per dimension
+        adaptive (bool): use local bandwidths
+        bandwidth_scale (float): scale factor of the bandwidth
+    """
+    from pycompwa import ui
+    columns = [np.asarray(x, dtype=float) for x in values]
+    ranges = []
+    # the bin edges may differ in length per dimension, so bins is not
+    # converted to a numpy array as a whole
+    if np.isscalar(bins):
+        number_of_bins = [int(bins)]*len(columns)
+    elif all(np.isscalar(x) for x in bins):
+        number_of_bins = [int(x) for x in bins]
+    elif all(np.ndim(x) == 1 for x in bins):
+        number_of_bins = [len(x)-1 for x in bins]
+        ranges = [(x[0], x[-1]) for x in bins]
+    else:
+        raise ValueError("bins has to be a number of bins, a number per "
+                         "dimension or a list of bin edges per dimension")
+    bin_edges, bin_contents, _ = ui.kernel_density_estimate(
+        columns, number_of_bins, np.asarray(weights, dtype=float), ranges,
+        adaptive, bandwidth_scale)
+    return Histogram(dimensions, [np.asarray(x) for x in bin_edges],
+                     bin_contents, np.sqrt(np.abs(bin_contents)), **kwargs)
+
+
 def make_comparison_plot_1d(plot_data, column_names, **kwargs):
     for histograms in make_binned_distributions(
             plot_data, column_names, **kwargs):
@@ -308,7 +630,11 @@ def plot_distributions_1d(histograms, use_bin_centers=True,
     plt.savefig(var_name+'.png', bbox_inches='tight')
 
 
-def make_dalitz_plots(plot_data, var_names, **kwargs):
+def make_dalitz_plots(plot_data, var_names, use_kde=False, **kwargs):
+    """
+    If use_kde is set, smooth kernel density estimates are drawn instead of
+    histograms (see :func:`estimate_density`).
+    """
     if var_names:
         invariant_mass_names = var_names
     else:
@@ -335,13 +661,19 @@ def make_dalitz_plots(plot_data, var_names, **kwargs):
         msq1 = plot_data.data[im1]
         msq2 = plot_data.data[im2]
 
-        if 'cmin' not in kwargs:
-            kwargs['cmin'] = 0.00001
+        if use_kde:
+            density = estimate_density(
+                [Dimension(im1), Dimension(im2)], [msq1, msq2],
+                data_weights, kwargs.get('bins', 100))
+            img = _draw_density_2d(axs[i, 0], density)
+        else:
+            if 'cmin' not in kwargs:
+                kwargs['cmin'] = 0.00001
 
-        img = axs[i, 0].hist2d(msq1, msq2, norm=None,
-                               weights=data_weights,
-                               cmap=plt.get_cmap('viridis'),
-                               **kwargs)
+            img = axs[i, 0].hist2d(msq1, msq2, norm=None,
+                                   weights=data_weights,
+                                   cmap=plt.get_cmap('viridis'),
+                                   **kwargs)
 
         xtitle = create_axis_title(Dimension(im1), plot_data)
         axs[i, 0].set_xlabel(xtitle)
@@ -353,10 +685,16 @@ def make_dalitz_plots(plot_data, var_names, **kwargs):
         if fit_result_weights.size > 0:
             msq1 = plot_data.fit_result_data[im1]
             msq2 = plot_data.fit_result_data[im2]
-            img = axs[i, 1].hist2d(msq1, msq2, norm=None,
-                                   weights=fit_result_weights,
-                                   cmap=plt.get_cmap('viridis'),
-                                   **kwargs)
+            if use_kde:
+                fit_density = estimate_density(
+                    density.dimensions, [msq1, msq2], fit_result_weights,
+                    density.bin_edges)
+                img = _draw_density_2d(axs[i, 1], fit_density)
+            else:
+                img = axs[i, 1].hist2d(msq1, msq2, norm=None,
+                                       weights=fit_result_weights,
+                                       cmap=plt.get_cmap('viridis'),
+                                       **kwargs)
 
             axs[i, 1].set_xlabel(xtitle)
             axs[i, 1].set_ylabel(ytitle)
@@ -367,7 +705,16 @@ def make_dalitz_plots(plot_data, var_names, **kwargs):
     plt.tight_layout()
 
 
-def make_difference_plot_2d(plot_data, var_names, **kwargs):
+def _draw_density_2d(axis, histogram):
+    """Draw a 2D histogram like matplotlib's hist2d."""
+    image = axis.pcolormesh(histogram.bin_edges[0], histogram.bin_edges[1],
+                            np.asarray(histogram.bin_contents).T,
+                            cmap=plt.get_cmap('viridis'))
+    return (histogram.bin_contents, histogram.bin_edges[0],
+            histogram.bin_edges[1], image)
+
+
+def make_difference_plot_2d(plot_data, var_names, use_kde=False, **kwargs):
     if not isinstance(var_names, (list, tuple)) or not len(var_names) == 2:
         raise ValueError(
             "Incorrent number of variable names! Expecting two variables.")
@@ -375,7 +722,7 @@ def make_difference_plot_2d(plot_data, var_names, **kwargs):
     if plot_data.fit_result_data is None:
         raise ValueError("Fit result data has to be present!")
 
-    dists = make_binned_distributions(plot_data, var_names)
+    dists = make_binned_distributions(plot_data, var_names, use_kde=use_kde)
 
     for dist_pair in dists:
         plot_histogram_difference_2d(dist_pair, **kwargs)
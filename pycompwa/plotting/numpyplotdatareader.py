@@ -0,0 +1,36 @@
+import json
+import os
+
+import numpy as np
+
+
+def open_compwa_plot_data(input_directory_path):
+    """
+    Loads the plot data that was written by pycompwa.ui.create_numpyplotdata.
+    The samples are memory mapped, so only the columns which are accessed are
+    read from disk.
+    """
+    from pycompwa.plotting import PlotData
+    pd = PlotData()
+
+    with open(os.path.join(input_directory_path,
+                           'final_state_id_to_name_mapping.json')) as f:
+        for k, v in json.load(f).items():
+            pd.particle_id_to_name_mapping[int(k)] = v
+
+    data_path = os.path.join(input_directory_path, 'data.npy')
+    if os.path.exists(data_path):
+        pd.data = load_record_array(data_path)
+    fit_result_data_path = os.path.join(input_directory_path,
+                                        'intensity_weighted_phspdata.npy')
+    if os.path.exists(fit_result_data_path):
+        pd.fit_result_data = load_record_array(fit_result_data_path)
+
+    return pd
+
+
+def load_record_array(filename):
+    """
+    Memory maps a structured numpy file as a read-only numpy record array.
+    """
+    return np.load(filename, mmap_mode='r').view(np.recarray)
@@ -0,0 +1,76 @@
+from collections import OrderedDict
+from os import path
+
+import pytest
+import xmltodict
+
+from pycompwa.expertsystem.amplitude.helicitydecay import (
+    HelicityAmplitudeGeneratorXML)
+
+
+@pytest.fixture(scope='session')
+def model_file():
+    """Helicity model of D1(2420)0 -> D0 pi+ pi- with two coherent sums."""
+    return path.join(path.dirname(__file__), '..', '..',
+                     'angular-distribution-tests', 'D1ToD0PipPim',
+                     'model.xml')
+
+
+@pytest.fixture(scope='session')
+def parse_model_file():
+    def parse(filename):
+        # the model files have several xml roots
+        with open(filename) as xmlfile:
+            content = xmlfile.read().split('?>', 1)[-1]
+        return xmltodict.parse('<root>' + content + '</root>')['root']
+    return parse
+
+
+@pytest.fixture
+def generator(model_file, parse_model_file):
+    """Amplitude generator with the sections of the model file."""
+    generator = HelicityAmplitudeGeneratorXML()
+    model = parse_model_file(model_file)
+    generator.particle_list = OrderedDict(
+        [('ParticleList', model['ParticleList'])])
+    generator.kinematics = OrderedDict(
+        [('HelicityKinematics', model['HelicityKinematics'])])
+    generator.helicity_amplitudes = OrderedDict(
+        [('Intensity', model['Intensity'])])
+    return generator
+
+
+@pytest.fixture
+def model(generator):
+    return generator.get_model_dict()
+
+
+@pytest.fixture(scope='session')
+def ui():
+    return pytest.importorskip('pycompwa.ui')
+
+
+@pytest.fixture
+def particles(ui, model_file):
+    return ui.read_particles(model_file)
+
+
+@pytest.fixture
+def kinematics(ui, model_file, particles):
+    return ui.create_helicity_kinematics(model_file, particles)
+
+
+@pytest.fixture
+def generate_phsp(ui, kinematics):
+    """Factory of phase space samples with a fixed seed."""
+    def generate(number_of_events):
+        generator = ui.EvtGenGenerator(
+            kinematics.get_particle_state_transition_kinematics_info())
+        return ui.generate_phsp(
+            number_of_events, generator, ui.StdUniformRealGenerator(123))
+    return generate
+
+
+@pytest.fixture
+def phsp_sample(generate_phsp):
+    return generate_phsp(100)
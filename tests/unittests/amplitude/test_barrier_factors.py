@@ -0,0 +1,54 @@
+import numpy as np
+import pytest
+
+
+def test_barrier_factor_cache():
+    ui = pytest.importorskip('pycompwa.ui')
+    cache = ui.BarrierFactorCache()
+    name = cache.request_barrier_factor('mSq_(2,3)', 0.139, 0.139, 1, 1.5)
+    # identical requests share a column
+    assert cache.request_barrier_factor(
+        'mSq_(2,3)', 0.139, 0.139, 1, 1.5) == name
+    momentum = cache.request_breakup_momentum('mSq_(2,3)', 0.139, 0.139)
+    assert len(cache.column_names) == 2
+
+    s = np.array([0.3, 0.6, 1.0])
+    columns = cache.compute({'mSq_(2,3)': s})
+    q_squared = s / 4 - 0.139**2
+    z = q_squared * 1.5**2
+    assert np.allclose(columns[momentum], np.sqrt(q_squared))
+    assert np.allclose(columns[name], np.sqrt(2 * z / (z + 1)))
+
+    with pytest.raises(Exception):
+        cache.compute({'mSq_(1,2)': s})
+
+
+def test_canonical_requests():
+    ui = pytest.importorskip('pycompwa.ui')
+    cache = ui.BarrierFactorCache()
+    name = cache.request_barrier_factor('mSq_2_3', 0.139, 0.494, 1, 1.5)
+    # the order of the daughters and rounding errors do not matter
+    assert cache.request_barrier_factor(
+        'mSq_2_3', 0.494, 0.139, 1, 1.5) == name
+    assert cache.request_barrier_factor(
+        'mSq_2_3', 0.1 + 0.039, 0.494, 1, 1.0 + 0.5) == name
+    assert len(cache.column_names) == 1
+    with pytest.raises(Exception):
+        cache.request_breakup_momentum('mSq_2_3', -0.139, 0.494)
+
+
+def test_below_threshold():
+    ui = pytest.importorskip('pycompwa.ui')
+    cache = ui.BarrierFactorCache()
+    name = cache.request_barrier_factor('mSq_2_3', 0.5, 0.5, 2, 1.5)
+    momentum = cache.request_breakup_momentum('mSq_2_3', 0.5, 0.5)
+    s = np.array([0.5, 1.0, 1.5])
+    columns = cache.compute({'mSq_2_3': s})
+    # |q^2| is used below threshold
+    q_squared = np.abs(s / 4 - 0.25)
+    z = q_squared * 1.5**2
+    assert np.allclose(columns[momentum], np.sqrt(q_squared))
+    assert np.allclose(columns[name],
+                       np.sqrt(13 * z**2 / ((z - 3)**2 + 9 * z)))
+    assert columns[name][1] == 0.0
+
@@ -0,0 +1,25 @@
+import os
+
+import numpy as np
+
+
+def test_binary_model(tmp_path, ui, model_file, model, particles,
+                      kinematics, phsp_sample):
+    binary_file = str(tmp_path / 'model.bin')
+    ui.write_binary_model(model_file, binary_file)
+    assert repr(ui.read_particles(binary_file)) == repr(particles)
+    assert ui.create_helicity_kinematics(
+        binary_file, particles).phsp_volume() == kinematics.phsp_volume()
+
+    data = ui.convert_events_to_dataset(phsp_sample, kinematics)
+    intensity = ui.create_intensity(
+        binary_file, particles, kinematics, phsp_sample)
+    reference = ui.create_intensity(
+        model_file, particles, kinematics, phsp_sample)
+    assert np.allclose(intensity.evaluate(data.data),
+                       reference.evaluate(data.data))
+
+    # an existing file is replaced
+    ui.write_binary_model(model, binary_file)
+    assert repr(ui.read_particles(binary_file)) == repr(particles)
+    assert os.listdir(str(tmp_path)) == ['model.bin']
@@ -0,0 +1,78 @@
+from collections import OrderedDict
+
+import numpy as np
+import pytest
+
+
+def test_block_normalization(ui, model, particles, kinematics, phsp_sample):
+    assert ui.find_incoherent_blocks(model) == ['coherent_0', 'coherent_1']
+    normalization = ui.BlockNormalization(
+        model, particles, kinematics, phsp_sample)
+    assert len(normalization) == 2
+    integral = normalization.integral()
+    assert integral == pytest.approx(sum(normalization.block_integrals))
+    assert normalization.number_of_block_evaluations == 2
+
+    # only the block with the changed parameter is evaluated again
+    block_integrals = normalization.block_integrals
+    normalization.integral({'strength_coherent_0': 2.0})
+    assert normalization.number_of_block_evaluations == 3
+    assert normalization.integral({'strength_coherent_0': 2.0}) == \
+        pytest.approx(2 * block_integrals[0] + block_integrals[1])
+    assert normalization.number_of_block_evaluations == 3
+    with pytest.raises(Exception):
+        normalization.integral({'unknown': 1.0})
+
+
+def test_model_without_blocks(ui, model, particles, kinematics, phsp_sample):
+    del model['Intensity']['Intensity']
+    assert ui.find_incoherent_blocks(model) == []
+    with pytest.raises(Exception):
+        ui.BlockNormalization(model, particles, kinematics, phsp_sample)
+
+
+def test_block_normalized_log_likelihood(ui, model, particles, kinematics,
+                                         phsp_sample, generate_phsp):
+    intensity = ui.create_intensity(model, particles, kinematics, phsp_sample)
+    data = ui.convert_events_to_dataset(generate_phsp(50), kinematics)
+    phsp = ui.convert_events_to_dataset(phsp_sample, kinematics)
+    # the strength of the incoherent sum cancels
+    expected = -np.sum(np.log(intensity.evaluate(data.data))) + \
+        len(data.data[0]) * np.log(np.mean(intensity.evaluate(phsp.data)))
+
+    _, parameters = \
+        ui.create_unbinned_log_likelihood_function_tree_estimator(
+            intensity, data)
+    normalization = ui.BlockNormalization(
+        model, particles, kinematics, phsp_sample)
+    estimator = ui.BlockNormalizedLogLikelihood(
+        normalization, data, parameters)
+    assert estimator.evaluate() == pytest.approx(expected)
+    assert normalization.number_of_block_evaluations == 2
+    # nothing changed
+    assert estimator.evaluate() == pytest.approx(expected)
+    assert normalization.number_of_block_evaluations == 2
+
+
+def test_equivalence_to_function_tree_estimator(ui, model, particles,
+                                                kinematics, phsp_sample,
+                                                generate_phsp):
+    model['Intensity'] = OrderedDict([
+        ('@Class', 'NormalizedIntensity'), ('@Name', 'normalized'),
+        ('Intensity', model['Intensity'])])
+    # blocks with different weights
+    model['Intensity']['Intensity']['Intensity'][0]['Parameter']['Value'] = \
+        2.5
+    # the normalization registers the variables before the data is converted
+    normalization = ui.BlockNormalization(
+        model, particles, kinematics, phsp_sample)
+    intensity = ui.create_intensity(model, particles, kinematics, phsp_sample)
+    data = ui.convert_events_to_dataset(generate_phsp(50), kinematics)
+
+    function_tree_estimator, parameters = \
+        ui.create_unbinned_log_likelihood_function_tree_estimator(
+            intensity, data)
+    estimator = ui.BlockNormalizedLogLikelihood(
+        normalization, data, parameters)
+    assert estimator.evaluate() == \
+        pytest.approx(function_tree_estimator.evaluate())
@@ -0,0 +1,31 @@
+import pytest
+
+
+def test_fit_campaign(ui, model_file, model, particles, kinematics,
+                      generate_phsp):
+    phsp_sample = generate_phsp(1000)
+    intensity = ui.create_intensity(
+        model_file, particles, kinematics, phsp_sample)
+    data_sample = ui.generate(
+        200, kinematics, ui.EvtGenGenerator(
+            kinematics.get_particle_state_transition_kinematics_info()),
+        intensity, ui.StdUniformRealGenerator(456))
+
+    reduced_model = model
+    del reduced_model['Intensity']['Intensity'][0]['Amplitude'][-1]
+    campaign = ui.FitCampaign(particles, data_sample, phsp_sample)
+    campaign.add_hypothesis('full', model_file)
+    campaign.add_hypothesis('reduced', reduced_model)
+    results = campaign.run()
+    assert [x.name for x in results] == ['full', 'reduced']
+    for result in results:
+        assert result.aic == pytest.approx(
+            2 * result.number_of_free_parameters +
+            2 * result.negative_log_likelihood)
+    assert len(campaign.table().splitlines()) == 3
+
+    # the parallel fits give the same minima as one fit after another
+    likelihoods = [x.negative_log_likelihood for x in results]
+    sequential_results = campaign.run(1)
+    assert [x.negative_log_likelihood for x in sequential_results] == \
+        pytest.approx(likelihoods, abs=1e-2)
@@ -0,0 +1,61 @@
+from copy import deepcopy
+
+import numpy as np
+
+
+def test_parameter_changes(ui, model, particles, kinematics, phsp_sample):
+    cache = ui.IntensityCache()
+    intensity = cache.create_intensity(
+        model, particles, kinematics, phsp_sample)
+    data = ui.convert_events_to_dataset(phsp_sample, kinematics)
+    values = intensity.evaluate(data.data)
+
+    changed_model = deepcopy(model)
+    amplitudes = changed_model['Intensity']['Intensity'][0]['Amplitude']
+    amplitudes[0]['Parameter'][0]['Value'] = '2.0'
+    # the first intensity is still held, so it is not changed
+    changed_intensity = cache.create_intensity(
+        changed_model, particles, kinematics, phsp_sample)
+    assert changed_intensity is not intensity
+    assert cache.number_of_builds == 2
+    assert np.array_equal(intensity.evaluate(data.data), values)
+    assert not np.allclose(changed_intensity.evaluate(data.data), values)
+
+    # once released, the cached intensity is reused with the new values
+    del changed_intensity
+    reused_intensity = cache.create_intensity(
+        changed_model, particles, kinematics, phsp_sample)
+    assert cache.number_of_builds == 2
+    assert not np.allclose(reused_intensity.evaluate(data.data), values)
+    assert np.array_equal(intensity.evaluate(data.data), values)
+
+
+def test_structure_changes(ui, model, particles, kinematics, phsp_sample):
+    cache = ui.IntensityCache()
+    cache.create_intensity(model, particles, kinematics, phsp_sample)
+    reduced_model = deepcopy(model)
+    del reduced_model['Intensity']['Intensity'][0]['Amplitude'][-1]
+    cache.create_intensity(reduced_model, particles, kinematics, phsp_sample)
+    assert cache.number_of_builds == 2
+
+    # switching back reuses the first intensity
+    cache.create_intensity(model, particles, kinematics, phsp_sample)
+    assert cache.number_of_builds == 2
+
+    cache.reset()
+    cache.create_intensity(model, particles, kinematics, phsp_sample)
+    assert cache.number_of_builds == 3
+
+
+def test_phsp_sample_changes(ui, model, particles, kinematics, generate_phsp):
+    cache = ui.IntensityCache(1)
+    cache.create_intensity(model, particles, kinematics, generate_phsp(100))
+    # equal content
+    cache.create_intensity(model, particles, kinematics, generate_phsp(100))
+    assert cache.number_of_builds == 1
+
+    cache.create_intensity(model, particles, kinematics, generate_phsp(50))
+    assert cache.number_of_builds == 2
+    # the first intensity was dropped
+    cache.create_intensity(model, particles, kinematics, generate_phsp(100))
+    assert cache.number_of_builds == 3
@@ -0,0 +1,34 @@
+import numpy as np
+import pytest
+
+
+def test_solve_complex_linear_systems():
+    ui = pytest.importorskip('pycompwa.ui')
+    rng = np.random.RandomState(1)
+    for dimension in range(1, 6):
+        shape = (13, dimension, dimension)
+        matrices = rng.normal(size=shape) + 1j * rng.normal(size=shape)
+        vectors = (rng.normal(size=shape[:2]) +
+                   1j * rng.normal(size=shape[:2]))
+        solutions = ui.solve_complex_linear_systems(matrices, vectors)
+        assert np.allclose(
+            solutions, np.linalg.solve(matrices, vectors[..., None])[..., 0])
+
+
+def test_kmatrix_intensity():
+    ui = pytest.importorskip('pycompwa.ui')
+    # one channel and one pole is a Breit-Wigner
+    mass, coupling, production = 0.775, 0.5, 1.0 + 0.3j
+    intensity = ui.create_kmatrix_intensity(
+        'rho', [(0.14, 0.14)], [mass], [[coupling]], [production])
+    assert len(intensity.parameters) == 5
+
+    s = np.array([0.01, 0.3, 0.6, 0.8, 1.0])
+    rho = np.sqrt((1.0 - 4 * 0.14**2 / s).astype(complex))
+    expected = np.abs(production * coupling /
+                      (mass**2 - s - 1j * coupling**2 * rho))**2
+    assert np.allclose(intensity.evaluate([s]), expected)
+
+    with pytest.raises(Exception):
+        ui.create_kmatrix_intensity(
+            'f0', [(0.14, 0.14), (0.5, 0.5)], [0.98], [[0.3]], [1.0])
@@ -0,0 +1,48 @@
+import numpy as np
+
+
+def test_model_dict(tmp_path, generator, parse_model_file):
+    model = generator.get_model_dict()
+    assert list(model.keys()) == [
+        'ParticleList', 'HelicityKinematics', 'Intensity']
+
+    filename = str(tmp_path / 'model.xml')
+    generator.write_to_file(filename)
+    assert list(generator.particle_list.keys()) == ['ParticleList']
+    assert parse_model_file(filename) == model
+
+
+def test_model_dict_in_ui(ui, model, model_file, particles, kinematics):
+    assert repr(ui.read_particles(model)) == repr(particles)
+    assert ui.create_helicity_kinematics(
+        model, particles).phsp_volume() == kinematics.phsp_volume()
+
+
+def test_intensity_from_model_dict(tmp_path, ui, model, model_file,
+                                   particles, kinematics, phsp_sample):
+    # python booleans are written as by xmltodict.unparse()
+    def use_booleans(element):
+        if isinstance(element, list):
+            for x in element:
+                use_booleans(x)
+        elif isinstance(element, dict):
+            for key, value in element.items():
+                if key == 'Fix' and value in ['True', 'False']:
+                    element[key] = value == 'True'
+                else:
+                    use_booleans(value)
+    use_booleans(model)
+
+    data = ui.convert_events_to_dataset(phsp_sample, kinematics)
+    intensity = ui.create_intensity(model, particles, kinematics, phsp_sample)
+    reference = ui.create_intensity(
+        model_file, particles, kinematics, phsp_sample)
+    assert np.allclose(intensity.evaluate(data.data),
+                       reference.evaluate(data.data))
+
+    # the same holds for attributes
+    model['Intensity']['Parameter']['@Fix'] = True
+    binary_file = str(tmp_path / 'model.bin')
+    ui.write_binary_model(model, binary_file)
+    with open(binary_file, 'rb') as binary:
+        assert b'True' not in binary.read()
@@ -0,0 +1,106 @@
+import shutil
+import subprocess
+from os import path
+
+import numpy as np
+import pytest
+
+
+plugin_source = """
+#include "PyComPWA/Tools/PluginInterface.h"
+
+static const char *const parameter_names[] = {"mass", "width"};
+static const double default_parameter_values[] = {1.0, 0.1};
+
+static int breit_wigner(const double *const *columns,
+                        size_t number_of_columns, size_t number_of_events,
+                        const double *parameters, double *results) {
+  size_t i;
+  if (number_of_columns < 1)
+    return 1;
+  for (i = 0; i < number_of_events; ++i) {
+    double x = columns[0][i] - parameters[0] * parameters[0];
+    results[i] = 1.0 / (x * x + parameters[0] * parameters[0] *
+                                    parameters[1] * parameters[1]);
+  }
+  return 0;
+}
+
+static const struct pycompwa_intensity_function functions[] = {
+    {"Test.BreitWigner", 2, parameter_names, default_parameter_values,
+     breit_wigner}};
+
+static const struct pycompwa_plugin plugin = {PYCOMPWA_PLUGIN_ABI_VERSION,
+                                              "Test", 1, functions};
+
+const struct pycompwa_plugin *pycompwa_plugin_entry(void) { return &plugin; }
+"""
+
+
+duplicate_plugin_source = """
+#include "PyComPWA/Tools/PluginInterface.h"
+
+static int zero(const double *const *columns, size_t number_of_columns,
+                size_t number_of_events, const double *parameters,
+                double *results) {
+  size_t i;
+  for (i = 0; i < number_of_events; ++i)
+    results[i] = 0.0;
+  return 0;
+}
+
+static const struct pycompwa_intensity_function functions[] = {
+    {"Duplicate.Zero", 0, NULL, NULL, zero},
+    {"Duplicate.Other", 0, NULL, NULL, zero},
+    {"Duplicate.Zero", 0, NULL, NULL, zero}};
+
+static const struct pycompwa_plugin plugin = {PYCOMPWA_PLUGIN_ABI_VERSION,
+                                              "Duplicate", 3, functions};
+
+const struct pycompwa_plugin *pycompwa_plugin_entry(void) { return &plugin; }
+"""
+
+
+@pytest.fixture
+def compile_plugin(tmp_path):
+    """Factory of plugin libraries from C sources."""
+    compiler = shutil.which('cc')
+    if compiler is None:
+        pytest.skip('no C compiler')
+    include_directory = path.join(path.dirname(__file__), '..', '..', '..')
+
+    def compile_source(name, source):
+        source_file = tmp_path / (name + '.c')
+        source_file.write_text(source)
+        plugin_file = str(tmp_path / ('lib' + name + '.so'))
+        subprocess.check_call([compiler, '-shared', '-fPIC', '-I',
+                               include_directory, str(source_file), '-o',
+                               plugin_file])
+        return plugin_file
+    return compile_source
+
+
+def test_plugin_intensity(compile_plugin):
+    ui = pytest.importorskip('pycompwa.ui')
+    plugin_file = compile_plugin('testplugin', plugin_source)
+    assert ui.load_plugin(plugin_file) == ['Test.BreitWigner']
+    assert 'Test.BreitWigner' in ui.plugin_intensity_functions()
+
+    intensity = ui.create_plugin_intensity(
+        'Test.BreitWigner', {'width': 0.2}, block_size=2)
+    assert intensity.parameters == {'mass': 1.0, 'width': 0.2}
+    mass_squared = np.array([0.5, 1.0, 1.5])
+    assert np.allclose(intensity.evaluate([mass_squared]),
+                       1.0 / ((mass_squared - 1.0)**2 + 0.04))
+
+    with pytest.raises(Exception):
+        ui.create_plugin_intensity('Test.BreitWigner', {'radius': 1.0})
+
+
+def test_invalid_plugin(compile_plugin):
+    ui = pytest.importorskip('pycompwa.ui')
+    plugin_file = compile_plugin('duplicateplugin', duplicate_plugin_source)
+    with pytest.raises(Exception):
+        ui.load_plugin(plugin_file)
+    assert not [x for x in ui.plugin_intensity_functions()
+                if x.startswith('Duplicate.')]
@@ -0,0 +1,39 @@
+import numpy as np
+import pytest
+
+
+def breit_wigner(mass_squared, mass=0.775, width=0.149):
+    return 1.0 / ((mass_squared - mass**2)**2 + mass**2 * width**2)
+
+
+def test_tabulated_function():
+    ui = pytest.importorskip('pycompwa.ui')
+    table = ui.TabulatedFunction(breit_wigner, 0.1, 3.0, 2000)
+    assert table.number_of_points == 2000
+    accuracy = table.estimate_accuracy()
+    assert accuracy['maximum_relative_error'] < 1e-5
+
+    points = np.array([0.1, 0.5, 0.6, 3.0, 3.5])
+    assert np.allclose(table.evaluate(points), breit_wigner(points),
+                       rtol=1e-5)
+
+    intensity = table.intensity(variable_index=1)
+    assert np.allclose(
+        intensity.evaluate([np.zeros(len(points)), points]),
+        breit_wigner(points), rtol=1e-5)
+
+
+def complex_breit_wigner(mass_squared, mass=0.775, width=0.149):
+    return 1.0 / (mass**2 - mass_squared - 1j * mass * width)
+
+
+def test_complex_tabulated_function():
+    ui = pytest.importorskip('pycompwa.ui')
+    table = ui.ComplexTabulatedFunction(complex_breit_wigner, 0.1, 3.0, 2000)
+    assert table.estimate_accuracy()['maximum_relative_error'] < 1e-5
+
+    # the phase passes through pi / 2 at the peak
+    points = np.array([0.1, 0.5, 0.775**2, 0.7, 3.0, 3.5])
+    values = table.evaluate(points)
+    assert np.iscomplexobj(values)
+    assert np.allclose(values, complex_breit_wigner(points), rtol=1e-5)
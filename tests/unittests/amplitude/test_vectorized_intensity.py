@@ -0,0 +1,33 @@
+import math
+
+import numpy as np
+import pytest
+
+
+def test_vectorized_intensity():
+    ui = pytest.importorskip('pycompwa.ui')
+    blocks = []
+
+    def breit_wigner(columns, parameters):
+        mass_squared = columns[0]
+        assert not mass_squared.flags.writeable
+        blocks.append(len(mass_squared))
+        mass = parameters['mass']
+        width = parameters['width']
+        return 1.0 / ((mass_squared - mass**2)**2 + mass**2 * width**2)
+
+    intensity = ui.VectorizedIntensity(
+        breit_wigner, {'mass': 1.0, 'width': 0.1}, block_size=2)
+    assert intensity.parameters == {'mass': 1.0, 'width': 0.1}
+    mass_squared = [0.5, 1.0, 1.5]
+    values = intensity.evaluate([mass_squared, [0.0, 0.0, 0.0]])
+    assert blocks == [2, 1]
+    assert np.allclose(values, breit_wigner(
+        [np.array(mass_squared)], intensity.parameters))
+
+
+def test_vectorized_intensity_errors():
+    ui = pytest.importorskip('pycompwa.ui')
+    intensity = ui.VectorizedIntensity(lambda columns, parameters: [1.0])
+    values = intensity.evaluate([[1.0, 2.0]])
+    assert all(math.isnan(x) for x in values)
@@ -0,0 +1,108 @@
+from fractions import Fraction
+
+import pytest
+
+from pycompwa.expertsystem.state.clebschgordan import (
+    clebsch_gordan, clebsch_gordan_squared, wigner_3j)
+from pycompwa.expertsystem.state.conservationrules import (
+    ClebschGordanCheckHelicityToCanonical,
+    ExactClebschGordanCheckHelicityToCanonical,
+    is_clebsch_gordan_coefficient_zero,
+    is_exact_clebsch_gordan_coefficient_zero)
+from pycompwa.expertsystem.state.particle import (
+    InteractionQuantumNumberNames, StateQuantumNumberNames, Spin)
+
+
+@pytest.mark.parametrize(
+    "spins,expected",
+    [
+        ((0.5, 0.5, 0.5, -0.5, 0, 0), (1, Fraction(1, 2))),
+        ((0.5, -0.5, 0.5, 0.5, 0, 0), (-1, Fraction(1, 2))),
+        ((1, 0, 1, 0, 2, 0), (1, Fraction(2, 3))),
+        ((1, 0, 1, 0, 1, 0), (0, Fraction(0))),
+        ((1, 1, 1, -1, 0, 0), (1, Fraction(1, 3))),
+        ((1, 0, 0.5, 0.5, 1.5, 0.5), (1, Fraction(2, 3))),
+        # zero, which is not covered by the simple selection rules
+        ((2, 0, 3, 2, 3, 2), (0, Fraction(0))),
+        ((1, 1, 1, 1, 1, 0), (0, Fraction(0))),
+    ])
+def test_clebsch_gordan_values(spins, expected):
+    assert clebsch_gordan_squared(*spins) == expected
+
+
+def test_clebsch_gordan_orthogonality():
+    for j1 in [0.5, 1, 1.5, 2]:
+        for j2 in [0.5, 1, 2]:
+            j = abs(j1 - j2)
+            while j <= j1 + j2:
+                norm = sum(
+                    clebsch_gordan(j1, j1 - k, j2, j - j1 + k, j, j)**2
+                    for k in range(int(2 * j1) + 1)
+                    if abs(j - j1 + k) <= j2)
+                assert norm == pytest.approx(1.0)
+                j += 1
+
+
+def test_wigner_3j():
+    assert wigner_3j(1, 1, 1, -1, 0, 0) == pytest.approx(3**-0.5)
+    assert wigner_3j(2, 0, 2, 0, 2, 0) == pytest.approx(-(2 / 35)**0.5)
+
+
+def test_native_clebsch_gordan_table():
+    ui = pytest.importorskip('pycompwa.ui')
+    for spins in [(1, 0, 1, 0, 2, 0), (0.5, -0.5, 0.5, 0.5, 0, 0),
+                  (2, 1, 1.5, -0.5, 2.5, 0.5), (2, 0, 3, 2, 3, 2)]:
+        sign, square = clebsch_gordan_squared(*spins)
+        assert ui.clebsch_gordan_squared(*spins) == (
+            sign, square.numerator, square.denominator)
+        assert ui.clebsch_gordan(*spins) == pytest.approx(
+            clebsch_gordan(*spins))
+    assert ui.wigner_3j(2, 0, 2, 0, 2, 0) == pytest.approx(
+        wigner_3j(2, 0, 2, 0, 2, 0))
+    # J = 1 to two spin 1 particles with L = 1, S = 0
+    assert ui.ls_coupling_coefficient(1, 1, 0, 1, 0, 1, 0) == pytest.approx(
+        -3**-0.5)
+
+
+def all_couplings(maximum_spin):
+    spins = [x / 2 for x in range(int(2 * maximum_spin) + 1)]
+    for j1 in spins:
+        for j2 in spins:
+            for j in spins:
+                if (not abs(j1 - j2) <= j <= j1 + j2
+                        or (j1 + j2 + j) % 1):
+                    continue
+                for k1 in range(int(2 * j1) + 1):
+                    for k2 in range(int(2 * j2) + 1):
+                        m1, m2 = j1 - k1, j2 - k2
+                        if abs(m1 + m2) <= j:
+                            yield (Spin(j1, m1), Spin(j2, m2),
+                                   Spin(j, m1 + m2))
+
+
+def test_selection_rules_up_to_spin_2():
+    # the exact check agrees with the selection rules of the default rule
+    for spins in all_couplings(2):
+        assert is_exact_clebsch_gordan_coefficient_zero(*spins) == \
+            is_clebsch_gordan_coefficient_zero(*spins)
+
+
+def test_selection_rules_are_exact():
+    # the selection rules never reject a non-vanishing coefficient
+    for spins in all_couplings(3.5):
+        if is_clebsch_gordan_coefficient_zero(*spins):
+            assert is_exact_clebsch_gordan_coefficient_zero(*spins)
+
+
+def test_exact_clebsch_gordan_check():
+    spin = StateQuantumNumberNames.Spin
+    ingoing = [{spin: Spin(3, 2)}]
+    # <2 2 1 0 | 3 2> does not vanish, but <2 0 3 2 | 3 2> does
+    outgoing = [{spin: Spin(2, 2)}, {spin: Spin(1, 0)}]
+    interaction = {InteractionQuantumNumberNames.L: Spin(2, 0),
+                   InteractionQuantumNumberNames.S: Spin(3, 0)}
+    assert ClebschGordanCheckHelicityToCanonical().check(
+        ingoing, outgoing, interaction)
+    exact_rule = ExactClebschGordanCheckHelicityToCanonical()
+    assert str(exact_rule) == 'ExactClebschGordanCheckHelicityToCanonical'
+    assert not exact_rule.check(ingoing, outgoing, interaction)
@@ -0,0 +1,6 @@
+import pytest
+
+
+@pytest.fixture(scope='session')
+def ui():
+    return pytest.importorskip('pycompwa.ui')
@@ -0,0 +1,36 @@
+import numpy as np
+
+from pycompwa.plotting import (
+    PlotData, create_nprecord, adaptive_binning_chisquare_test,
+    plot_adaptive_binning_2d
+)
+
+
+def make_plot_data(size=5000):
+    np.random.seed(11)
+    data = create_nprecord(
+        ['x', 'y', 'z', 'weight'],
+        [np.random.normal(0.0, 1.0, size), np.random.normal(0.0, 1.0, size),
+         np.random.normal(0.0, 1.0, size), np.ones(size)])
+    x, y, z = np.random.uniform(-5.0, 5.0, (3, 20*size))
+    fit_result = create_nprecord(
+        ['x', 'y', 'z', 'intensity', 'weight'],
+        [x, y, z, np.exp(-0.5*(x*x+y*y+z*z)), np.ones(20*size)])
+    return PlotData(data, fit_result)
+
+
+def test_equal_population_bins(ui):
+    redchi2, binning = adaptive_binning_chisquare_test(
+        make_plot_data(), ['x', 'y', 'z'], minimal_events_per_bin=50)
+    assert np.all(binning['data'] >= 50)
+    assert np.all(binning['data'] < 100)
+    assert np.all(binning['lower_edges'] < binning['upper_edges'])
+    assert np.isclose(np.sum(binning['model']), np.sum(binning['data']))
+    assert abs(redchi2 - 1.0) < 0.5
+
+
+def test_plot_adaptive_binning_2d(ui):
+    plot_data = make_plot_data()
+    _, binning = adaptive_binning_chisquare_test(plot_data, ['x', 'y'])
+    collection = plot_adaptive_binning_2d(binning, plot_data)
+    assert len(collection.get_paths()) == len(binning['data'])
@@ -0,0 +1,46 @@
+from math import pi
+
+import numpy as np
+
+from pycompwa.plotting import (
+    PlotData, create_nprecord, compare_angular_moments
+)
+
+
+def make_plot_data(size=20000):
+    # data distributed as 1 + cos^2(theta), flat in phi and the mass
+    np.random.seed(3)
+    cos_theta = np.random.uniform(-1.0, 1.0, 4*size)
+    cos_theta = cos_theta[
+        np.random.uniform(0.0, 2.0, 4*size) < 1.0+cos_theta**2][:size]
+    data = create_nprecord(
+        ['theta', 'phi', 'mass', 'weight'],
+        [np.arccos(cos_theta), np.random.uniform(-pi, pi, size),
+         np.random.uniform(1.0, 2.0, size), np.ones(size)])
+    cos_theta = np.random.uniform(-1.0, 1.0, 5*size)
+    fit_result = create_nprecord(
+        ['theta', 'phi', 'mass', 'intensity', 'weight'],
+        [np.arccos(cos_theta), np.random.uniform(-pi, pi, 5*size),
+         np.random.uniform(1.0, 2.0, 5*size), 1.0+cos_theta**2,
+         np.ones(5*size)])
+    return PlotData(data, fit_result)
+
+
+def test_legendre_moments(ui):
+    moments = compare_angular_moments(make_plot_data(), 'theta', max_l=4)
+    assert [x[0] for x in moments['indices']] == [0, 1, 2, 3, 4]
+    data = moments['data'][0]
+    errors = np.sqrt(np.diagonal(moments['data_covariance'][0]))
+    # <P_2> = 0.1 for 1 + cos^2(theta)
+    assert abs(data[2] - 0.1*data[0]) < 3*errors[2]
+    assert np.all(np.abs(moments['pulls']) < 4)
+
+
+def test_spherical_harmonic_moments_in_mass_bins(ui):
+    moments = compare_angular_moments(
+        make_plot_data(), 'theta', 'phi', max_l=2, mass_name='mass',
+        mass_bin_edges=np.linspace(1.0, 2.0, 5))
+    assert len(moments['indices']) == 9
+    assert np.shape(moments['data']) == (4, 9)
+    assert np.shape(moments['fit_covariance']) == (4, 9, 9)
+    assert np.all(moments['chi_square'] < 40)
@@ -0,0 +1,63 @@
+from math import cos
+
+import numpy as np
+import pytest
+
+from pycompwa.plotting import (
+    Dimension, Histogram, function_to_histogram, chisquare_test,
+    scale_to_other_histogram
+)
+
+
+def make_test_histogram(bin_edges):
+    shape = tuple(len(x)-1 for x in bin_edges)
+    return Histogram([Dimension('x'+str(i)) for i in range(len(bin_edges))],
+                     bin_edges, np.ones(shape), np.ones(shape))
+
+
+@pytest.mark.parametrize(
+    "func,bin_edges",
+    [
+        (lambda x: 1.25+0.75*x*x, [np.linspace(-1.0, 1.0, 21)]),
+        (lambda x: 1-1/2.25*cos(2*x), [np.linspace(-3.14, 3.14, 11)]),
+        (lambda x, y: 2.0+x*y, [np.linspace(-1.0, 1.0, 6),
+                                np.linspace(0.0, 2.0, 4)]),
+    ])
+def test_quasi_monte_carlo_matches_nquad(ui, func, bin_edges):
+    histogram = make_test_histogram(bin_edges)
+    reference = function_to_histogram(func, histogram, method='nquad')
+    result = function_to_histogram(func, histogram,
+                                   method='quasi_monte_carlo',
+                                   points_per_bin=256)
+    assert np.shape(result.bin_contents) == np.shape(reference.bin_contents)
+    assert np.allclose(result.bin_contents, reference.bin_contents,
+                       rtol=1e-2)
+
+
+def test_chisquare_of_flat_distribution(ui):
+    np.random.seed(123)
+    values = np.random.uniform(-1.0, 1.0, 20000)
+    contents, edges = np.histogram(values, bins=40)
+    histogram = Histogram([Dimension('x')], [edges], contents,
+                          np.sqrt(contents))
+    expected, redchi2, error = chisquare_test(histogram, lambda x: 1.0+0*x)
+    assert abs(expected - redchi2) < error
+
+
+def test_default_method_is_nquad():
+    histogram = make_test_histogram([np.linspace(-1.0, 1.0, 5)])
+    result = function_to_histogram(lambda x: x*x, histogram)
+    reference = function_to_histogram(lambda x: x*x, histogram,
+                                      method='nquad')
+    assert np.array_equal(result.bin_contents, reference.bin_contents)
+    assert result.bin_errors is None
+
+
+def test_scale_to_other_histogram():
+    histogram = make_test_histogram([np.linspace(0.0, 1.0, 5)])
+    reference = Histogram(histogram.dimensions, histogram.bin_edges,
+                          4*np.ones(4))
+    scaled = scale_to_other_histogram(histogram, reference)
+    assert np.allclose(scaled.bin_contents, 4.0)
+    # the errors scale with the square root of the normalization
+    assert np.allclose(scaled.bin_errors, 2.0)
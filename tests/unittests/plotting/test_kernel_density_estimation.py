@@ -0,0 +1,52 @@
+import numpy as np
+import pytest
+
+from pycompwa.plotting import Dimension, estimate_density
+
+
+@pytest.mark.parametrize("adaptive", [False, True])
+def test_density_of_normal_distribution(ui, adaptive):
+    np.random.seed(42)
+    values = np.random.normal(0.0, 1.0, 200000)
+    weights = np.full(len(values), 0.5)
+    density = estimate_density([Dimension('x')], [values], weights,
+                               bins=[np.linspace(-4.0, 4.0, 81)],
+                               adaptive=adaptive)
+    bin_centers = 0.5*(density.bin_edges[0][1:]+density.bin_edges[0][:-1])
+    expected = 0.5*len(values)*0.1*np.exp(-0.5*bin_centers**2)/np.sqrt(
+        2*np.pi)
+    assert np.shape(density.bin_contents) == (80,)
+    assert np.allclose(density.bin_contents, expected, rtol=0.05,
+                       atol=0.01*expected.max())
+
+
+@pytest.mark.parametrize("adaptive", [False, True])
+def test_density_of_correlated_2d_normal_distribution(ui, adaptive):
+    np.random.seed(42)
+    x = np.random.normal(0.0, 1.0, 200000)
+    y = 0.5*np.random.normal(0.0, 1.0, len(x)) + 0.3*x
+    weights = np.full(len(x), 0.5)
+    # the dimensions have different numbers of bin edges
+    density = estimate_density([Dimension('x'), Dimension('y')], [x, y],
+                               weights, bins=[np.linspace(-4.0, 4.0, 41),
+                                              np.linspace(-2.0, 2.0, 21)],
+                               adaptive=adaptive)
+    assert np.shape(density.bin_contents) == (40, 20)
+    centers = [0.5*(edges[1:]+edges[:-1]) for edges in density.bin_edges]
+    cx, cy = np.meshgrid(*centers, indexing='ij')
+    residual = cy - 0.3*cx
+    expected = 0.5*len(x)*0.2*0.2*np.exp(
+        -0.5*cx**2 - 0.5*residual**2/0.25)/(2*np.pi*0.5)
+    assert np.allclose(density.bin_contents, expected, rtol=0.1,
+                       atol=0.02*expected.max())
+
+
+def test_number_of_bins_per_dimension(ui):
+    np.random.seed(1)
+    values = [np.random.normal(0.0, 1.0, 1000) for _ in range(2)]
+    density = estimate_density([Dimension('x'), Dimension('y')], values,
+                               np.ones(1000), bins=[10, 5])
+    assert np.shape(density.bin_contents) == (10, 5)
+    with pytest.raises(ValueError):
+        estimate_density([Dimension('x'), Dimension('y')], values,
+                         np.ones(1000), bins=[10, np.linspace(-1, 1, 5)])
@@ -0,0 +1,26 @@
+import numpy as np
+import pytest
+
+from pycompwa.plotting.numpyplotdatareader import load_record_array
+
+
+def test_record_array_round_trip(tmpdir):
+    ui = pytest.importorskip('pycompwa.ui')
+    filename = str(tmpdir.join('data.npy'))
+    columns = [[0.1, 0.2, 0.3], [1.0, 0.5, 2.0]]
+    ui.write_npy_record_array(filename, ['mSq_(2,3)', 'weight'], columns)
+
+    records = np.load(filename, mmap_mode='r')
+    assert records.dtype.names == ('mSq_(2,3)', 'weight')
+    assert np.array_equal(records['mSq_(2,3)'], columns[0])
+    assert np.array_equal(records['weight'], columns[1])
+    assert np.array_equal(load_record_array(filename).weight, columns[1])
+
+
+def test_record_array_name_clash(tmpdir):
+    ui = pytest.importorskip('pycompwa.ui')
+    filename = str(tmpdir.join('phsp.npy'))
+    with pytest.raises(Exception):
+        ui.write_npy_record_array(
+            filename, ['weight', 'intensity', 'intensity'],
+            [[1.0], [2.0], [3.0]])
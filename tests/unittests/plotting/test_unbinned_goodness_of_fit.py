@@ -0,0 +1,33 @@
+import numpy as np
+import pytest
+
+from pycompwa.plotting import (
+    PlotData, create_nprecord, unbinned_goodness_of_fit_tests
+)
+
+
+def make_plot_data(shift, size=2000):
+    np.random.seed(7)
+    data = create_nprecord(
+        ['x', 'y', 'weight'],
+        [np.random.normal(shift, 1.0, size), np.random.normal(0.0, 1.0, size),
+         np.ones(size)])
+    x = np.random.uniform(-5.0, 5.0, 10*size)
+    y = np.random.uniform(-5.0, 5.0, 10*size)
+    fit_result = create_nprecord(
+        ['x', 'y', 'intensity', 'weight'],
+        [x, y, np.exp(-0.5*(x*x+y*y)), np.ones(10*size)])
+    return PlotData(data, fit_result)
+
+
+@pytest.mark.parametrize("test", ['point_to_point_dissimilarity',
+                                  'mixed_sample_nearest_neighbours'])
+def test_p_values(ui, test):
+    settings = {'point_to_point_dissimilarity': {'sigma': 0.3}}
+    good_fit = unbinned_goodness_of_fit_tests(
+        make_plot_data(0.0), ['x', 'y'], tests=[test], **settings)
+    bad_fit = unbinned_goodness_of_fit_tests(
+        make_plot_data(0.8), ['x', 'y'], tests=[test], **settings)
+    assert good_fit[test][1] > 0.01
+    assert bad_fit[test][1] < 0.05
+    assert bad_fit[test][0] > good_fit[test][0]
@@ -0,0 +1,101 @@
+import json
+from copy import deepcopy
+
+import pytest
+
+from pycompwa.expertsystem.topology.graph import StateTransitionGraph
+from pycompwa.expertsystem.state.particle import (
+    StateQuantumNumberNames, Spin, QNNameClassMapping,
+    QNClassConverterMapping)
+
+
+def create_meson(name, pid, mass, width, spin, parity, cparity, gparity,
+                 isospin, charge=0):
+    qns = dict(Charge=charge, Spin=spin, Parity=parity, IsoSpin=isospin,
+               BaryonNumber=0, ElectronLN=0, MuonLN=0, TauLN=0,
+               Strangeness=0, Charm=0, Bottomness=0, Topness=0)
+    if cparity is not None:
+        qns['Cparity'] = cparity
+    if gparity is not None:
+        qns['Gparity'] = gparity
+    qn_list = []
+    for qn_name, value in qns.items():
+        qn_name = StateQuantumNumberNames[qn_name]
+        converter = QNClassConverterMapping[QNNameClassMapping[qn_name]]
+        qn_list.append(converter.convert_to_dict(qn_name, value))
+    return {'@Name': name, 'Pid': pid, 'QuantumNumber': qn_list,
+            'Parameter': {'@Type': 'Mass', 'Value': mass},
+            'DecayInfo': {'Parameter': [{'@Type': 'Width', 'Value': width}]}}
+
+
+@pytest.fixture(scope='session')
+def particles():
+    """External states of the test decays by name."""
+    return {
+        'J/psi': create_meson('J/psi', 443, 3.097, 0.0001, Spin(1, 1), -1,
+                              -1, -1, Spin(0, 0)),
+        'gamma': create_meson('gamma', 22, 0.0, 0.0, Spin(1, -1), -1, -1,
+                              None, Spin(0, 0)),
+        'pi0': create_meson('pi0', 111, 0.135, 0.0, Spin(0, 0), -1, 1, -1,
+                            Spin(1, 0)),
+        'pi+': create_meson('pi+', 211, 0.1396, 0.0, Spin(0, 0), -1, None,
+                            -1, Spin(1, 1), 1),
+        'pi-': create_meson('pi-', -211, 0.1396, 0.0, Spin(0, 0), -1, None,
+                            -1, Spin(1, -1), -1),
+    }
+
+
+@pytest.fixture(scope='session')
+def intermediate_states():
+    return [
+        create_meson('f0(980)', 9010221, 0.99, 0.05, Spin(0, 0), 1, 1, 1,
+                     Spin(0, 0)),
+        create_meson('f2(1270)', 225, 1.275, 0.185, Spin(2, 0), 1, 1, 1,
+                     Spin(0, 0)),
+        create_meson('rho(770)0', 113, 0.775, 0.149, Spin(1, 0), -1, -1, 1,
+                     Spin(1, 0)),
+        create_meson('rho(770)+', 213, 0.775, 0.149, Spin(1, 0), -1, None, 1,
+                     Spin(1, 1), 1),
+        create_meson('omega(782)', 223, 0.782, 0.0085, Spin(1, 0), -1, -1,
+                     -1, Spin(0, 0)),
+        create_meson('psi(4040)', 100443, 4.039, 0.08, Spin(1, 0), -1, -1,
+                     -1, Spin(0, 0)),
+    ]
+
+
+@pytest.fixture
+def two_step_decay_graph(particles):
+    """
+    Factory of the graph of the decay of a J/psi to the final state particles
+    (given by name) via one intermediate state.
+    """
+    def create_graph(final_state):
+        graph = StateTransitionGraph()
+        graph.add_node(0)
+        graph.add_node(1)
+        graph.add_edges([0, 1, 2, 3, 4])
+        graph.attach_edges_to_node_ingoing([0], 0)
+        graph.attach_edges_to_node_outgoing([1, 4], 0)
+        graph.attach_edges_to_node_ingoing([4], 1)
+        graph.attach_edges_to_node_outgoing([2, 3], 1)
+        graph.edge_props[0] = deepcopy(particles['J/psi'])
+        for edge_id, name in enumerate(final_state, 1):
+            graph.edge_props[edge_id] = deepcopy(particles[name])
+        return graph
+    return create_graph
+
+
+@pytest.fixture(scope='session')
+def graph_key():
+    """Comparable representation of the properties of a solution graph."""
+    def create_key(graph):
+        def sort_qns(props):
+            props = deepcopy(props)
+            if 'QuantumNumber' in props:
+                props['QuantumNumber'].sort(key=lambda x: x['@Type'])
+            return props
+        return json.dumps(
+            [[sort_qns(element_props[x]) for x in sorted(element_props)]
+             for element_props in [graph.edge_props, graph.node_props]],
+            sort_keys=True, default=str)
+    return create_key
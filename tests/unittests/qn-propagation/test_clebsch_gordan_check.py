@@ -0,0 +1,38 @@
+import pytest
+
+from pycompwa.expertsystem.state.conservationrules import (
+    ClebschGordanCheckHelicityToCanonical,
+    ExactClebschGordanCheckHelicityToCanonical)
+from pycompwa.expertsystem.state.propagation import (
+    FullPropagator, InteractionTypes)
+from pycompwa.expertsystem.ui.default_settings import (
+    create_default_interaction_settings)
+
+
+@pytest.mark.parametrize("backend", ['python', 'native'])
+@pytest.mark.parametrize("final_state", [
+    ['gamma', 'pi0', 'pi0'],
+    ['gamma', 'pi+', 'pi-'],
+])
+def test_exact_check_keeps_solutions(backend, final_state,
+                                     intermediate_states,
+                                     two_step_decay_graph, graph_key):
+    """The exact rule only differs from the default one for spins above 2."""
+    results = []
+    for rule in [ClebschGordanCheckHelicityToCanonical(),
+                 ExactClebschGordanCheckHelicityToCanonical()]:
+        settings = create_default_interaction_settings('canonical-helicity')
+        propagator = FullPropagator(two_step_decay_graph(final_state),
+                                    backend=backend)
+        propagator.set_allowed_intermediate_particles(intermediate_states)
+        for node_id, interaction_type in enumerate(
+                [InteractionTypes.EM, InteractionTypes.Strong]):
+            node_settings = settings[interaction_type]
+            node_settings.conservation_laws = [
+                rule if isinstance(x, ClebschGordanCheckHelicityToCanonical)
+                else x for x in node_settings.conservation_laws]
+            propagator.assign_settings_to_node(node_id, node_settings)
+        results.append(sorted(graph_key(x)
+                              for x in propagator.find_solutions()))
+    assert results[0]
+    assert results[1] == results[0]
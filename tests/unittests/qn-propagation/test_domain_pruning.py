@@ -0,0 +1,93 @@
+import pickle
+
+import pytest
+
+from pycompwa.expertsystem.state.particle import (
+    StateQuantumNumberNames, Spin, ParticleIndex)
+from pycompwa.expertsystem.state.propagation import (
+    CSPPropagator, FullPropagator, InteractionTypes)
+from pycompwa.expertsystem.ui.default_settings import (
+    create_default_interaction_settings)
+
+
+def test_particle_index(intermediate_states):
+    index = ParticleIndex(intermediate_states)
+    assert index.get_particles_with_qn_value(
+        StateQuantumNumberNames.Charge, 1) == {3}
+    assert index.get_particles_with_qn_value(
+        StateQuantumNumberNames.Cparity, 1) == {0, 1}
+    assert index.get_particles_below(0.9, 3) == {0, 1, 2, 3, 4}
+    assert index.get_particles_above(1.5, 3) == {1, 5}
+    assert index.get_allowed_values(
+        StateQuantumNumberNames.Spin,
+        [Spin(0, 0), Spin(1, 0), Spin(1, 1), Spin(2, 0)],
+        frozenset([0, 2])) == [Spin(0, 0), Spin(1, 0)]
+    assert index.get_allowed_values(
+        StateQuantumNumberNames.Cparity, [-1, 1, None],
+        frozenset([3])) == [None]
+
+
+def test_shared_particle_index(intermediate_states, two_step_decay_graph):
+    index = ParticleIndex(intermediate_states)
+    # the index is sent to the worker processes of the StateTransitionManager
+    copied_index = pickle.loads(pickle.dumps(index))
+    assert copied_index.qn_values == index.qn_values
+    settings = create_default_interaction_settings('helicity')
+    propagator = FullPropagator(two_step_decay_graph(['gamma', 'pi0', 'pi0']))
+    propagator.set_allowed_intermediate_particles(intermediate_states, index)
+    propagator.assign_settings_to_all_nodes(settings[InteractionTypes.Strong])
+    assert propagator.find_solutions()
+    assert propagator.propagator.particle_index is index
+
+
+def test_intermediate_candidates(intermediate_states, two_step_decay_graph):
+    settings = create_default_interaction_settings('helicity')
+    propagator = CSPPropagator(two_step_decay_graph(['gamma', 'pi+', 'pi-']))
+    propagator.allowed_intermediate_particles = intermediate_states
+    for node_id in [0, 1]:
+        propagator.assign_settings_to_node(
+            node_id, settings[InteractionTypes.Strong])
+    propagator.determine_intermediate_candidates()
+    # the charged and the too heavy states are removed
+    assert propagator.intermediate_candidates == {4: {0, 1, 2, 4}}
+    assert propagator.prune_domain(
+        4, StateQuantumNumberNames.Charge, [-1, 0, 1]) == [0]
+    assert propagator.pruned_domains
+
+
+@pytest.mark.parametrize("backend", ['python', 'native'])
+@pytest.mark.parametrize("final_state", [
+    ['gamma', 'pi0', 'pi0'],
+    ['gamma', 'pi+', 'pi-'],
+    # no solutions for the strong and electromagnetic decays
+    ['pi0', 'pi+', 'pi-'],
+])
+@pytest.mark.parametrize("interaction_types", [
+    (InteractionTypes.EM, InteractionTypes.Strong),
+    (InteractionTypes.Strong, InteractionTypes.Strong),
+    (InteractionTypes.Weak, InteractionTypes.Weak),
+])
+def test_pruning_keeps_solutions(backend, final_state, interaction_types,
+                                 intermediate_states, two_step_decay_graph,
+                                 graph_key):
+    settings = create_default_interaction_settings('helicity')
+    results = []
+    for prune_domains in [False, True]:
+        propagator = FullPropagator(
+            two_step_decay_graph(final_state), backend=backend,
+            prune_domains=prune_domains)
+        propagator.set_allowed_intermediate_particles(intermediate_states)
+        for node_id, interaction_type in enumerate(interaction_types):
+            propagator.assign_settings_to_node(
+                node_id, settings[interaction_type])
+        solutions = propagator.find_solutions()
+        # the violated rules are only reported if there are no solutions
+        violated_rules = {}
+        if not solutions:
+            violated_rules = {
+                k: sorted(str(x) for x in v) for k, v in
+                propagator.get_non_satisfied_conservation_laws().items()
+                if v}
+        results.append(
+            (sorted(graph_key(x) for x in solutions), violated_rules))
+    assert results[1] == results[0]
@@ -0,0 +1,129 @@
+from copy import deepcopy
+
+import pytest
+
+from pycompwa.expertsystem.topology.graph import StateTransitionGraph
+from pycompwa.expertsystem.state.conservationrules import (
+    AdditiveQuantumNumberConservation)
+from pycompwa.expertsystem.state.particle import StateQuantumNumberNames
+from pycompwa.expertsystem.state.propagation import (
+    CSPPropagator, NativeCSPPropagator, FullPropagator, InteractionTypes,
+    ParticleStateTransitionGraphValidator, find_solutions_in_bulk)
+from pycompwa.expertsystem.ui.default_settings import (
+    create_default_interaction_settings)
+
+
+def find_validated_solutions(propagator_class, graph, node_settings,
+                             graph_key):
+    propagator = propagator_class(deepcopy(graph))
+    for node_id, interaction_settings in node_settings.items():
+        propagator.assign_settings_to_node(node_id, interaction_settings)
+    solutions = set()
+    for solution in propagator.find_solutions():
+        validator = ParticleStateTransitionGraphValidator(solution)
+        for node_id, rules in (
+                propagator.node_postponed_conservation_laws.items()):
+            validator.assign_settings_to_node(node_id, rules)
+        validator.find_solutions()
+        if not validator.node_non_satisfied_laws:
+            solutions.add(graph_key(solution))
+    return solutions
+
+
+@pytest.mark.parametrize("formalism_type", ['helicity', 'canonical'])
+@pytest.mark.parametrize("final_state", [
+    ['gamma', 'pi0', 'pi0'],
+    ['pi0', 'pi+', 'pi-'],
+])
+@pytest.mark.parametrize("interaction_types", [
+    (InteractionTypes.Strong, InteractionTypes.Strong),
+    (InteractionTypes.EM, InteractionTypes.Strong),
+    (InteractionTypes.Weak, InteractionTypes.EM),
+])
+def test_native_solutions(formalism_type, final_state, interaction_types,
+                          two_step_decay_graph, graph_key):
+    settings = create_default_interaction_settings(formalism_type)
+    node_settings = {node_id: settings[x]
+                     for node_id, x in enumerate(interaction_types)}
+    graph = two_step_decay_graph(final_state)
+
+    solutions = find_validated_solutions(CSPPropagator, graph, node_settings,
+                                         graph_key)
+    native_solutions = find_validated_solutions(NativeCSPPropagator, graph,
+                                                node_settings, graph_key)
+    assert native_solutions == solutions
+
+
+def test_native_violated_rules(two_step_decay_graph):
+    settings = create_default_interaction_settings('helicity')
+    # isospin forbids the strong decay of the J/psi to three pi0
+    graph = two_step_decay_graph(['pi0', 'pi0', 'pi0'])
+
+    def find_violated_rules(backend):
+        propagator = FullPropagator(deepcopy(graph), backend=backend)
+        for node_id in graph.nodes:
+            propagator.assign_settings_to_node(
+                node_id, settings[InteractionTypes.Strong])
+        assert propagator.find_solutions() == []
+        return {k: sorted(str(x) for x in v) for k, v in
+                propagator.get_non_satisfied_conservation_laws().items()
+                if v}
+
+    violated_rules = find_violated_rules('native')
+    assert violated_rules
+    assert find_violated_rules('native') == violated_rules
+    assert find_violated_rules('python')
+
+
+def test_fallback_to_python_solver(two_step_decay_graph, graph_key):
+    class ChargeConservation(AdditiveQuantumNumberConservation):
+        pass
+
+    settings = create_default_interaction_settings('helicity')
+    strong_settings = deepcopy(settings[InteractionTypes.Strong])
+    strong_settings.conservation_laws.append(
+        ChargeConservation(StateQuantumNumberNames.Charge))
+    node_settings = {0: strong_settings, 1: strong_settings}
+    graph = two_step_decay_graph(['pi0', 'pi+', 'pi-'])
+
+    solutions = find_validated_solutions(CSPPropagator, graph, node_settings,
+                                         graph_key)
+    native_solutions = find_validated_solutions(NativeCSPPropagator, graph,
+                                                node_settings, graph_key)
+    assert solutions
+    assert native_solutions == solutions
+
+
+def test_bulk_propagation(two_step_decay_graph, graph_key):
+    settings = create_default_interaction_settings('helicity')
+
+    def create_propagators():
+        propagators = []
+        for final_state in [['gamma', 'pi0', 'pi0'], ['pi0', 'pi+', 'pi-']]:
+            for backend in ['native', 'python']:
+                propagator = FullPropagator(two_step_decay_graph(final_state),
+                                            backend=backend)
+                propagator.assign_settings_to_node(
+                    0, settings[InteractionTypes.EM])
+                propagator.assign_settings_to_node(
+                    1, settings[InteractionTypes.Strong])
+                propagators.append(propagator)
+        return propagators
+
+    propagators = create_propagators()
+    results = find_solutions_in_bulk(propagators, number_of_threads=2)
+    assert len(results) == len(propagators)
+    for propagator, solutions, serial_propagator in zip(
+            propagators, results, create_propagators()):
+        serial_solutions = serial_propagator.find_solutions()
+        assert ({graph_key(x) for x in solutions} ==
+                {graph_key(x) for x in serial_solutions})
+        assert ({k: [str(x) for x in v] for k, v in
+                 propagator.get_non_satisfied_conservation_laws().items()} ==
+                {k: [str(x) for x in v] for k, v in serial_propagator
+                 .get_non_satisfied_conservation_laws().items()})
+
+
+def test_unknown_backend():
+    with pytest.raises(ValueError):
+        FullPropagator(StateTransitionGraph(), backend='fortran')
@@ -1,4 +1,7 @@
-from pycompwa.expertsystem.topology.graph import InteractionNode
+import pytest
+
+from pycompwa.expertsystem.topology.graph import (
+    InteractionNode, get_initial_state_edges, get_final_state_edges)
 from pycompwa.expertsystem.topology.topologybuilder import (
     SimpleStateTransitionTopologyBuilder)
 
@@ -13,3 +16,30 @@ class TestSimpleStateBuilder(object):
         all_graphs = SimpleBuilder.build_graphs(1, 3)
 
         assert len(all_graphs) is 1
+
+    @pytest.mark.parametrize(
+        "number_of_final_edges,result",
+        [(2, 1), (3, 1), (4, 2), (5, 3), (6, 6), (7, 11)])
+    def test_isobar_topologies_are_unique(self, number_of_final_edges,
+                                          result):
+        SimpleBuilder = SimpleStateTransitionTopologyBuilder(
+            [InteractionNode("TwoBodyDecay", 1, 2)])
+
+        all_graphs = SimpleBuilder.build_graphs(1, number_of_final_edges)
+
+        assert len(all_graphs) == result
+        for graph in all_graphs:
+            assert len(get_initial_state_edges(graph)) == 1
+            assert len(get_final_state_edges(graph)) == number_of_final_edges
+            assert len(graph.nodes) == number_of_final_edges - 1
+
+    def test_n_body_topology(self):
+        SimpleBuilder = SimpleStateTransitionTopologyBuilder(
+            [InteractionNode("NBodyScattering", 2, 3)])
+
+        all_graphs = SimpleBuilder.build_graphs(2, 3)
+
+        assert len(all_graphs) == 1
+        assert all_graphs[0].nodes == [0]
+        assert len(get_initial_state_edges(all_graphs[0])) == 2
+        assert len(get_final_state_edges(all_graphs[0])) == 3
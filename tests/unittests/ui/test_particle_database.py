@@ -0,0 +1,118 @@
+import json
+import os
+import struct
+
+import pytest
+import xmltodict
+
+from pycompwa.expertsystem.state.particle import (
+    particle_list, load_particle_list_from_xml)
+
+
+particle_list_xml = """<?xml version="1.0" encoding="utf-8"?>
+<ParticleList>
+  <!-- comments are ignored -->
+  <Particle Name="pi0">
+    <Pid>111</Pid>
+    <Parameter Type="Mass" Name="Mass_neutralPion">
+      <Value>0.1349766</Value>
+      <Fix>true</Fix>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="0"/>
+    <QuantumNumber Class="Int" Type="Charge" Value="0"/>
+    <QuantumNumber Class="Spin" Type="IsoSpin" Value="1" Projection="0"/>
+  </Particle>
+  <Particle Name="f0(980)">
+    <Pid> 9010221 </Pid>
+    <Parameter Type="Mass" Name="Mass_f0(980)">
+      <Value>{mass}</Value>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="0"></QuantumNumber>
+    <DecayInfo Type="relativisticBreitWigner">
+      <FormFactor Type="0" />
+      <Parameter Type="Width" Name="Width_f0(980)">
+        <Value>0.05</Value>
+      </Parameter>
+      <Parameter Type="MesonRadius" Name="Radius_f0(980)">
+        <Value>1.5</Value>
+        <Fix>true</Fix>
+      </Parameter>
+    </DecayInfo>
+  </Particle>
+</ParticleList>
+"""
+
+
+@pytest.fixture
+def xml_file(tmp_path, monkeypatch):
+    monkeypatch.setenv('XDG_CACHE_HOME', str(tmp_path / 'cache'))
+    file_path = str(tmp_path / 'particle_list.xml')
+    with open(file_path, 'w') as xml:
+        xml.write(particle_list_xml.format(mass=0.99))
+    return file_path
+
+
+def as_plain_dicts(particles):
+    return json.loads(json.dumps(particles))
+
+
+def test_load_particle_list(xml_file):
+    with open(xml_file, 'rb') as xml:
+        expected = xmltodict.parse(xml)['ParticleList']['Particle']
+    size = len(particle_list)
+    try:
+        # the second load uses the compiled database, if available
+        for _ in range(2):
+            load_particle_list_from_xml(xml_file)
+            assert (as_plain_dicts(particle_list[size:]) ==
+                    as_plain_dicts(expected))
+            del particle_list[size:]
+    finally:
+        del particle_list[size:]
+
+
+def test_particle_database(xml_file, tmp_path):
+    ui = pytest.importorskip('pycompwa.ui')
+    database = ui.ParticleDatabase.open(xml_file)
+    assert len(database) == 2
+    # the cache file is opt-in
+    assert database.file_name == ''
+    assert not os.path.exists(str(tmp_path / 'cache'))
+    database = ui.ParticleDatabase.open(xml_file, use_cache_file=True)
+    assert os.path.exists(database.file_name)
+    assert database.find_by_name('f0(980)')['Pid'] == '9010221'
+    assert database.find_by_pid(111)['@Name'] == 'pi0'
+    assert database.find_by_pid(9010221)['@Name'] == 'f0(980)'
+    assert database.find_by_name('f0') is None
+    assert database.find_by_pid(211) is None
+
+    # a changed xml file is compiled again
+    with open(xml_file, 'w') as xml:
+        xml.write(particle_list_xml.format(mass=0.9))
+    os.utime(xml_file, (0, 0))
+    database = ui.ParticleDatabase.open(xml_file)
+    assert database.find_by_name(
+        'f0(980)')['Parameter']['Value'] == '0.9'
+
+
+def test_cyclic_database_file(xml_file):
+    ui = pytest.importorskip('pycompwa.ui')
+    file_name = ui.ParticleDatabase.open(xml_file, True).file_name
+    # let the first attribute of the first particle be its own next sibling,
+    # the header fields are described in ParticleDatabase.cpp
+    with open(file_name, 'r+b') as database_file:
+        header = database_file.read(56)
+        number_of_particles = struct.unpack_from('=I', header, 32)[0]
+        database_file.seek(56 + 16 * number_of_particles + 20 + 12)
+        database_file.write(struct.pack('=I', 1))
+        # a new time stamp of the xml file, so that the file is mapped again
+        modification_time = os.stat(xml_file).st_mtime_ns + 1000
+        database_file.seek(16)
+        database_file.write(struct.pack('=q', modification_time))
+    os.utime(xml_file, ns=(modification_time, modification_time))
+    # the invalid database is compiled again
+    database = ui.ParticleDatabase.open(xml_file, True)
+    assert database.find_by_name('pi0')['@Name'] == 'pi0'
+    with open(file_name, 'rb') as database_file:
+        database_file.seek(56 + 16 * number_of_particles + 20 + 12)
+        assert struct.unpack('=I', database_file.read(4))[0] != 1
@@ -0,0 +1,95 @@
+from collections import OrderedDict
+
+import pytest
+
+from pycompwa.expertsystem.ui.system_control import (
+    StateTransitionManager, InteractionTypes)
+from pycompwa.expertsystem.ui.default_settings import (
+    create_default_interaction_settings)
+from pycompwa.expertsystem.ui.solution_cache import (
+    SolutionCache, create_hash, create_implementation_hash)
+from pycompwa.expertsystem.state.particle import (
+    InteractionQuantumNumberNames, StateQuantumNumberNames,
+    CompareGraphElementPropertiesFunctor, create_spin_domain)
+from pycompwa.expertsystem.topology.graph import StateTransitionGraph
+
+
+def test_hash_ignores_order():
+    assert (create_hash({'a': [1, 2], 'b': {3, 4}}) ==
+            create_hash(OrderedDict([('b', {4, 3}), ('a', [1, 2])])))
+    assert create_hash({'a': [1, 2]}) != create_hash({'a': [2, 1]})
+    assert create_hash([1]) != create_hash([1.0])
+    assert create_hash(test_solution_cache) != create_hash(
+        test_hash_ignores_order)
+
+
+def test_hash_without_memory_addresses():
+    class Opaque():
+        __slots__ = []
+
+    with pytest.raises(TypeError):
+        create_hash([Opaque()])
+    assert create_implementation_hash() == create_implementation_hash()
+
+
+def test_hash_of_interaction_settings():
+    settings = create_default_interaction_settings('helicity')
+    other_settings = create_default_interaction_settings('helicity')
+    assert create_hash(settings) == create_hash(other_settings)
+    other_settings[InteractionTypes.Strong].qn_domains[
+        InteractionQuantumNumberNames.L] = create_spin_domain([0, 1])
+    assert create_hash(settings) != create_hash(other_settings)
+    del other_settings[InteractionTypes.Strong]
+    assert create_hash(settings) != create_hash(other_settings)
+
+
+def create_solution_graph():
+    graph = StateTransitionGraph()
+    graph.add_node(0)
+    graph.add_edges([0, 1, 2])
+    graph.attach_edges_to_node_ingoing([0], 0)
+    graph.attach_edges_to_node_outgoing([1, 2], 0)
+    for edge_id, name in enumerate(['J/psi', 'gamma', 'eta']):
+        graph.edge_props[edge_id] = {
+            '@Name': name, 'Parameter': {'@Type': 'Mass', 'Value': 0.1}}
+    graph.node_props[0] = {'QuantumNumber': [
+        {'@Type': 'L', '@Class': 'Spin', '@Value': '1.0'}]}
+    graph.set_graph_element_properties_comparator(
+        CompareGraphElementPropertiesFunctor(
+            [StateQuantumNumberNames.Spin]))
+    return graph
+
+
+def test_solution_cache(tmp_path):
+    cache = SolutionCache(str(tmp_path / 'cache'))
+    assert cache.load('key') is None
+    graph = create_solution_graph()
+    cache.store('key', ([graph], ['MassConservation']))
+    (solutions, violated_rules) = cache.load('key')
+    assert violated_rules == ['MassConservation']
+    assert len(solutions) == 1
+    assert solutions[0] == graph
+    assert solutions[0].edges == graph.edges
+    assert solutions[0].edge_props == graph.edge_props
+    assert (solutions[0].graph_element_properties_comparator.ignored_qn_list
+            == ['Spin'])
+    assert cache.load('other key') is None
+    # corrupt files are ignored
+    with open(cache.get_file_path('key'), 'wb') as cache_file:
+        cache_file.write(b'corrupt')
+    assert cache.load('key') is None
+
+
+def test_cached_solutions_are_used(tmp_path):
+    tbd_manager = StateTransitionManager(
+        [("J/psi", [1])], [("gamma", [1]), ("pi0", [0]), ("pi0", [0])],
+        solution_cache_directory=str(tmp_path))
+    key = tbd_manager.create_solution_cache_key({})
+    assert tbd_manager.find_solutions({}) == ([], [])
+    assert tbd_manager.solution_cache.load(key) == ([], [])
+
+    tbd_manager.solution_cache.store(key, ([create_solution_graph()], []))
+    assert tbd_manager.find_solutions({}) == ([create_solution_graph()], [])
+
+    tbd_manager.allowed_intermediate_particles = ['f0']
+    assert tbd_manager.create_solution_cache_key({}) != key
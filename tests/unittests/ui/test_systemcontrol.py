@@ -10,7 +10,7 @@ from pycompwa.expertsystem.topology.graph import (
     StateTransitionGraph, get_final_state_edges, get_initial_state_edges)
 from pycompwa.expertsystem.state.particle import (
     create_spin_domain, InteractionQuantumNumberNames,
-    get_xml_label, XMLLabelConstants
+    get_xml_label, XMLLabelConstants, GraphFingerprintFunctor
 )
 
 
@@ -118,6 +118,30 @@ class TestSolutionFilter(object):
         num_solutions = [len(x[0]) for x in results['test']]
         assert sum(num_solutions) == result
 
+    @pytest.mark.parametrize(
+        "ignored_qns,LS_pairs,result",
+        [([], [(1, 0), (1, 1), (2, 1)], 3),
+         ([InteractionQuantumNumberNames.S], [(1, 0), (1, 1), (2, 1)], 2),
+         ([InteractionQuantumNumberNames.L,
+           InteractionQuantumNumberNames.S], [(1, 0), (2, 1)], 1),
+         ])
+    def test_graph_fingerprints(self, ignored_qns, LS_pairs, result):
+        create_fingerprint = GraphFingerprintFunctor(ignored_qns)
+        fingerprints = set()
+        for x in LS_pairs:
+            fingerprint = create_fingerprint(make_ls_test_graph(x[0], x[1]))
+            assert fingerprint == create_fingerprint(
+                make_ls_test_graph_scrambled(x[0], x[1]))
+            fingerprints.add(fingerprint)
+        assert len(fingerprints) == result
+
+        python_fingerprints = {
+            create_fingerprint.create_python_fingerprint(
+                [0], [], create_fingerprint.encode_properties(
+                    make_ls_test_graph(x[0], x[1]).node_props), [])
+            for x in LS_pairs}
+        assert len(python_fingerprints) == result
+
     @pytest.mark.parametrize(
         "input_values,filter_parameters,result",
         [